@@ -0,0 +1,273 @@
+#include "QWsPerMessageDeflate.h"
+
+#include <cstring>
+
+#include <QElapsedTimer>
+#include <QStringList>
+
+// minimum size of a message before we bother compressing it
+int QWsPerMessageDeflate::minMessageBytes = 64;
+
+// protection against decompression bombs
+int QWsPerMessageDeflate::maxMessageBytes = 16 * 1024 * 1024;
+
+// every compressed message is terminated by an empty stored block, which is
+// stripped before sending and appended again before inflating (RFC 7692, 7.2.1)
+static const char emptyBlockTail[4] = { '\x00', '\x00', '\xff', '\xff' };
+
+QWsPerMessageDeflate::QWsPerMessageDeflate( int deflateWindowBits, bool deflateNoContextTakeover, int inflateWindowBits, bool inflateNoContextTakeover ) :
+	deflateReady( false ),
+	inflateReady( false ),
+	_deflateNoContextTakeover( deflateNoContextTakeover ),
+	_inflateNoContextTakeover( inflateNoContextTakeover ),
+	_uncompressedBytesOut( 0 ),
+	_compressedBytesOut( 0 ),
+	_compressedBytesIn( 0 ),
+	_uncompressedBytesIn( 0 ),
+	_deflateNsecs( 0 ),
+	_inflateNsecs( 0 )
+{
+	// zlib does not support a 256 byte window for raw deflate streams
+	deflateWindowBits = qBound( 9, deflateWindowBits, 15 );
+	inflateWindowBits = qBound( 9, inflateWindowBits, 15 );
+
+	deflateStream.zalloc = Z_NULL;
+	deflateStream.zfree = Z_NULL;
+	deflateStream.opaque = Z_NULL;
+	// negative window bits select a raw deflate stream without zlib header
+	deflateReady = ( deflateInit2( &deflateStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -deflateWindowBits, 8, Z_DEFAULT_STRATEGY ) == Z_OK );
+
+	inflateStream.zalloc = Z_NULL;
+	inflateStream.zfree = Z_NULL;
+	inflateStream.opaque = Z_NULL;
+	inflateStream.next_in = Z_NULL;
+	inflateStream.avail_in = 0;
+	inflateReady = ( inflateInit2( &inflateStream, -inflateWindowBits ) == Z_OK );
+}
+
+QWsPerMessageDeflate::~QWsPerMessageDeflate()
+{
+	if ( deflateReady )
+		deflateEnd( &deflateStream );
+	if ( inflateReady )
+		inflateEnd( &inflateStream );
+}
+
+bool QWsPerMessageDeflate::isValid()
+{
+	return deflateReady && inflateReady;
+}
+
+bool QWsPerMessageDeflate::compress( const QByteArray & message, QByteArray & payload )
+{
+	if ( ! deflateReady || message.size() < minMessageBytes )
+		return false;
+
+	QElapsedTimer timer;
+	timer.start();
+
+	payload.resize( message.size() / 2 + 64 );
+
+	deflateStream.next_in = reinterpret_cast<Bytef *>( const_cast<char *>( message.constData() ) );
+	deflateStream.avail_in = message.size();
+
+	int length = 0;
+	do
+	{
+		if ( length == payload.size() )
+			payload.resize( 2 * payload.size() );
+
+		deflateStream.next_out = reinterpret_cast<Bytef *>( payload.data() + length );
+		deflateStream.avail_out = payload.size() - length;
+
+		int result = ::deflate( &deflateStream, Z_SYNC_FLUSH );
+		if ( result != Z_OK && result != Z_BUF_ERROR )
+		{
+			payload.clear();
+			return false;
+		}
+
+		length = payload.size() - deflateStream.avail_out;
+	}
+	while ( deflateStream.avail_out == 0 );
+
+	if ( length >= 4 && memcmp( payload.constData() + length - 4, emptyBlockTail, 4 ) == 0 )
+		length -= 4;
+	payload.resize( length );
+
+	if ( _deflateNoContextTakeover )
+		deflateReset( &deflateStream );
+
+	_uncompressedBytesOut += message.size();
+	_compressedBytesOut += payload.size();
+	_deflateNsecs += timer.nsecsElapsed();
+
+	return true;
+}
+
+bool QWsPerMessageDeflate::decompress( const QByteArray & payload, QByteArray & message )
+{
+	if ( ! inflateReady )
+		return false;
+
+	QElapsedTimer timer;
+	timer.start();
+
+	QByteArray input( payload );
+	input.append( emptyBlockTail, 4 );
+
+	message.resize( qMax( 4 * payload.size(), 256 ) );
+
+	inflateStream.next_in = reinterpret_cast<Bytef *>( input.data() );
+	inflateStream.avail_in = input.size();
+
+	int length = 0;
+	while ( true )
+	{
+		if ( length == message.size() )
+		{
+			if ( message.size() >= maxMessageBytes )
+			{
+				message.clear();
+				return false;
+			}
+			message.resize( qMin( 2 * message.size(), maxMessageBytes ) );
+		}
+
+		inflateStream.next_out = reinterpret_cast<Bytef *>( message.data() + length );
+		inflateStream.avail_out = message.size() - length;
+
+		int result = ::inflate( &inflateStream, Z_SYNC_FLUSH );
+		if ( result != Z_OK && result != Z_BUF_ERROR && result != Z_STREAM_END )
+		{
+			message.clear();
+			return false;
+		}
+
+		length = message.size() - inflateStream.avail_out;
+
+		if ( result == Z_STREAM_END )
+		{
+			// the peer finished its stream with a final block, start over with the next message
+			inflateReset( &inflateStream );
+			break;
+		}
+		if ( inflateStream.avail_out != 0 )
+			break;
+	}
+	message.resize( length );
+
+	if ( _inflateNoContextTakeover )
+		inflateReset( &inflateStream );
+
+	_compressedBytesIn += payload.size();
+	_uncompressedBytesIn += message.size();
+	_inflateNsecs += timer.nsecsElapsed();
+
+	return true;
+}
+
+quint64 QWsPerMessageDeflate::uncompressedBytesOut()
+{
+	return _uncompressedBytesOut;
+}
+
+quint64 QWsPerMessageDeflate::compressedBytesOut()
+{
+	return _compressedBytesOut;
+}
+
+quint64 QWsPerMessageDeflate::compressedBytesIn()
+{
+	return _compressedBytesIn;
+}
+
+quint64 QWsPerMessageDeflate::uncompressedBytesIn()
+{
+	return _uncompressedBytesIn;
+}
+
+qint64 QWsPerMessageDeflate::deflateNsecs()
+{
+	return _deflateNsecs;
+}
+
+qint64 QWsPerMessageDeflate::inflateNsecs()
+{
+	return _inflateNsecs;
+}
+
+QWsPerMessageDeflate * QWsPerMessageDeflate::negotiate( const QString & offers, int windowBits, bool contextTakeover, QString & response )
+{
+	windowBits = qBound( 9, windowBits, 15 );
+
+	// the client may send several offers in order of preference, accept the first one we can satisfy
+	foreach ( const QString & offer, offers.split( ',' ) )
+	{
+		QStringList params = offer.split( ';' );
+		if ( params.takeFirst().trimmed() != "permessage-deflate" )
+			continue;
+
+		int serverWindowBits = windowBits;
+		bool serverNoContextTakeover = ! contextTakeover;
+		bool clientNoContextTakeover = false;
+		bool acceptable = true;
+
+		foreach ( const QString & param, params )
+		{
+			QString name = param.section( '=', 0, 0 ).trimmed();
+			QString value = param.section( '=', 1 ).trimmed().remove( '"' );
+
+			if ( name == "server_no_context_takeover" )
+			{
+				serverNoContextTakeover = true;
+			}
+			else if ( name == "client_no_context_takeover" )
+			{
+				clientNoContextTakeover = true;
+			}
+			else if ( name == "server_max_window_bits" )
+			{
+				bool ok;
+				int bits = value.toInt( &ok );
+				if ( ! ok || bits < 9 || bits > 15 )
+				{
+					acceptable = false;
+					break;
+				}
+				serverWindowBits = qMin( serverWindowBits, bits );
+			}
+			else if ( name == "client_max_window_bits" )
+			{
+				// we inflate with a full window, so any client window size is fine
+			}
+			else
+			{
+				acceptable = false;
+				break;
+			}
+		}
+
+		if ( ! acceptable )
+			continue;
+
+		QWsPerMessageDeflate * perMessageDeflate = new QWsPerMessageDeflate( serverWindowBits, serverNoContextTakeover, 15, clientNoContextTakeover );
+		if ( ! perMessageDeflate->isValid() )
+		{
+			delete perMessageDeflate;
+			return 0;
+		}
+
+		response = "permessage-deflate";
+		if ( serverNoContextTakeover )
+			response.append( "; server_no_context_takeover" );
+		if ( clientNoContextTakeover )
+			response.append( "; client_no_context_takeover" );
+		if ( serverWindowBits < 15 )
+			response.append( "; server_max_window_bits=" + QString::number( serverWindowBits ) );
+
+		return perMessageDeflate;
+	}
+
+	return 0;
+}
@@ -0,0 +1,57 @@
+#ifndef QWSPERMESSAGEDEFLATE_H
+#define QWSPERMESSAGEDEFLATE_H
+
+#include <QByteArray>
+#include <QString>
+
+#include <zlib.h>
+
+// Implementation of the permessage-deflate extension (RFC 7692)
+class QWsPerMessageDeflate
+{
+public:
+	// ctor
+	QWsPerMessageDeflate( int deflateWindowBits = 15, bool deflateNoContextTakeover = false, int inflateWindowBits = 15, bool inflateNoContextTakeover = false );
+	// dtor
+	~QWsPerMessageDeflate();
+
+	// public functions
+	bool isValid();
+
+	bool compress( const QByteArray & message, QByteArray & payload );
+	bool decompress( const QByteArray & payload, QByteArray & message );
+
+	quint64 uncompressedBytesOut();
+	quint64 compressedBytesOut();
+	quint64 compressedBytesIn();
+	quint64 uncompressedBytesIn();
+	qint64 deflateNsecs();
+	qint64 inflateNsecs();
+
+	// public static functions
+	static QWsPerMessageDeflate * negotiate( const QString & offers, int windowBits, bool contextTakeover, QString & response );
+
+	// public static vars
+	static int minMessageBytes;
+	static int maxMessageBytes;
+
+private:
+	Q_DISABLE_COPY( QWsPerMessageDeflate )
+
+	// private vars
+	z_stream deflateStream;
+	z_stream inflateStream;
+	bool deflateReady;
+	bool inflateReady;
+	bool _deflateNoContextTakeover;
+	bool _inflateNoContextTakeover;
+
+	quint64 _uncompressedBytesOut;
+	quint64 _compressedBytesOut;
+	quint64 _compressedBytesIn;
+	quint64 _uncompressedBytesIn;
+	qint64 _deflateNsecs;
+	qint64 _inflateNsecs;
+};
+
+#endif // QWSPERMESSAGEDEFLATE_H
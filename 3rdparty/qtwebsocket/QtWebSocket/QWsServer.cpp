@@ -6,6 +6,8 @@
 #include <QCryptographicHash>
 #include <QDateTime>
 
+#include "QWsPerMessageDeflate.h"
+
 const QString QWsServer::regExpResourceNameStr( "^GET\\s(.*)\\sHTTP/1.1\r\n" );
 const QString QWsServer::regExpHostStr( "\r\nHost:\\s(.+(:\\d+)?)\r\n" );
 const QString QWsServer::regExpKeyStr( "\r\nSec-WebSocket-Key:\\s(.{24})\r\n" );
@@ -19,7 +21,10 @@ const QString QWsServer::regExpProtocolStr( "\r\nSec-WebSocket-Protocol:\\s(.+)\
 const QString QWsServer::regExpExtensionsStr( "\r\nSec-WebSocket-Extensions:\\s(.+)\r\n" );
 
 QWsServer::QWsServer(QObject * parent)
-	: QObject(parent)
+	: QObject(parent),
+	perMessageDeflateEnabled( false ),
+	perMessageDeflateWindowBits( 15 ),
+	perMessageDeflateContextTakeover( true )
 {
 	tcpServer = new QTcpServer(this);
 	connect( tcpServer, SIGNAL(newConnection()), this, SLOT(newTcpConnection()) );
@@ -193,13 +198,23 @@ void QWsServer::dataReceived()
 	
 	////////////////////////////////////////////////////////////////////
 	
+	// Negotiate permessage-deflate (RFC 7692 is only defined on top of RFC 6455)
+	QWsPerMessageDeflate * perMessageDeflate = 0;
+	QString extensionsResponse;
+	if ( version >= WS_V13 && perMessageDeflateEnabled && ! extensions.isEmpty() )
+	{
+		perMessageDeflate = QWsPerMessageDeflate::negotiate( extensions, perMessageDeflateWindowBits, perMessageDeflateContextTakeover, extensionsResponse );
+	}
+
+	////////////////////////////////////////////////////////////////////
+
 	// Compose opening handshake response
 	QString response;
 
 	if ( version >= WS_V6 )
 	{
 		QString accept = computeAcceptV4( key );
-		response = QWsServer::composeOpeningHandshakeResponseV6( accept, protocol );
+		response = QWsServer::composeOpeningHandshakeResponseV6( accept, protocol, extensionsResponse );
 	}
 	else if ( version >= WS_V4 )
 	{
@@ -228,6 +243,7 @@ void QWsServer::dataReceived()
 	wsSocket->setOrigin( origin );
 	wsSocket->setProtocol( protocol );
 	wsSocket->setExtensions( extensions );
+	wsSocket->setPerMessageDeflate( perMessageDeflate );
 	
 	// ORIGINAL CODE
 	//int socketDescriptor = tcpSocket->socketDescriptor();
@@ -316,6 +332,13 @@ bool QWsServer::waitForNewConnection( int msec, bool * timedOut )
 	return tcpServer->waitForNewConnection( msec, timedOut );
 }
 
+void QWsServer::setPerMessageDeflate( bool enabled, int windowBits, bool contextTakeover )
+{
+	perMessageDeflateEnabled = enabled;
+	perMessageDeflateWindowBits = windowBits;
+	perMessageDeflateContextTakeover = contextTakeover;
+}
+
 QString QWsServer::computeAcceptV0( QString key1, QString key2, QString key3 )
 {
 	QString numStr1;
@@ -38,6 +38,7 @@ public:
 	bool setSocketDescriptor( int socketDescriptor );
 	int socketDescriptor();
 	bool waitForNewConnection( int msec = 0, bool * timedOut = 0 );
+	void setPerMessageDeflate( bool enabled, int windowBits = 15, bool contextTakeover = true );
 
 signals:
 	void newConnection();
@@ -58,6 +59,9 @@ private:
 	QTcpServer * tcpServer;
 	QQueue<QWsSocket*> pendingConnections;
 	QMap<const QTcpSocket*, QStringList> headerBuffer;
+	bool perMessageDeflateEnabled;
+	int perMessageDeflateWindowBits;
+	bool perMessageDeflateContextTakeover;
 
 public:
 	// public static functions
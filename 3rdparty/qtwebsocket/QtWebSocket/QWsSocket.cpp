@@ -3,6 +3,7 @@
 #include <QCryptographicHash>
 #include <QtEndian>
 
+#include "QWsPerMessageDeflate.h"
 #include "QWsServer.h"
 
 int QWsSocket::maxBytesPerFrame = 1400;
@@ -12,9 +13,13 @@ QWsSocket::QWsSocket( QObject * parent, QTcpSocket * socket, EWebsocketVersion w
 	tcpSocket( socket ),
 	_version( ws_v ),
 	_hostPort( -1 ),
+	_perMessageDeflate( 0 ),
 	closingHandshakeSent( false ),
 	closingHandshakeReceived( false ),
 	readingState( HeaderPending ),
+	opcode( OpContinue ),
+	messageOpcode( OpContinue ),
+	isCompressedMessage( false ),
 	isFinalFragment( false ),
 	hasMask( false ),
 	payloadLength( 0 ),
@@ -44,6 +49,8 @@ QWsSocket::~QWsSocket()
 		qDebug() << "CloseAway, socket destroyed in server";
 		close( CloseGoingAway, "socket destroyed in server" );
 	}
+
+	delete _perMessageDeflate;
 }
 
 void QWsSocket::processDataV4()
@@ -59,6 +66,13 @@ void QWsSocket::processDataV4()
 		isFinalFragment = (header[0] & 0x80) != 0;
 		opcode = static_cast<EOpcode>(header[0] & 0x0F);
 
+		// RSV1 marks the first frame of a compressed message (RFC 7692)
+		if ( opcode == OpText || opcode == OpBinary )
+		{
+			messageOpcode = opcode;
+			isCompressedMessage = (header[0] & 0x40) != 0;
+		}
+
 		// Mask, PayloadLength
 		hasMask = (header[1] & 0x80) != 0;
 		quint8 length = (header[1] & 0x7F);
@@ -124,7 +138,23 @@ void QWsSocket::processDataV4()
 		if ( !isFinalFragment )
 			break;
 
-		switch ( opcode )
+		// the final fragment of a fragmented message carries the continuation opcode
+		EOpcode frameOpcode = ( opcode == OpContinue ? messageOpcode : opcode );
+
+		if ( isCompressedMessage && ( frameOpcode == OpText || frameOpcode == OpBinary ) )
+		{
+			QByteArray message;
+			if ( ! _perMessageDeflate || ! _perMessageDeflate->decompress( currentFrame, message ) )
+			{
+				currentFrame.clear();
+				close( CloseProtocolError, "invalid compressed message" );
+				return;
+			}
+			currentFrame = message;
+			isCompressedMessage = false;
+		}
+
+		switch ( frameOpcode )
 		{
 			case OpBinary:
 				emit frameReceived( currentFrame );
@@ -222,13 +252,21 @@ void QWsSocket::processDataV0()
 }
 
 qint64 QWsSocket::write ( const QString & string )
+{
+	return writeText( string.toUtf8() );
+}
+
+qint64 QWsSocket::writeText ( const QByteArray & utf8 )
 {
 	if ( _version == WS_V0 )
 	{
-		return QWsSocket::write( string.toLatin1() );
+		return QWsSocket::write( utf8 );
 	}
 
-    const QList<QByteArray> & framesList = QWsSocket::composeFrames( string.toLatin1(), false, maxBytesPerFrame );
+	QByteArray payload = utf8;
+	bool compressed = compressPayload( payload );
+
+    const QList<QByteArray> & framesList = QWsSocket::composeFrames( payload, false, maxBytesPerFrame, compressed );
 	return writeFrames( framesList );
 }
 
@@ -243,7 +281,10 @@ qint64 QWsSocket::write ( const QByteArray & byteArray )
 		return writeFrame( BA );
 	}
 
-    const QList<QByteArray> & framesList = QWsSocket::composeFrames( byteArray, true, maxBytesPerFrame );
+	QByteArray payload = byteArray;
+	bool compressed = compressPayload( payload );
+
+    const QList<QByteArray> & framesList = QWsSocket::composeFrames( payload, true, maxBytesPerFrame, compressed );
 
 	qint64 nbBytesWritten = writeFrames( framesList );
 	emit bytesWritten( nbBytesWritten );
@@ -256,6 +297,19 @@ qint64 QWsSocket::writeFrame ( const QByteArray & byteArray )
 	return tcpSocket->write( byteArray );
 }
 
+bool QWsSocket::compressPayload ( QByteArray & payload )
+{
+	if ( ! _perMessageDeflate )
+		return false;
+
+	QByteArray compressedPayload;
+	if ( ! _perMessageDeflate->compress( payload, compressedPayload ) )
+		return false;
+
+	payload = compressedPayload;
+	return true;
+}
+
 qint64 QWsSocket::writeFrames ( const QList<QByteArray> & framesList )
 {
 	qint64 nbBytesWritten = 0;
@@ -387,7 +441,7 @@ QByteArray QWsSocket::mask( QByteArray & data, QByteArray & maskingKey )
 	return data;
 }
 
-QList<QByteArray> QWsSocket::composeFrames( QByteArray byteArray, bool asBinary, int maxFrameBytes )
+QList<QByteArray> QWsSocket::composeFrames( QByteArray byteArray, bool asBinary, int maxFrameBytes, bool compressed )
 {
 	if ( maxFrameBytes == 0 )
 		maxFrameBytes = maxBytesPerFrame;
@@ -420,7 +474,8 @@ QList<QByteArray> QWsSocket::composeFrames( QByteArray byteArray, bool asBinary,
 		}
 		
 		// Header
-		BA.append( QWsSocket::composeHeader( fin, opcode, size, maskingKey ) );
+		// Only the first frame of a compressed message has RSV1 set
+		BA.append( QWsSocket::composeHeader( fin, opcode, size, maskingKey, compressed && i == 0 ) );
 		
 		// Application Data
 		QByteArray dataForThisFrame = byteArray.left( size );
@@ -435,7 +490,7 @@ QList<QByteArray> QWsSocket::composeFrames( QByteArray byteArray, bool asBinary,
 	return framesList;
 }
 
-QByteArray QWsSocket::composeHeader( bool fin, EOpcode opcode, quint64 payloadLength, const QByteArray & maskingKey )
+QByteArray QWsSocket::composeHeader( bool fin, EOpcode opcode, quint64 payloadLength, const QByteArray & maskingKey, bool compressed )
 {
 	QByteArray BA;
 	quint8 byte;
@@ -445,6 +500,9 @@ QByteArray QWsSocket::composeHeader( bool fin, EOpcode opcode, quint64 payloadLe
 	// FIN
 	if ( fin )
 		byte = (byte | 0x80);
+	// RSV1 (permessage-deflate)
+	if ( compressed )
+		byte = (byte | 0x40);
 	// Opcode
 	byte = (byte | opcode);
 	BA.append( byte );
@@ -536,6 +594,12 @@ void QWsSocket::setExtensions( QString e )
 	_extensions = e;
 }
 
+void QWsSocket::setPerMessageDeflate( QWsPerMessageDeflate * deflate )
+{
+	delete _perMessageDeflate;
+	_perMessageDeflate = deflate;
+}
+
 EWebsocketVersion QWsSocket::version()
 {
 	return _version;
@@ -576,6 +640,11 @@ QString QWsSocket::extensions()
 	return _extensions;
 }
 
+QWsPerMessageDeflate * QWsSocket::perMessageDeflate()
+{
+	return _perMessageDeflate;
+}
+
 QString QWsSocket::composeOpeningHandShake( QString resourceName, QString host, QString origin, QString extensions, QString key )
 {
 	QString hs;
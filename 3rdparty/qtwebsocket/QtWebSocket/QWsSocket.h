@@ -16,6 +16,8 @@ enum EWebsocketVersion
 	WS_V13 = 13
 };
 
+class QWsPerMessageDeflate;
+
 class QWsSocket : public QAbstractSocket
 {
 	Q_OBJECT
@@ -81,7 +83,11 @@ public:
 	void setProtocol( QString p );
 	void setExtensions( QString e );
 
+	QWsPerMessageDeflate * perMessageDeflate();
+	void setPerMessageDeflate( QWsPerMessageDeflate * deflate );
+
 	qint64 write ( const QString & string ); // write data as text
+	qint64 writeText ( const QByteArray & utf8 ); // write UTF-8 encoded data as text
 	qint64 write ( const QByteArray & byteArray ); // write data as binary
 
 public slots:
@@ -96,6 +102,7 @@ signals:
 protected:
 	qint64 writeFrames ( const QList<QByteArray> & framesList );
 	qint64 writeFrame ( const QByteArray & byteArray );
+	bool compressPayload ( QByteArray & payload );
 
 protected slots:
 	void processDataV0();
@@ -125,12 +132,15 @@ private:
 	QString _origin;
 	QString _protocol;
 	QString _extensions;
+	QWsPerMessageDeflate * _perMessageDeflate;
 
 	bool closingHandshakeSent;
 	bool closingHandshakeReceived;
 
 	EReadingState readingState;
 	EOpcode opcode;
+	EOpcode messageOpcode;
+	bool isCompressedMessage;
 	bool isFinalFragment;
 	bool hasMask;
 	quint64 payloadLength;
@@ -141,8 +151,8 @@ public:
 	static QByteArray generateMaskingKey();
 	static QByteArray generateMaskingKeyV4( QString key, QString nonce );
 	static QByteArray mask( QByteArray & data, QByteArray & maskingKey );
-	static QList<QByteArray> composeFrames( QByteArray byteArray, bool asBinary = false, int maxFrameBytes = 0 );
-    static QByteArray composeHeader( bool fin, EOpcode opcode, quint64 payloadLength, const QByteArray & maskingKey = QByteArray() );
+	static QList<QByteArray> composeFrames( QByteArray byteArray, bool asBinary = false, int maxFrameBytes = 0, bool compressed = false );
+    static QByteArray composeHeader( bool fin, EOpcode opcode, quint64 payloadLength, const QByteArray & maskingKey = QByteArray(), bool compressed = false );
 	static QString composeOpeningHandShake( QString resourceName, QString host, QString origin, QString extensions, QString key );
 
 	// static vars
@@ -14,9 +14,13 @@ CONFIG += staticlib
 
 #DEFINES += QTWEBSOCKET_LIBRARY
 
+LIBS += -lz
+
 SOURCES += QWsServer.cpp \
-    QWsSocket.cpp
+    QWsSocket.cpp \
+    QWsPerMessageDeflate.cpp
 
 HEADERS += QWsServer.h \
-    QWsSocket.h
+    QWsSocket.h \
+    QWsPerMessageDeflate.h
 
@@ -12,20 +12,27 @@ SOURCES += \
     src/engine/characterstats.cpp \
     src/engine/commandinterpreter.cpp \
     src/engine/commandregistry.cpp \
+    src/engine/commandtrie.cpp \
     src/engine/conversionutil.cpp \
+    src/engine/datamap.cpp \
     src/engine/diskutil.cpp \
     src/engine/effect.cpp \
+    src/engine/encodedmessage.cpp \
     src/engine/engine.cpp \
     src/engine/gameeventmultipliermap.cpp \
     src/engine/gameexception.cpp \
+    src/engine/gameobjectallocator.cpp \
     src/engine/gameobjectptr.cpp \
     src/engine/gameobjectsyncthread.cpp \
     src/engine/gamethread.cpp \
+    src/engine/internedstring.cpp \
     src/engine/logthread.cpp \
     src/engine/logutil.cpp \
     src/engine/metatyperegistry.cpp \
     src/engine/modifier.cpp \
+    src/engine/nameindex.cpp \
     src/engine/point3d.cpp \
+    src/engine/roomgraph.cpp \
     src/engine/scriptengine.cpp \
     src/engine/scriptfunction.cpp \
     src/engine/scriptfunctionmap.cpp \
@@ -33,6 +40,7 @@ SOURCES += \
     src/engine/triggerregistry.cpp \
     src/engine/util.cpp \
     src/engine/vector3d.cpp \
+    src/engine/visualutil.cpp \
     src/engine/commands/command.cpp \
     src/engine/commands/scriptcommand.cpp \
     src/engine/commands/admin/admincommand.cpp \
@@ -45,6 +53,7 @@ SOURCES += \
     src/engine/commands/admin/listpropscommand.cpp \
     src/engine/commands/admin/reloadscriptscommand.cpp \
     src/engine/commands/admin/removeitemcommand.cpp \
+    src/engine/commands/admin/serverstatscommand.cpp \
     src/engine/commands/admin/setclasscommand.cpp \
     src/engine/commands/admin/setpropcommand.cpp \
     src/engine/commands/admin/setracecommand.cpp \
@@ -73,6 +82,7 @@ SOURCES += \
     src/engine/gameevents/areaevent.cpp \
     src/engine/gameevents/floodevent.cpp \
     src/engine/gameevents/gameevent.cpp \
+    src/engine/gameevents/gameeventaggregator.cpp \
     src/engine/gameevents/movementsoundevent.cpp \
     src/engine/gameevents/movementvisualevent.cpp \
     src/engine/gameevents/soundevent.cpp \
@@ -109,6 +119,7 @@ SOURCES += \
     3rdparty/qjson/json_parser.cpp \
     3rdparty/qjson/json_scanner.cpp \
     3rdparty/qtiocompressor/qtiocompressor.cpp \
+    3rdparty/qtwebsocket/QtWebSocket/QWsPerMessageDeflate.cpp \
     3rdparty/qtwebsocket/QtWebSocket/QWsServer.cpp \
     3rdparty/qtwebsocket/QtWebSocket/QWsSocket.cpp \
 
@@ -117,22 +128,29 @@ HEADERS += \
     src/engine/characterstats.h \
     src/engine/commandinterpreter.h \
     src/engine/commandregistry.h \
+    src/engine/commandtrie.h \
     src/engine/constants.h \
     src/engine/conversionutil.h \
+    src/engine/datamap.h \
     src/engine/diskutil.h \
     src/engine/effect.h \
+    src/engine/encodedmessage.h \
     src/engine/engine.h \
     src/engine/foreach.h \
     src/engine/gameeventmultipliermap.h \
     src/engine/gameexception.h \
+    src/engine/gameobjectallocator.h \
     src/engine/gameobjectptr.h \
     src/engine/gameobjectsyncthread.h \
     src/engine/gamethread.h \
+    src/engine/internedstring.h \
     src/engine/logthread.h \
     src/engine/logutil.h \
     src/engine/metatyperegistry.h \
     src/engine/modifier.h \
+    src/engine/nameindex.h \
     src/engine/point3d.h \
+    src/engine/roomgraph.h \
     src/engine/scriptengine.h \
     src/engine/scriptfunction.h \
     src/engine/scriptfunctionmap.h \
@@ -140,6 +158,7 @@ HEADERS += \
     src/engine/triggerregistry.h \
     src/engine/util.h \
     src/engine/vector3d.h \
+    src/engine/visualutil.h \
     src/engine/commands/command.h \
     src/engine/commands/scriptcommand.h \
     src/engine/commands/admin/admincommand.h \
@@ -152,6 +171,7 @@ HEADERS += \
     src/engine/commands/admin/listpropscommand.h \
     src/engine/commands/admin/reloadscriptscommand.h \
     src/engine/commands/admin/removeitemcommand.h \
+    src/engine/commands/admin/serverstatscommand.h \
     src/engine/commands/admin/setclasscommand.h \
     src/engine/commands/admin/setpropcommand.h \
     src/engine/commands/admin/setracecommand.h \
@@ -180,6 +200,7 @@ HEADERS += \
     src/engine/gameevents/areaevent.h \
     src/engine/gameevents/floodevent.h \
     src/engine/gameevents/gameevent.h \
+    src/engine/gameevents/gameeventaggregator.h \
     src/engine/gameevents/movementsoundevent.h \
     src/engine/gameevents/movementvisualevent.h \
     src/engine/gameevents/soundevent.h \
@@ -216,6 +237,7 @@ HEADERS += \
     3rdparty/qjson/json_driver.hh \
     3rdparty/qjson/json_scanner.h \
     3rdparty/qtiocompressor/qtiocompressor.h \
+    3rdparty/qtwebsocket/QtWebSocket/QWsPerMessageDeflate.h \
     3rdparty/qtwebsocket/QtWebSocket/QWsServer.h \
     3rdparty/qtwebsocket/QtWebSocket/QWsSocket.h \
 
@@ -18,7 +18,7 @@ GetCommand.prototype.execute = function(player, command) {
 
     var items;
     if (this.takeWord("from") === "from") {
-        var container = this.takeObject(player.inventory);
+        var container = this.takeObject(this.itemsInInventory());
         if (!this.requireSome(container, "%1 from what?".arg(this.alias.capitalized()))) {
             return;
         }
@@ -41,7 +41,7 @@ GetCommand.prototype.execute = function(player, command) {
         this.send("You take %1 from %2.", items.joinFancy(Options.DefiniteArticles),
                   container.definiteName(player.inventory));
     } else {
-        items = this.objectsByDescription(description, this.currentRoom.items);
+        items = this.objectsByDescription(description, this.itemsInRoom());
         if (!this.requireSome(items, "%1 what?".arg(this.alias.capitalized()))) {
             return;
         }
@@ -43,7 +43,7 @@ GiveCommand.prototype.execute = function(player, command) {
 
         this.takeWord();
     } else {
-        items = this.takeObjects(player.inventory);
+        items = this.takeObjects(this.itemsInInventory());
         if (!this.requireSome(items, "You don't have that.")) {
             return;
         }
@@ -51,7 +51,7 @@ GiveCommand.prototype.execute = function(player, command) {
 
     this.takeWord("to", Options.IfNotLast);
 
-    var recipient = this.takeObject(this.currentRoom.characters);
+    var recipient = this.takeObject(this.charactersInRoom());
     if (!this.requireSome(recipient, "That recipient is not here.")) {
         return;
     }
@@ -13,7 +13,7 @@ KillCommand.prototype.execute = function(player, command) {
 
     this.prepareExecute(player, command);
 
-    var character = this.takeObject(this.currentRoom.characters);
+    var character = this.takeObject(this.charactersInRoom());
     if (!this.requireSome(character, "Kill who?")) {
         return;
     }
@@ -39,7 +39,7 @@ LookCommand.prototype.execute = function(player, command) {
     var description = this.takeObjectsDescription();
 
     if (this.peekRest() === "in inventory") {
-        object = this.objectByDescription(description, player.inventory);
+        object = this.objectByDescription(description, this.itemsInInventory());
         if (object) {
             player.send(object.lookAtBy(player));
         } else {
@@ -50,8 +50,11 @@ LookCommand.prototype.execute = function(player, command) {
 
     var room = this.currentRoom;
 
-    var pool = room.characters.concat(room.items).concat(room.portals).concat(player.inventory);
-    object = this.objectByDescription(description, pool);
+    object = this.objectByDescription(description, function(name) {
+        var portals = this.objectsByDescription({ name: name, position: 0 }, room.portals);
+        return room.charactersByName(name).concat(room.itemsByName(name)).concat(portals)
+                   .concat(player.inventoryByName(name));
+    });
 
     if (!object) {
         if (Util.isDirectionAbbreviation(description.name)) {
@@ -1,8 +1,5 @@
 
 function Character() {
-
-    this.currentAction = "";
-    this.currentActionTimerId = 0;
 }
 
 Character.prototype.changeStats = function(newStats) {
@@ -95,157 +92,6 @@ Character.prototype.die = function(attacker) {
     }
 };
 
-Character.prototype.go = function(pointer) {
-
-    if (!pointer) {
-        return;
-    }
-
-    if (this.secondsStunned() > 0) {
-        this.send("Please wait %1 seconds.".arg(this.secondsStunned()), Color.Olive);
-        return;
-    }
-
-    var i, length, exitName = "", destination = null, portal = null;
-
-    if (pointer.isPortal()) {
-        portal = pointer;
-        exitName = portal.nameFromRoom(this.currentRoom);
-        destination = portal.oppositeOf(this.currentRoom);
-    } else if (pointer.isRoom()) {
-        for (i = 0, length = this.currentRoom.portals.length; i < length; i++) {
-            var potentialPortal = this.currentRoom.portals[i];
-            if (potentialPortal.oppositeOf(this.currentRoom) === pointer) {
-                portal = potentialPortal;
-                exitName = portal.nameFromRoom(this.currentRoom);
-                break;
-            }
-        }
-        destination = pointer;
-    } else {
-        return;
-    }
-
-    var character, numCharacters = this.currentRoom.characters.length;
-    for (i = 0; i < numCharacters; i++) {
-        character = this.currentRoom.characters[i];
-        if (character !== this) {
-            if (!character.invokeTrigger("oncharacterexit", this, exitName)) {
-                return;
-            }
-        }
-    }
-
-    if (portal) {
-        if (portal.canOpen() && !portal.open) {
-            this.send("The %1 is closed.".arg(exitName));
-            return;
-        }
-        if (!portal.invokeTrigger("onenter", this)) {
-            return;
-        }
-        if (!portal.canPassThrough()) {
-            this.send("You cannot go there.");
-            return;
-        }
-    }
-
-    var action;
-    if (this.currentAction === "walk" || this.currentAction === "run") {
-        action = "run";
-    } else {
-        action = "walk";
-    }
-    this.setAction(action, { "duration": 4000 });
-
-    var followers = [];
-    if (this.group && this.group.leader === this) {
-        for (i = 0, length = this.group.members.length; i < length; i++) {
-            var member = this.group.members[i];
-            if (member.currentRoom !== this.currentRoom) {
-                continue;
-            }
-
-            var blocked = false;
-            for (var j = 0; j < numCharacters; j++) {
-                character = this.currentRoom.characters[j];
-                if (!character.invokeTrigger("oncharacterexit", this, exitName)) {
-                    blocked = true;
-                    break;
-                }
-            }
-            if (blocked) {
-                continue;
-            }
-
-            if (portal && !portal.invokeTrigger("onenter", member)) {
-                continue;
-            }
-
-            followers.append(member);
-        }
-    }
-
-    var source = this.currentRoom;
-    var movement = destination.position.minus(source.position);
-    var direction = movement.normalized();
-
-    this.leave(source);
-    this.direction = direction;
-    this.enter(destination);
-
-    for (i = 0, length = followers.length; i < length; i++) {
-        var follower = followers[i];
-        follower.leave(source);
-        follower.direction = direction;
-        follower.enter(destination);
-        follower.send("You follow %1.".arg(this.name));
-        this.setAction(action, { "duration": 4000 });
-    }
-
-    var party = [this].concat(followers);
-
-    var simplePresent = (followers.isEmpty() ? action + "s" : action);
-    var continuous = (followers.isEmpty() ? "is" : "are") + " " +
-                     (action === "walk" ? "walking" : "running");
-
-    var visualEvent = Realm.createEvent("MovementVisual", source, 1.0);
-    visualEvent.subject = (followers.isEmpty() ? this : this.group);
-    visualEvent.destination = destination
-    visualEvent.movement = movement;
-    visualEvent.direction = direction;
-    visualEvent.setVerb(simplePresent, continuous);
-    visualEvent.excludedCharacters = party;
-    visualEvent.fire();
-
-    if (!this.race || this.race.name !== "animal") {
-        var soundStrength = (action === "walk" ? 1.0 : 3.0);
-        var soundDescription = "someone";
-
-        if (!followers.isEmpty()) {
-            soundDescription = "some people";
-            for (i = 0, length = followers.length; i < length; i++) {
-                soundStrength += max(0.8 - 0.2 * i, 0.3);
-            }
-        }
-
-        var soundEvent = Realm.createEvent("MovementSound", source, soundStrength);
-        soundEvent.description = soundDescription;
-        soundEvent.distantDescription = soundDescription;
-        soundEvent.veryDistantDescription = soundDescription;
-        soundEvent.destination = destination;
-        soundEvent.movement = movement;
-        soundEvent.direction = direction;
-        soundEvent.setVerb(simplePresent, continuous);
-        soundEvent.excludedCharacters = party.concat(visualEvent.affectedCharacters);
-        soundEvent.fire();
-    }
-
-    if (this.isPlayer()) {
-        LogUtil.countRoomVisit(destination.toString(), 1 + followers.length);
-    }
-};
-
 Character.prototype.guard = function(target) {
 
     this.setAction("guard", { "target": target });
@@ -483,32 +329,6 @@ Character.prototype.say = function(message) {
     this.setAction("talk", { "duration": 4000 });
 };
 
-Character.prototype.setAction = function(action, options) {
-
-    options = options || {};
-
-    this.currentAction = action;
-
-    this.target = options.target;
-
-    if (this.weapon && this.weapon.name === "binocular") {
-        this.remove(this.weapon);
-    }
-
-    if (this.currentActionTimerId) {
-        this.clearTimeout(this.currentActionTimerId);
-    }
-
-    if (options.duration) {
-        this.currentActionTimerId = this.setTimeout(function() {
-            this.currentAction = "";
-            this.currentActionTimerId = 0;
-        }, options.duration);
-    } else {
-        this.currentActionTimerId = 0;
-    }
-};
-
 Character.prototype.shout = function(message) {
 
     var event = Realm.createEvent("Speech", this.currentRoom, 5.0);
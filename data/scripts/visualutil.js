@@ -173,6 +173,90 @@ var VisualUtil = (function() {
         return characters;
     }
 
+    function describeRoom(room, character) {
+
+        var text = "";
+
+        if (!room.name.isEmpty()) {
+            text += "\n" + room.name.colorized(Color.Teal) + "\n\n";
+        }
+
+        var flags = room.flags.split("|");
+        var hasDynamicPortals = !flags.contains("OmitDynamicPortalsFromDescription");
+        var hasDistantCharacters = !flags.contains("OmitDistantCharactersFromDescription");
+
+        var itemGroups = divideItemsIntoGroups(room.items, character.direction);
+
+        var portalGroups;
+        if (hasDynamicPortals || hasDistantCharacters) {
+            portalGroups = dividePortalsAndCharactersIntoGroups(character, room);
+        }
+
+        var itemTexts = [];
+        for (var key in itemGroups) {
+            if (!itemGroups[key].isEmpty() || hasDynamicPortals && !portalGroups[key].isEmpty()) {
+                var itemGroup = itemGroups[key];
+                var plural = itemGroup.firstItemIsPlural();
+
+                var combinedItems = Util.combinePtrList(itemGroup);
+
+                if (hasDynamicPortals) {
+                    portalGroups[key].forEach(function(portal) {
+                        combinedItems.append(portal.nameWithDestinationFromRoom(room));
+                    });
+                }
+
+                var groupDescription = descriptionForGroup(key);
+                var prefix = groupDescription[0];
+                var helperVerb = groupDescription[plural ? 2 : 1];
+                itemTexts.append("%1 %2 %3.".arg(prefix, helperVerb,
+                                                 Util.joinFancy(combinedItems))
+                                            .replace("there is", "there's"));
+            }
+        }
+
+        var characterText = "";
+        if (hasDistantCharacters && portalGroups.hasOwnProperty("characters")) {
+            var characters = portalGroups["characters"];
+            characterText = describeCharactersRelativeTo(characters, character);
+        }
+
+        text += room.description;
+        if (!itemTexts.isEmpty()) {
+            if (!text.endsWith(" ") && !text.endsWith("\n")) {
+                text += " ";
+            }
+            text += itemTexts.join(" ");
+        }
+        if (!characterText.isEmpty()) {
+            if (!text.endsWith(" ") && !text.endsWith("\n")) {
+                text += " ";
+            }
+            text += characterText;
+        }
+        text += "\n";
+
+        var exitNames = [];
+        room.portals.forEach(function(portal) {
+            if (!portal.isHiddenFromRoom(room)) {
+                exitNames.append(portal.nameFromRoom(room));
+            }
+        });
+        if (!exitNames.isEmpty()) {
+            exitNames = Util.sortExitNames(exitNames);
+            text += ("Obvious exits: " + exitNames.join(", ") + ".").colorized(Color.Green) +
+                    "\n";
+        }
+
+        var others = room.characters;
+        others.removeOne(character);
+        if (!others.isEmpty()) {
+            text += "You see %1.\n".arg(others.joinFancy());
+        }
+
+        return text;
+    }
+
     function describeCharactersRelativeTo(characters, relative) {
 
         if (!characters || characters.length === 0) {
@@ -481,6 +565,7 @@ var VisualUtil = (function() {
         "divideItemsIntoGroups": divideItemsIntoGroups,
         "dividePortalsAndCharactersIntoGroups": dividePortalsAndCharactersIntoGroups,
         "charactersVisibleThroughPortal": charactersVisibleThroughPortal,
+        "describeRoom": describeRoom,
         "describeCharactersRelativeTo": describeCharactersRelativeTo,
         "describeActionRelativeTo": describeActionRelativeTo
     };
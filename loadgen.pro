@@ -0,0 +1,19 @@
+include(environment.pri)
+
+TARGET = loadgen
+
+TEMPLATE = app
+
+QT -= script
+
+SOURCES += \
+    src/loadgen/bot.cpp \
+    src/loadgen/loadgenerator.cpp \
+    src/loadgen/main.cpp \
+
+HEADERS += \
+    src/loadgen/bot.h \
+    src/loadgen/loadgenerator.h \
+
+INCLUDEPATH += \
+    src/loadgen \
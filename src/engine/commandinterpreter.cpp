@@ -1,7 +1,6 @@
 #include "commandinterpreter.h"
 
-#include <QRegExp>
-#include <QStringList>
+#include <QStringRef>
 
 #include "command.h"
 #include "commandregistry.h"
@@ -9,7 +8,6 @@
 #include "gameobjectptr.h"
 #include "logutil.h"
 #include "player.h"
-#include "portal.h"
 #include "room.h"
 #include "util.h"
 
@@ -29,62 +27,43 @@ void CommandInterpreter::setRegistry(CommandRegistry *registry) {
 
 void CommandInterpreter::execute(Character *character, const QString &_command) {
 
-    static QRegExp whitespace("\\s+");
-
     try {
         QString command = _command.trimmed();
         LogUtil::logCommand(character->name(), command);
 
-        QStringList words = command.split(whitespace);
-        QString commandName = words[0].toLower();
+        // only the first word is needed for routing, the command itself splits the rest
+        int firstWordLength = 0;
+        while (firstWordLength < command.length() && !command[firstWordLength].isSpace()) {
+            firstWordLength++;
+        }
+        QStringRef firstWord = command.leftRef(firstWordLength);
+        QStringRef rest = command.midRef(firstWordLength);
+
+        QString commandName = firstWord.toString().toLower();
         if (commandName.isEmpty()) {
             return;
         }
 
         if (Util::isDirectionAbbreviation(commandName)) {
-            words[0] = Util::direction(commandName);
-            commandName = words[0];
+            commandName = Util::direction(commandName);
+            m_registry->command("go")->execute(character, "go " + commandName + rest.toString());
+            return;
         }
-        if (Util::isDirection(commandName)) {
-            words.prepend("go");
-            m_registry->command("go")->execute(character, words.join(" "));
+        if (Util::isDirection(commandName) ||
+            character->currentRoom().cast<Room *>()->hasExitNamed(commandName)) {
+            m_registry->command("go")->execute(character, "go " + command);
             return;
-        } else {
-            Room *currentRoom = character->currentRoom().cast<Room *>();
-            bool matchedPortal = false;
-            for (const GameObjectPtr &portalPtr : currentRoom->portals()) {
-                Portal *portal = portalPtr.cast<Portal *>();
-                QString portalName = portal->nameFromRoom(character->currentRoom());
-                if (portalName == commandName) {
-                    matchedPortal = true;
-                } else {
-                    for (const QString &portalNamePart : portalName.split(' ')) {
-                        if (portalNamePart == commandName) {
-                            matchedPortal = true;
-                        }
-                    }
-                }
-            }
-            if (matchedPortal) {
-                words.prepend("go");
-                m_registry->command("go")->execute(character, words.join(" "));
-                return;
-            }
         }
 
-        QStringList commands;
-
         if (m_registry->contains(commandName)) {
             m_registry->command(commandName)->execute(character, command);
             return;
-        } else {
-            for (const QString &name : m_registry->commandNames()) {
-                if (name.startsWith(commandName)) {
-                    commands.append(name);
-                }
-            }
         }
 
+        QStringRef prefix(&commandName);
+        int numMatches = m_registry->commandTrie().count(prefix);
+        QString match = m_registry->commandTrie().uniqueMatch(prefix);
+
         if (character->isPlayer() && qobject_cast<Player *>(character)->isAdmin()) {
             if (commandName.startsWith("api-")) {
                 if (m_registry->apiCommandsContains(commandName)) {
@@ -96,26 +75,25 @@ void CommandInterpreter::execute(Character *character, const QString &_command)
                     m_registry->adminCommand(commandName)->execute(character, command);
                     return;
                 } else {
-                    for (const QString &name : m_registry->adminCommandNames()) {
-                        if (name.startsWith(commandName)) {
-                            commands.append(name);
-                        }
+                    int numAdminMatches = m_registry->adminCommandTrie().count(prefix);
+                    if (numAdminMatches == 1 && numMatches == 0) {
+                        match = m_registry->adminCommandTrie().uniqueMatch(prefix);
                     }
+                    numMatches += numAdminMatches;
                 }
             }
         }
 
-        if (commands.length() == 1) {
-            commandName = commands[0];
-            if (m_registry->contains(commandName)) {
-                m_registry->command(commandName)->execute(character, command);
-            } else if (m_registry->adminCommandsContains(commandName)) {
-                m_registry->adminCommand(commandName)->execute(character, command);
+        if (numMatches == 1) {
+            if (m_registry->contains(match)) {
+                m_registry->command(match)->execute(character, command);
+            } else if (m_registry->adminCommandsContains(match)) {
+                m_registry->adminCommand(match)->execute(character, command);
             }
-        } else if (commands.length() > 1) {
+        } else if (numMatches > 1) {
             character->send("Command is not unique.");
         } else {
-            character->send(QString("Command \"%1\" does not exist.").arg(words[0]));
+            character->send(QString("Command \"%1\" does not exist.").arg(firstWord.toString()));
         }
     } catch (GameException &exception) {
         if (character->isPlayer()) {
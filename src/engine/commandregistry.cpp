@@ -20,6 +20,7 @@
 #include "commands/admin/listpropscommand.h"
 #include "commands/admin/reloadscriptscommand.h"
 #include "commands/admin/removeitemcommand.h"
+#include "commands/admin/serverstatscommand.h"
 #include "commands/admin/setclasscommand.h"
 #include "commands/admin/setpropcommand.h"
 #include "commands/admin/setracecommand.h"
@@ -52,6 +53,7 @@ CommandRegistry::CommandRegistry(QObject *parent) :
     m_adminCommands.insert("list-props", new ListPropsCommand(this));
     m_adminCommands.insert("reload-scripts", new ReloadScriptsCommand(this));
     m_adminCommands.insert("remove-item", new RemoveItemCommand(this));
+    m_adminCommands.insert("server-stats", new ServerStatsCommand(this));
     m_adminCommands.insert("set-class", new SetClassCommand(this));
     m_adminCommands.insert("set-prop", new SetPropCommand(this));
     m_adminCommands.insert("set-race", new SetRaceCommand(this));
@@ -59,6 +61,10 @@ CommandRegistry::CommandRegistry(QObject *parent) :
     m_adminCommands.insert("stop-server", new StopServerCommand(this));
     m_adminCommands.insert("unset-trigger", new UnsetTriggerCommand(this));
 
+    for (const QString &commandName : m_adminCommands.keys()) {
+        m_adminCommandTrie.insert(commandName);
+    }
+
     m_apiCommands.insert("api-data-get", new DataGetCommand(this));
     m_apiCommands.insert("api-data-set", new DataSetCommand(this));
     m_apiCommands.insert("api-log-retrieve", new LogRetrieveCommand(this));
@@ -83,6 +89,7 @@ void CommandRegistry::registerCommand(const QString &commandName, Command *comma
     }
 
     m_commands[commandName] = command;
+    m_commandTrie.insert(commandName);
 }
 
 void CommandRegistry::registerCommand(const QString &commandName, const QScriptValue &object) {
@@ -98,6 +105,7 @@ void CommandRegistry::registerAdminCommand(const QString &commandName, Command *
     }
 
     m_adminCommands[commandName] = command;
+    m_adminCommandTrie.insert(commandName);
 }
 
 void CommandRegistry::registerAdminCommand(const QString &commandName, const QScriptValue &object) {
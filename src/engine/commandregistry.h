@@ -5,6 +5,8 @@
 #include <QObject>
 #include <QStringList>
 
+#include "commandtrie.h"
+
 
 class Command;
 class QScriptValue;
@@ -28,11 +30,13 @@ class CommandRegistry : public QObject {
         Q_INVOKABLE bool contains(const QString &commandName) const;
         Command *command(const QString &commandName) const;
         Q_INVOKABLE QString description(const QString &commandName) const;
+        const CommandTrie &commandTrie() const { return m_commandTrie; }
 
         Q_INVOKABLE QStringList adminCommandNames() const { return m_adminCommands.keys(); }
         Q_INVOKABLE bool adminCommandsContains(const QString &commandName) const;
         Command *adminCommand(const QString &commandName) const;
         Q_INVOKABLE QString adminCommandDescription(const QString &commandName) const;
+        const CommandTrie &adminCommandTrie() const { return m_adminCommandTrie; }
 
         Q_INVOKABLE QStringList apiCommandNames() const { return m_apiCommands.keys(); }
         Q_INVOKABLE bool apiCommandsContains(const QString &commandName) const;
@@ -43,6 +47,9 @@ class CommandRegistry : public QObject {
         QMap<QString, Command *> m_commands;
         QMap<QString, Command *> m_adminCommands;
         QMap<QString, Command *> m_apiCommands;
+
+        CommandTrie m_commandTrie;
+        CommandTrie m_adminCommandTrie;
 };
 
 #endif // COMMANDREGISTRY_H
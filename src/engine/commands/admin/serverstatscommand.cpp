@@ -0,0 +1,53 @@
+#include "serverstatscommand.h"
+
+#include "realm.h"
+#include "session.h"
+
+
+#define super AdminCommand
+
+ServerStatsCommand::ServerStatsCommand(QObject *parent) :
+    super(parent) {
+
+    setDescription("Shows game thread and input throttling statistics, which can be used to tune "
+                   "the PT_COMMANDS_PER_SECOND, PT_COMMAND_BURST, PT_MAX_PENDING_COMMANDS, "
+                   "PT_INPUT_OVERFLOW and PT_MAX_QUEUE_LATENCY settings.\n"
+                   "\n"
+                   "Usage: server-stats");
+}
+
+ServerStatsCommand::~ServerStatsCommand() {
+}
+
+void ServerStatsCommand::execute(Character *player, const QString &command) {
+
+    super::prepareExecute(player, command);
+
+    const GameThread *gameThread = realm()->gameThread();
+    const Session::InputLimits &limits = Session::inputLimits();
+
+    send(QString("Game thread:\n"
+                 "  Events processed: %1\n"
+                 "  Events queued: %2\n"
+                 "  Queue latency: %3ms (max. %4ms)\n"
+                 "\n"
+                 "Input limits:\n"
+                 "  Commands per second: %5 (burst: %6)\n"
+                 "  Max. pending commands: %7 (on overflow: %8)\n"
+                 "  Max. queue latency for sign-ins: %9ms\n")
+         .arg(gameThread->numProcessedEvents())
+         .arg(gameThread->queueLength())
+         .arg(gameThread->queueLatency())
+         .arg(gameThread->maxQueueLatency())
+         .arg(limits.commandsPerSecond)
+         .arg(limits.commandBurst)
+         .arg(limits.maxPendingCommands)
+         .arg(limits.disconnectOnOverflow ? "disconnect" : "drop")
+         .arg(limits.maxQueueLatency));
+    send(QString("Throttled commands: %1\n"
+                 "Dropped commands: %2\n"
+                 "Deferred sign-ins: %3")
+         .arg(Session::numThrottledCommands())
+         .arg(Session::numDroppedCommands())
+         .arg(Session::numDeferredSignIns()));
+}
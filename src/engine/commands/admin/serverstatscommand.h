@@ -0,0 +1,18 @@
+#ifndef SERVERSTATSCOMMAND_H
+#define SERVERSTATSCOMMAND_H
+
+#include "admincommand.h"
+
+
+class ServerStatsCommand : public AdminCommand {
+
+    Q_OBJECT
+
+    public:
+        ServerStatsCommand(QObject *parent = 0);
+        virtual ~ServerStatsCommand();
+
+        virtual void execute(Character *character, const QString &command);
+};
+
+#endif // SERVERSTATSCOMMAND_H
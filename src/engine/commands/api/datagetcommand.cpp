@@ -29,6 +29,6 @@ void DataGetCommand::execute(Character *player, const QString &command) {
 
     QVariantMap data;
     data["id"] = object->id();
-    data[key] = object->data()[key];
+    data[key] = object->dataValue(key);
     sendReply(data);
 }
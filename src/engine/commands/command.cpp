@@ -194,6 +194,8 @@ GameObjectPtrList Command::objectsByDescription(const ObjectDescription &descrip
     GameObjectPtrList objects;
     if (description.name == "all") {
         objects = pool;
+    } else if (pool.isNameIndexed()) {
+        objects = pool.objectsByName(description.name);
     } else {
         for (const GameObjectPtr &object : pool) {
             QString name;
@@ -191,7 +191,10 @@ Command.prototype.objectByDescription = function(description, pool) {
 Command.prototype.objectsByDescription = function(description, pool) {
 
     var objects = [];
-    if (description.name === "all") {
+    if (pool instanceof Function) {
+        // an empty prefix matches every object
+        objects = pool.call(this, description.name === "all" ? "" : description.name);
+    } else if (description.name === "all") {
         objects = pool;
     } else {
         for (var i = 0, length = pool.length; i < length; i++) {
@@ -227,6 +230,33 @@ Command.prototype.objectsByDescription = function(description, pool) {
     return objects;
 };
 
+// the following return pools that look up objects through the name indices of the current room
+// and the player's inventory, rather than scanning every object in them
+
+Command.prototype.charactersInRoom = function() {
+
+    var room = this.currentRoom;
+    return function(name) {
+        return room.charactersByName(name);
+    };
+};
+
+Command.prototype.itemsInRoom = function() {
+
+    var room = this.currentRoom;
+    return function(name) {
+        return room.itemsByName(name);
+    };
+};
+
+Command.prototype.itemsInInventory = function() {
+
+    var player = this.player;
+    return function(name) {
+        return player.inventoryByName(name);
+    };
+};
+
 Command.prototype.requireSome = function(objects, tooFewText) {
 
     if (objects === null || objects.length === 0) {
@@ -0,0 +1,87 @@
+#include "commandtrie.h"
+
+
+CommandTrie::CommandTrie() {
+
+    clear();
+}
+
+void CommandTrie::insert(const QString &name) {
+
+    int existing = findNode(QStringRef(&name));
+    if (existing > -1 && m_nodes[existing].terminal) {
+        return;
+    }
+
+    int node = 0;
+    m_nodes[node].count++;
+    m_nodes[node].name = name;
+
+    for (QChar character : name) {
+        int child = childNode(node, character);
+        if (child == -1) {
+            child = m_nodes.size();
+
+            Node newNode;
+            newNode.count = 0;
+            newNode.terminal = false;
+            m_nodes.append(newNode);
+
+            Child link;
+            link.character = character;
+            link.node = child;
+            m_nodes[node].children.append(link);
+        }
+
+        node = child;
+        m_nodes[node].count++;
+        m_nodes[node].name = name;
+    }
+
+    m_nodes[node].terminal = true;
+}
+
+void CommandTrie::clear() {
+
+    Node root;
+    root.count = 0;
+    root.terminal = false;
+
+    m_nodes.clear();
+    m_nodes.append(root);
+}
+
+int CommandTrie::count(const QStringRef &prefix) const {
+
+    int node = findNode(prefix);
+    return node > -1 ? m_nodes[node].count : 0;
+}
+
+QString CommandTrie::uniqueMatch(const QStringRef &prefix) const {
+
+    int node = findNode(prefix);
+    if (node > -1 && m_nodes[node].count == 1) {
+        return m_nodes[node].name;
+    }
+    return QString();
+}
+
+int CommandTrie::findNode(const QStringRef &prefix) const {
+
+    int node = 0;
+    for (int i = 0; i < prefix.length() && node > -1; i++) {
+        node = childNode(node, prefix.at(i));
+    }
+    return node;
+}
+
+int CommandTrie::childNode(int node, QChar character) const {
+
+    // nodes have only a handful of children, so a linear scan beats hashing
+    for (const Child &child : m_nodes[node].children) {
+        if (child.character == character) {
+            return child.node;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,45 @@
+#ifndef COMMANDTRIE_H
+#define COMMANDTRIE_H
+
+#include <QString>
+#include <QStringRef>
+#include <QVector>
+
+
+// prefix trie over command names, used to resolve abbreviated commands in time proportional to
+// the length of the abbreviation rather than to the number of commands
+class CommandTrie {
+
+    public:
+        CommandTrie();
+
+        void insert(const QString &name);
+        void clear();
+
+        // returns the number of names starting with the given prefix
+        int count(const QStringRef &prefix) const;
+
+        // returns the name starting with the given prefix if there is exactly one, an empty
+        // string otherwise
+        QString uniqueMatch(const QStringRef &prefix) const;
+
+    private:
+        struct Child {
+            QChar character;
+            int node;
+        };
+
+        struct Node {
+            QVector<Child> children;
+            int count;
+            bool terminal;
+            QString name; // the last name inserted below this node
+        };
+
+        QVector<Node> m_nodes;
+
+        int findNode(const QStringRef &prefix) const;
+        int childNode(int node, QChar character) const;
+};
+
+#endif // COMMANDTRIE_H
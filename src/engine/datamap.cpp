@@ -0,0 +1,262 @@
+#include "datamap.h"
+
+#include <algorithm>
+
+
+DataMap::DataMap() {
+}
+
+DataMap::DataMap(const DataMap &other) :
+    m_entries(other.m_entries) {
+
+    for (Entry &entry : m_entries) {
+        if (entry.type == Variant) {
+            entry.variantValue = new QVariant(*entry.variantValue);
+        }
+    }
+}
+
+DataMap::~DataMap() {
+
+    clear();
+}
+
+DataMap &DataMap::operator=(const DataMap &other) {
+
+    if (&other != this) {
+        clear();
+
+        m_entries = other.m_entries;
+        for (Entry &entry : m_entries) {
+            if (entry.type == Variant) {
+                entry.variantValue = new QVariant(*entry.variantValue);
+            }
+        }
+    }
+    return *this;
+}
+
+bool DataMap::operator==(const DataMap &other) const {
+
+    if (m_entries.size() != other.m_entries.size()) {
+        return false;
+    }
+
+    for (int i = 0; i < m_entries.size(); i++) {
+        const Entry &entry = m_entries[i];
+        const Entry &otherEntry = other.m_entries[i];
+        if (entry.key != otherEntry.key || entry.type != otherEntry.type) {
+            return false;
+        }
+
+        switch (entry.type) {
+            case Bool:
+                if (entry.boolValue != otherEntry.boolValue) {
+                    return false;
+                }
+                break;
+            case Int:
+                if (entry.intValue != otherEntry.intValue) {
+                    return false;
+                }
+                break;
+            case Double:
+                if (entry.doubleValue != otherEntry.doubleValue) {
+                    return false;
+                }
+                break;
+            case Variant:
+                if (*entry.variantValue != *otherEntry.variantValue) {
+                    return false;
+                }
+                break;
+        }
+    }
+    return true;
+}
+
+bool DataMap::operator!=(const DataMap &other) const {
+
+    return !operator==(other);
+}
+
+bool DataMap::contains(const InternedString &key) const {
+
+    return find(key) != nullptr;
+}
+
+QVariant DataMap::value(const InternedString &key) const {
+
+    const Entry *entry = find(key);
+    if (!entry) {
+        return QVariant();
+    }
+
+    switch (entry->type) {
+        case Bool:
+            return entry->boolValue;
+        case Int:
+            return entry->intValue;
+        case Double:
+            return entry->doubleValue;
+        case Variant:
+            return *entry->variantValue;
+    }
+    return QVariant();
+}
+
+bool DataMap::boolValue(const InternedString &key) const {
+
+    const Entry *entry = find(key);
+    if (entry && entry->type == Bool) {
+        return entry->boolValue;
+    }
+    return entry ? value(key).toBool() : false;
+}
+
+int DataMap::intValue(const InternedString &key) const {
+
+    const Entry *entry = find(key);
+    if (entry && entry->type == Int) {
+        return entry->intValue;
+    }
+    return entry ? value(key).toInt() : 0;
+}
+
+double DataMap::doubleValue(const InternedString &key) const {
+
+    const Entry *entry = find(key);
+    if (entry && entry->type == Double) {
+        return entry->doubleValue;
+    }
+    return entry ? value(key).toDouble() : 0.0;
+}
+
+bool DataMap::setBool(const InternedString &key, bool value) {
+
+    bool inserted;
+    Entry *entry = findOrInsert(key, Bool, inserted);
+    if (!inserted && entry->boolValue == value) {
+        return false;
+    }
+
+    entry->boolValue = value;
+    return true;
+}
+
+bool DataMap::setInt(const InternedString &key, int value) {
+
+    bool inserted;
+    Entry *entry = findOrInsert(key, Int, inserted);
+    if (!inserted && entry->intValue == value) {
+        return false;
+    }
+
+    entry->intValue = value;
+    return true;
+}
+
+bool DataMap::setDouble(const InternedString &key, double value) {
+
+    bool inserted;
+    Entry *entry = findOrInsert(key, Double, inserted);
+    if (!inserted && entry->doubleValue == value) {
+        return false;
+    }
+
+    entry->doubleValue = value;
+    return true;
+}
+
+bool DataMap::setValue(const InternedString &key, const QVariant &value) {
+
+    switch (value.type()) {
+        case QVariant::Bool:
+            return setBool(key, value.toBool());
+        case QVariant::Int:
+            return setInt(key, value.toInt());
+        case QVariant::Double:
+            return setDouble(key, value.toDouble());
+        default:
+            break;
+    }
+
+    bool inserted;
+    Entry *entry = findOrInsert(key, Variant, inserted);
+    if (inserted) {
+        entry->variantValue = new QVariant(value);
+        return true;
+    }
+    if (*entry->variantValue == value) {
+        return false;
+    }
+
+    *entry->variantValue = value;
+    return true;
+}
+
+QVariantMap DataMap::toVariantMap() const {
+
+    QVariantMap map;
+    for (const Entry &entry : m_entries) {
+        map.insert(entry.key, value(entry.key));
+    }
+    return map;
+}
+
+DataMap DataMap::fromVariantMap(const QVariantMap &map) {
+
+    DataMap dataMap;
+    dataMap.m_entries.reserve(map.size());
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+        dataMap.setValue(it.key(), it.value());
+    }
+    return dataMap;
+}
+
+const DataMap::Entry *DataMap::find(const InternedString &key) const {
+
+    auto it = std::lower_bound(m_entries.constBegin(), m_entries.constEnd(), key,
+                               [](const Entry &entry, const InternedString &key) {
+        return entry.key < key;
+    });
+    return (it != m_entries.constEnd() && it->key == key) ? it : nullptr;
+}
+
+DataMap::Entry *DataMap::findOrInsert(const InternedString &key, Type type, bool &inserted) {
+
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), key,
+                               [](const Entry &entry, const InternedString &key) {
+        return entry.key < key;
+    });
+
+    if (it != m_entries.end() && it->key == key) {
+        inserted = false;
+        if (it->type != type) {
+            // a value that changes type is treated like a new one
+            if (it->type == Variant) {
+                delete it->variantValue;
+            }
+            it->type = type;
+            inserted = true;
+        }
+        return it;
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.type = type;
+    entry.variantValue = nullptr;
+    inserted = true;
+    return m_entries.insert(it, entry);
+}
+
+void DataMap::clear() {
+
+    for (Entry &entry : m_entries) {
+        if (entry.type == Variant) {
+            delete entry.variantValue;
+        }
+    }
+    m_entries.clear();
+}
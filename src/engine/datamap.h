@@ -0,0 +1,71 @@
+#ifndef DATAMAP_H
+#define DATAMAP_H
+
+#include <QVariant>
+#include <QVariantMap>
+#include <QVector>
+
+#include "internedstring.h"
+
+
+// map holding the script data of a game object, its entries are kept in a single vector sorted
+// by key, with booleans, integers and doubles stored inline instead of in a QVariant
+class DataMap {
+
+    public:
+        DataMap();
+        DataMap(const DataMap &other);
+        ~DataMap();
+
+        DataMap &operator=(const DataMap &other);
+        bool operator==(const DataMap &other) const;
+        bool operator!=(const DataMap &other) const;
+
+        bool isEmpty() const { return m_entries.isEmpty(); }
+        int size() const { return m_entries.size(); }
+
+        bool contains(const InternedString &key) const;
+
+        QVariant value(const InternedString &key) const;
+        bool boolValue(const InternedString &key) const;
+        int intValue(const InternedString &key) const;
+        double doubleValue(const InternedString &key) const;
+
+        // setters return whether the value was changed
+        bool setBool(const InternedString &key, bool value);
+        bool setInt(const InternedString &key, int value);
+        bool setDouble(const InternedString &key, double value);
+        bool setValue(const InternedString &key, const QVariant &value);
+
+        QVariantMap toVariantMap() const;
+
+        static DataMap fromVariantMap(const QVariantMap &map);
+
+    private:
+        enum Type {
+            Bool,
+            Int,
+            Double,
+            Variant
+        };
+
+        struct Entry {
+            InternedString key;
+            Type type;
+            union {
+                bool boolValue;
+                int intValue;
+                double doubleValue;
+                QVariant *variantValue;
+            };
+        };
+
+        QVector<Entry> m_entries;
+
+        const Entry *find(const InternedString &key) const;
+        Entry *findOrInsert(const InternedString &key, Type type, bool &inserted);
+
+        void clear();
+};
+
+#endif // DATAMAP_H
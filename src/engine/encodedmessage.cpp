@@ -0,0 +1,54 @@
+#include "encodedmessage.h"
+
+#include "util.h"
+
+
+EncodedMessage::EncodedMessage(const QString &message, int color) :
+    m_message(message),
+    m_color(color) {
+
+    for (int i = 0; i < NumEncodings; i++) {
+        m_isEncoded[i] = false;
+    }
+}
+
+const QByteArray &EncodedMessage::encoded(Encoding encoding) const {
+
+    if (!m_isEncoded[encoding]) {
+        QString text;
+        if (m_message.endsWith("\n") || (m_message.startsWith("{") && m_message.endsWith("}"))) {
+            text = m_message;
+        } else {
+            text = m_message + "\n";
+        }
+
+        if ((Color) m_color != Silver) {
+            text = Util::colorize(text, (Color) m_color);
+        }
+
+        m_encoded[encoding] = encode(text, encoding);
+        m_isEncoded[encoding] = true;
+    }
+
+    return m_encoded[encoding];
+}
+
+QByteArray EncodedMessage::encode(const QString &text, Encoding encoding) {
+
+    switch (encoding) {
+        case TelnetEncoding:
+            if (text.trimmed().isEmpty() || (text.startsWith("{") && text.endsWith("}"))) {
+                return QByteArray();
+            }
+            return QString(text).replace("\n", "\r\n").toUtf8();
+
+        case WebSocketEncoding:
+            if (text.trimmed().isEmpty()) {
+                return QByteArray();
+            }
+            return text.toUtf8();
+
+        default:
+            return QByteArray();
+    }
+}
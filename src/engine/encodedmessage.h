@@ -0,0 +1,36 @@
+#ifndef ENCODEDMESSAGE_H
+#define ENCODEDMESSAGE_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "constants.h"
+
+
+class EncodedMessage {
+
+    public:
+        enum Encoding {
+            TelnetEncoding = 0,
+            WebSocketEncoding,
+            NumEncodings
+        };
+
+        EncodedMessage(const QString &message, int color = Silver);
+
+        const QString &message() const { return m_message; }
+        int color() const { return m_color; }
+
+        const QByteArray &encoded(Encoding encoding) const;
+
+        static QByteArray encode(const QString &text, Encoding encoding);
+
+    private:
+        QString m_message;
+        int m_color;
+
+        mutable QByteArray m_encoded[NumEncodings];
+        mutable bool m_isEncoded[NumEncodings];
+};
+
+#endif // ENCODEDMESSAGE_H
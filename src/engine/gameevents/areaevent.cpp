@@ -3,26 +3,39 @@
 #include "area.h"
 #include "character.h"
 #include "room.h"
+#include "roomgraph.h"
 
 
 #define super GameEvent
 
 AreaEvent::AreaEvent(Room *origin, double strength) :
     super(GameEventType::Area, origin, strength) {
-
-    if (!origin->area().isNull()) {
-        Area *area = origin->area().cast<Area *>();
-        for (const GameObjectPtr &room : area->rooms()) {
-            if (room != origin) {
-                addVisit(room.cast<Room *>(), strength);
-            }
-        }
-    }
 }
 
 AreaEvent::~AreaEvent() {
 }
 
+void AreaEvent::precomputeVisits() {
+
+    Room *origin = originRoom();
+    if (origin->area().isNull()) {
+        return;
+    }
+
+    const RoomGraph *graph = roomGraph();
+    double strength = strengthForRoom(origin);
+
+    // rooms without anybody in them have nothing to perceive, so they're not visited at all
+    Area *area = origin->area().cast<Area *>();
+    for (const GameObjectPtr &roomPtr : area->rooms()) {
+        Room *room = roomPtr.cast<Room *>();
+        int roomIndex = room->graphIndex();
+        if (room != origin && roomIndex >= 0 && graph->occupancy(roomIndex) > 0) {
+            addVisit(roomIndex, strength);
+        }
+    }
+}
+
 void AreaEvent::visitRoom(Room *room, double strength) {
 
     for (const GameObjectPtr &characterPtr : room->characters()) {
@@ -31,8 +44,7 @@ void AreaEvent::visitRoom(Room *room, double strength) {
         }
 
         Character *character = characterPtr.cast<Character *>();
-        QString message = descriptionForStrengthAndCharacterInRoom(strength, character, room);
-        character->send(message);
+        perceive(character, room, strength, InternedString());
 
         addAffectedCharacter(characterPtr);
     }
@@ -13,6 +13,7 @@ class AreaEvent : public GameEvent {
         virtual ~AreaEvent();
 
     protected:
+        virtual void precomputeVisits();
         virtual void visitRoom(Room *room, double strength);
 };
 
@@ -1,16 +1,19 @@
 #include "floodevent.h"
 
 #include "character.h"
-#include "portal.h"
 #include "room.h"
+#include "roomgraph.h"
 #include "util.h"
 #include "vector3d.h"
 
 
 #define super GameEvent
 
+static const InternedString OnFlood("onflood");
+
 FloodEvent::FloodEvent(Room *origin, double strength) :
-    super(GameEventType::Flood, origin, strength) {
+    super(GameEventType::Flood, origin, strength),
+    m_visitsPrecomputed(false) {
 }
 
 FloodEvent::~FloodEvent() {
@@ -29,6 +32,28 @@ QString FloodEvent::descriptionForStrengthAndCharacterInRoom(double strength, Ro
     }
 }
 
+void FloodEvent::precomputeVisits() {
+
+    const RoomGraph *graph = roomGraph();
+    if (graph->numRooms() < graph->parallelThreshold()) {
+        return;
+    }
+
+    // which rooms the water reaches depends only on the room layout, so in large worlds that's
+    // determined by the worker threads up front, while the rooms themselves are still modified
+    // here, nearest rooms first
+    double strength = strengthForRoom(originRoom());
+    QVector<int> rooms = graph->reachableRooms(originRoom()->graphIndex(),
+                                               [graph, strength](const RoomGraph::Edge &edge) {
+        return edge.canPassThrough() && graph->position(edge.oppositeRoom).z <= strength;
+    });
+    for (int roomIndex : rooms) {
+        addVisit(roomIndex, strength);
+    }
+
+    m_visitsPrecomputed = true;
+}
+
 void FloodEvent::visitRoom(Room *room, double strength) {
 
     QString message = descriptionForStrengthAndCharacterInRoom(strength - room->position().z, room);
@@ -41,26 +66,27 @@ void FloodEvent::visitRoom(Room *room, double strength) {
         }
 
         if (characterPtr->isPlayer()) {
-            characterPtr->send(message);
+            sendToPlayer(characterPtr.unsafeCast<Character *>(), message);
         } else {
-            characterPtr->invokeTrigger("onflood", message);
+            characterPtr->invokeTrigger(OnFlood, message);
         }
         addAffectedCharacter(characterPtr);
     }
 
-    for (const GameObjectPtr &portalPtr : room->portals()) {
-        Portal *portal = portalPtr.unsafeCast<Portal *>();
-        Room *room1 = portal->room().unsafeCast<Room *>();
-        Room *room2 = portal->room2().unsafeCast<Room *>();
-        Room *oppositeRoom = (room == room1 ? room2 : room1);
-        if (hasBeenVisited(oppositeRoom) || !portal->canPassThrough()) {
+    if (m_visitsPrecomputed) {
+        return;
+    }
+
+    const RoomGraph *graph = roomGraph();
+    for (const RoomGraph::Edge &edge : graph->edges(room->graphIndex())) {
+        if (!edge.canPassThrough() || graph->position(edge.oppositeRoom).z > strength) {
             continue;
         }
 
-        if (oppositeRoom->position().z > strength) {
+        if (hasBeenVisited(edge.oppositeRoom)) {
             continue;
         }
 
-        addVisit(oppositeRoom, strength);
+        addVisit(edge.oppositeRoom, strength);
     }
 }
@@ -15,7 +15,11 @@ class FloodEvent : public GameEvent {
         Q_INVOKABLE virtual QString descriptionForStrengthAndCharacterInRoom(double strength, Room *room) const;
 
     protected:
+        virtual void precomputeVisits();
         virtual void visitRoom(Room *room, double strength);
+
+    private:
+        bool m_visitsPrecomputed;
 };
 
 #endif // FLOODEVENT_H
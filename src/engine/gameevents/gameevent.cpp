@@ -1,28 +1,129 @@
 #include "gameevent.h"
 
+#include <QAtomicInt>
 #include <QHash>
+#include <QList>
 #include <QScriptEngine>
+#include <QThreadStorage>
+#include <QVector>
 
 #include "areaevent.h"
 #include "floodevent.h"
+#include "gameeventaggregator.h"
 #include "movementsoundevent.h"
 #include "movementvisualevent.h"
+#include "player.h"
+#include "realm.h"
 #include "room.h"
+#include "roomgraph.h"
 #include "soundevent.h"
 #include "speechevent.h"
 #include "visualevent.h"
 
 
+class EventVisitState {
+
+    public:
+        quint32 epoch;
+        QVector<quint32> epochs;
+        QVector<double> strengths;
+        QVector<int> queue;
+        int head;
+        int tail;
+
+        EventVisitState() :
+            epoch(0),
+            head(0),
+            tail(0) {
+        }
+
+        void reset(int numRooms) {
+
+            epoch++;
+            if (epoch == 0) {
+                epochs.fill(0);
+                epoch = 1;
+            }
+
+            reserve(numRooms);
+
+            head = 0;
+            tail = 0;
+        }
+
+        void reserve(int numRooms) {
+
+            int size = epochs.size();
+            if (size < numRooms) {
+                epochs.insert(epochs.end(), numRooms - size, 0);
+                strengths.resize(numRooms);
+                queue.resize(numRooms);
+            }
+        }
+};
+
+class EventVisitStatePool {
+
+    public:
+        ~EventVisitStatePool() {
+
+            qDeleteAll(m_states);
+        }
+
+        EventVisitState *acquire() {
+
+            return m_states.isEmpty() ? new EventVisitState() : m_states.takeLast();
+        }
+
+        void release(EventVisitState *state) {
+
+            m_states.append(state);
+        }
+
+    private:
+        QList<EventVisitState *> m_states;
+};
+
+// visit state is recycled between events, but events may be fired from within another event's
+// triggers, so every thread keeps a small pool of states rather than a single one
+static QThreadStorage<EventVisitStatePool *> s_visitStatePools;
+
+static EventVisitStatePool *visitStatePool() {
+
+    if (!s_visitStatePools.hasLocalData()) {
+        s_visitStatePools.setLocalData(new EventVisitStatePool());
+    }
+    return s_visitStatePools.localData();
+}
+
+// identifies events as the source of the perceptions they cause
+static QAtomicInt s_nextSerialNumber(1);
+
+
 GameEvent::GameEvent(GameEventType eventType, Room *origin, double strength) :
     QObject(),
     m_eventType(eventType),
+    m_serialNumber(s_nextSerialNumber.fetchAndAddRelaxed(1)),
     m_origin(origin),
-    m_nextVisitIndex(0) {
+    m_roomGraph(origin->realm()->roomGraph()),
+    m_visitState(visitStatePool()->acquire()),
+    m_numVisitedRooms(0),
+    m_renderedRoom(nullptr),
+    m_renderedStrength(0.0) {
+
+    m_excludedCharacters.setIndexed(true);
+
+    m_roomGraph->validate();
+    m_visitState->reset(m_roomGraph->numRooms());
 
     addVisit(origin, strength);
 }
 
 GameEvent::~GameEvent() {
+
+    if (m_visitState) {
+        visitStatePool()->release(m_visitState);
+    }
 }
 
 bool GameEvent::isSoundEvent() const {
@@ -73,6 +174,11 @@ QString GameEvent::descriptionForStrengthAndCharacterInRoom(double strength, Cha
     }
 }
 
+bool GameEvent::hasCharacterDependentDescriptions() const {
+
+    return false;
+}
+
 void GameEvent::addExcludedCharacter(const GameObjectPtr &excludedCharacter) {
 
     m_excludedCharacters.append(excludedCharacter);
@@ -95,19 +201,34 @@ void GameEvent::setAffectedCharacters(const GameObjectPtrList &affectedCharacter
 
 void GameEvent::fire() {
 
-    while (m_nextVisitIndex < m_visits.size()) {
-        Visit visit = m_visits.value(m_nextVisitIndex);
-        visitRoom(visit.room, visit.strength);
+    if (!m_visitState) {
+        return;
+    }
+
+    precomputeVisits();
 
-        m_nextVisitIndex++;
+    EventVisitState *state = m_visitState;
+    while (state->head < state->tail) {
+        int roomIndex = state->queue[state->head];
+        Room *room = roomGraph()->room(roomIndex);
+        if (room) {
+            visitRoom(room, state->strengths[roomIndex]);
+        }
+
+        state->head++;
     }
 
+    m_numVisitedRooms = state->head;
+
+    visitStatePool()->release(state);
+    m_visitState = nullptr;
+
     deleteLater();
 }
 
 int GameEvent::numVisitedRooms() const {
 
-    return m_nextVisitIndex;
+    return m_visitState ? m_visitState->head : m_numVisitedRooms;
 }
 
 QScriptValue GameEvent::toScriptValue(QScriptEngine *engine, GameEvent *const &event) {
@@ -168,30 +289,131 @@ QVector<QMetaProperty> GameEvent::storedMetaProperties() const {
 
 void GameEvent::addVisit(Room *room, double strength) {
 
-    int index = m_visitIndex.value(room);
-    if (index == 0) {
-        m_visits.append(Visit(room, strength));
-        m_visitIndex[room] = m_visits.size();
-    } else {
-        index--;
-        if (m_visits[index].strength < strength) {
-            m_visits[index].strength = strength;
+    int roomIndex = room->graphIndex();
+    if (roomIndex < 0) {
+        // the room was created after the graph was last built
+        m_roomGraph->validate();
+        roomIndex = room->graphIndex();
+    }
+
+    addVisit(roomIndex, strength);
+}
+
+void GameEvent::addVisit(int roomIndex, double strength) {
+
+    if (!m_visitState || roomIndex < 0) {
+        return;
+    }
+
+    EventVisitState *state = m_visitState;
+    if (roomIndex >= state->epochs.size()) {
+        state->reserve(roomGraph()->numRooms());
+    }
+
+    if (state->epochs[roomIndex] != state->epoch) {
+        state->epochs[roomIndex] = state->epoch;
+        state->strengths[roomIndex] = strength;
+        state->queue[state->tail] = roomIndex;
+        state->tail++;
+    } else if (state->strengths[roomIndex] < strength) {
+        state->strengths[roomIndex] = strength;
+    }
+}
+
+void GameEvent::precomputeVisits() {
+}
+
+QString GameEvent::mergeableDescriptionForStrengthInRoom(double strength, Room *room) {
+
+    Q_UNUSED(strength)
+    Q_UNUSED(room)
+
+    return QString();
+}
+
+GameObjectPtr GameEvent::mergeSubject() const {
+
+    return GameObjectPtr();
+}
+
+QString GameEvent::renderDescription(double strength, Character *character, Room *room) {
+
+    if (hasCharacterDependentDescriptions()) {
+        return descriptionForStrengthAndCharacterInRoom(strength, character, room);
+    }
+
+    // all characters in a room perceive the event at the same strength, so unless the
+    // description depends on who perceives it, it's rendered only once per room
+    if (room != m_renderedRoom || strength != m_renderedStrength) {
+        m_renderedDescription = descriptionForStrengthAndCharacterInRoom(strength, character, room);
+        m_renderedMergeableDescription =
+                m_origin->realm()->eventAggregator()->isCollecting() ?
+                mergeableDescriptionForStrengthInRoom(strength, room) : QString();
+        m_renderedRoom = room;
+        m_renderedStrength = strength;
+    }
+    return m_renderedDescription;
+}
+
+void GameEvent::perceive(Character *character, Room *room, double strength,
+                         const InternedString &triggerName) {
+
+    QString message = renderDescription(strength, character, room);
+
+    GameEventAggregator *aggregator = m_origin->realm()->eventAggregator();
+    if (aggregator->isCollecting()) {
+        if (hasCharacterDependentDescriptions()) {
+            aggregator->addPerception(character, m_serialNumber, triggerName, message);
+        } else {
+            aggregator->addPerception(character, m_serialNumber, triggerName, message,
+                                      m_renderedMergeableDescription, mergeSubject());
         }
+    } else if (character->isPlayer()) {
+        sendToPlayer(character, message);
+    } else if (!triggerName.isEmpty()) {
+        character->invokeTrigger(triggerName, message);
     }
 }
 
 bool GameEvent::hasBeenVisited(Room *room) const {
 
-    int index = m_visitIndex.value(room);
-    return index > 0;
+    return hasBeenVisited(room->graphIndex());
+}
+
+bool GameEvent::hasBeenVisited(int roomIndex) const {
+
+    return m_visitState && roomIndex >= 0 && roomIndex < m_visitState->epochs.size() &&
+           m_visitState->epochs[roomIndex] == m_visitState->epoch;
 }
 
 double GameEvent::strengthForRoom(Room *room) const {
 
-    int index = m_visitIndex.value(room);
-    if (index > 0) {
-        return m_visits[index - 1].strength;
+    int roomIndex = room->graphIndex();
+    return hasBeenVisited(roomIndex) ? m_visitState->strengths[roomIndex] : 0.0;
+}
+
+const RoomGraph *GameEvent::roomGraph() const {
+
+    // triggers invoked while visiting a room may have modified the room layout
+    m_roomGraph->validate();
+    return m_roomGraph;
+}
+
+void GameEvent::sendToPlayer(Character *player, const QString &message) {
+
+    // most players reached by an event receive one of only a few descriptions, so every
+    // description is rendered once and the result is shared by all sessions receiving it
+    for (const EncodedMessage &encodedMessage : m_encodedMessages) {
+        if (encodedMessage.message() == message) {
+            static_cast<Player *>(player)->send(encodedMessage);
+            return;
+        }
+    }
+
+    if (m_encodedMessages.length() < 8) {
+        m_encodedMessages.append(EncodedMessage(message));
+        static_cast<Player *>(player)->send(m_encodedMessages.last());
     } else {
-        return 0.0;
+        static_cast<Player *>(player)->send(EncodedMessage(message));
     }
 }
@@ -5,12 +5,17 @@
 #include <QScriptValue>
 #include <QString>
 
+#include "encodedmessage.h"
 #include "gameobjectptr.h"
+#include "internedstring.h"
 #include "metatyperegistry.h"
 
 
 class Character;
+class EventVisitState;
+class GameEventAggregator;
 class Room;
+class RoomGraph;
 class QScriptEngine;
 
 
@@ -60,6 +65,7 @@ class GameEvent : public QObject {
         Q_INVOKABLE virtual QString descriptionForStrengthAndCharacterInRoom(double strength,
                                                                              Character *character,
                                                                              Room *room) const;
+        virtual bool hasCharacterDependentDescriptions() const;
 
         const GameObjectPtrList &excludedCharacters() const { return m_excludedCharacters; }
         void addExcludedCharacter(const GameObjectPtr &excludedCharacter);
@@ -85,32 +91,36 @@ class GameEvent : public QObject {
         QVector<QMetaProperty> storedMetaProperties() const;
 
     protected:
+        virtual void precomputeVisits();
         virtual void visitRoom(Room *room, double strength) = 0;
 
         void addVisit(Room *room, double strength);
+        void addVisit(int roomIndex, double strength);
+        virtual QString mergeableDescriptionForStrengthInRoom(double strength, Room *room);
+        virtual GameObjectPtr mergeSubject() const;
+
+        QString renderDescription(double strength, Character *character, Room *room);
+        void perceive(Character *character, Room *room, double strength,
+                      const InternedString &triggerName);
+
         bool hasBeenVisited(Room *room) const;
+        bool hasBeenVisited(int roomIndex) const;
         double strengthForRoom(Room *room) const;
 
-    private:
-        class Visit {
-            public:
-                Room *room;
-                double strength;
-
-                Visit() = default;
-                Visit(Room *room, double strength) :
-                    room(room),
-                    strength(strength) {
-                }
-        };
+        const RoomGraph *roomGraph() const;
+
+        void sendToPlayer(Character *player, const QString &message);
 
+    private:
         GameEventType m_eventType;
+        uint m_serialNumber;
 
         Room *m_origin;
 
-        QVector<Visit> m_visits;
-        QHash<Room *, int> m_visitIndex;
-        int m_nextVisitIndex;
+        RoomGraph *m_roomGraph;
+
+        EventVisitState *m_visitState;
+        int m_numVisitedRooms;
 
         QString m_description;
         QString m_distantDescription;
@@ -118,6 +128,13 @@ class GameEvent : public QObject {
 
         GameObjectPtrList m_excludedCharacters;
         GameObjectPtrList m_affectedCharacters;
+
+        Room *m_renderedRoom;
+        double m_renderedStrength;
+        QString m_renderedDescription;
+        QString m_renderedMergeableDescription;
+
+        QList<EncodedMessage> m_encodedMessages;
 };
 
 PT_DECLARE_METATYPE(GameEvent *)
@@ -0,0 +1,128 @@
+#include "gameeventaggregator.h"
+
+#include "character.h"
+#include "player.h"
+#include "util.h"
+
+
+GameEventAggregator::GameEventAggregator() :
+    m_collecting(false),
+    m_numFlushedPerceptions(0) {
+}
+
+GameEventAggregator::~GameEventAggregator() {
+}
+
+void GameEventAggregator::beginBatch() {
+
+    m_collecting = true;
+}
+
+void GameEventAggregator::endBatch() {
+
+    // triggers invoked during delivery may fire new events, which are delivered right away
+    m_collecting = false;
+
+    QList<Perception> perceptions = m_perceptions;
+    m_perceptions.clear();
+    m_observerPerceptions.clear();
+    m_numFlushedPerceptions = 0;
+
+    QList<EncodedMessage> encodedMessages;
+    for (const Perception &perception : perceptions) {
+        deliver(perception, encodedMessages);
+    }
+}
+
+void GameEventAggregator::addPerception(Character *observer, uint source,
+                                        const InternedString &triggerName,
+                                        const QString &message, const QString &mergeableMessage,
+                                        const GameObjectPtr &subject) {
+
+    // objects are keyed by id rather than by address, as addresses are reused by the allocator
+    QList<int> &indices = m_observerPerceptions[observer->id()];
+    for (int index : indices) {
+        Perception &perception = m_perceptions[index];
+        if (perception.triggerName != triggerName) {
+            continue;
+        }
+
+        if (!mergeableMessage.isEmpty()) {
+            if (perception.mergeableMessage == mergeableMessage) {
+                if (!perception.subjects.contains(subject)) {
+                    perception.subjects.append(subject);
+                }
+                return;
+            }
+        } else if (perception.mergeableMessage.isEmpty() && perception.source == source &&
+                   perception.message == message) {
+            return;
+        }
+    }
+
+    Perception perception;
+    perception.observer = observer;
+    perception.source = source;
+    perception.triggerName = triggerName;
+    perception.message = message;
+    if (!mergeableMessage.isEmpty()) {
+        perception.mergeableMessage = mergeableMessage;
+        perception.subjects.append(subject);
+    }
+    m_perceptions.append(perception);
+
+    indices.append(m_perceptions.length() - 1);
+}
+
+void GameEventAggregator::flush(const Character *observer) {
+
+    QHash<uint, QList<int> >::iterator it = m_observerPerceptions.find(observer->id());
+    if (it == m_observerPerceptions.end()) {
+        return;
+    }
+
+    QList<int> indices = it.value();
+    m_observerPerceptions.erase(it);
+
+    // flushed perceptions stay behind without an observer, so the indices of the others remain
+    // valid until the end of the batch
+    QList<EncodedMessage> encodedMessages;
+    for (int index : indices) {
+        Perception perception = m_perceptions[index];
+        m_perceptions[index].observer = GameObjectPtr();
+        m_numFlushedPerceptions++;
+
+        deliver(perception, encodedMessages);
+    }
+}
+
+void GameEventAggregator::deliver(const Perception &perception,
+                                  QList<EncodedMessage> &encodedMessages) {
+
+    if (perception.observer.isNull()) {
+        return;
+    }
+
+    QString message = perception.message;
+    if (perception.subjects.length() > 1) {
+        int options = perception.mergeableMessage.startsWith("%1") ? Capitalized : NoOptions;
+        message = perception.mergeableMessage.arg(Util::joinPtrList(perception.subjects, options));
+    }
+
+    Character *observer = perception.observer.unsafeCast<Character *>();
+    if (observer->isPlayer()) {
+        Player *player = static_cast<Player *>(observer);
+
+        for (const EncodedMessage &encodedMessage : encodedMessages) {
+            if (encodedMessage.message() == message) {
+                player->send(encodedMessage);
+                return;
+            }
+        }
+
+        encodedMessages.append(EncodedMessage(message));
+        player->send(encodedMessages.last());
+    } else if (!perception.triggerName.isEmpty()) {
+        observer->invokeTrigger(perception.triggerName, message);
+    }
+}
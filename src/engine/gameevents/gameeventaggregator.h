@@ -0,0 +1,59 @@
+#ifndef GAMEEVENTAGGREGATOR_H
+#define GAMEEVENTAGGREGATOR_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include "encodedmessage.h"
+#include "gameobjectptr.h"
+#include "internedstring.h"
+
+
+class Character;
+
+class GameEventAggregator {
+
+    public:
+        GameEventAggregator();
+        ~GameEventAggregator();
+
+        bool isCollecting() const { return m_collecting; }
+
+        void beginBatch();
+        void endBatch();
+
+        // identical messages are only collapsed when they originate from the same source, while
+        // mergeable messages are merged across sources
+        void addPerception(Character *observer, uint source, const InternedString &triggerName,
+                           const QString &message,
+                           const QString &mergeableMessage = QString(),
+                           const GameObjectPtr &subject = GameObjectPtr());
+
+        // delivers the perceptions collected for the observer right away, so that they don't
+        // arrive after messages that are sent to the observer directly
+        void flush(const Character *observer);
+
+        int numPerceptions() const { return m_perceptions.length() - m_numFlushedPerceptions; }
+
+    private:
+        class Perception {
+            public:
+                GameObjectPtr observer;
+                uint source;
+                InternedString triggerName;
+                QString message;
+                QString mergeableMessage;
+                GameObjectPtrList subjects;
+        };
+
+        bool m_collecting;
+
+        QList<Perception> m_perceptions;
+        QHash<uint, QList<int> > m_observerPerceptions;
+        int m_numFlushedPerceptions;
+
+        void deliver(const Perception &perception, QList<EncodedMessage> &encodedMessages);
+};
+
+#endif // GAMEEVENTAGGREGATOR_H
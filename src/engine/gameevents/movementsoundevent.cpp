@@ -104,3 +104,9 @@ QString MovementSoundEvent::descriptionForStrengthAndCharacterInRoom(double stre
 
     return QString("You hear %1 %2 %3.").arg(description, m_continuous, direction);
 }
+
+bool MovementSoundEvent::hasCharacterDependentDescriptions() const {
+
+    // the direction the sound comes from is relative to the direction the character faces
+    return true;
+}
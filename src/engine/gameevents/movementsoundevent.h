@@ -38,6 +38,7 @@ class MovementSoundEvent : public SoundEvent {
         Q_INVOKABLE virtual QString descriptionForStrengthAndCharacterInRoom(double strength,
                                                                              Character *character,
                                                                              Room *room) const;
+        virtual bool hasCharacterDependentDescriptions() const;
 
     private:
         Room *m_destination;
@@ -6,6 +6,7 @@
 #include "point3d.h"
 #include "portal.h"
 #include "room.h"
+#include "roomgraph.h"
 #include "util.h"
 #include "vector3d.h"
 
@@ -14,7 +15,8 @@
 
 MovementVisualEvent::MovementVisualEvent(Room *origin, double strength) :
     super(GameEventType::MovementVisual, origin, strength),
-    m_destination(nullptr) {
+    m_destination(nullptr),
+    m_subjectStrength(-1.0) {
 }
 
 MovementVisualEvent::~MovementVisualEvent() {
@@ -23,6 +25,7 @@ MovementVisualEvent::~MovementVisualEvent() {
 void MovementVisualEvent::setSubject(const GameObjectPtr &subject) {
 
     m_subject = subject;
+    m_subjectStrength = -1.0;
 }
 
 void MovementVisualEvent::setDestination(const GameObjectPtr &destination) {
@@ -64,35 +67,69 @@ QString MovementVisualEvent::descriptionForStrengthAndCharacterInRoom(double str
 
     Q_UNUSED(character)
 
-    QString subject = m_subject->nameAtStrength(strength);
+    return describe(subjectNameAtStrength(strength), m_simplePresent, m_helperVerb, room);
+}
+
+QString MovementVisualEvent::mergeableDescriptionForStrengthInRoom(double strength, Room *room) {
+
+    // only characters who are recognized can be counted along with others doing the same
+    if (!m_subject->isCharacter() ||
+        subjectNameAtStrength(strength) != m_subject->indefiniteName()) {
+        return QString();
+    }
+
+    QString simplePresent = m_simplePresent;
+    if (simplePresent.endsWith("s")) {
+        simplePresent.chop(1);
+    }
+    return describe("%1", simplePresent, m_helperVerb == "is" ? "are" : m_helperVerb, room);
+}
+
+GameObjectPtr MovementVisualEvent::mergeSubject() const {
+
+    return m_subject;
+}
+
+QString MovementVisualEvent::subjectNameAtStrength(double strength) const {
+
+    if (strength != m_subjectStrength) {
+        m_subjectName = m_subject->nameAtStrength(strength);
+        m_subjectStrength = strength;
+    }
+    return m_subjectName;
+}
+
+QString MovementVisualEvent::describe(const QString &subject, const QString &simplePresent,
+                                      const QString &helperVerb, Room *room) const {
 
     if (room == originRoom()) {
-        for (const GameObjectPtr &portalPtr : room->portals()) {
-            Portal *portal = portalPtr.cast<Portal *>();
-            if (portal->room() == m_destination || portal->room2() == m_destination) {
+        const RoomGraph *graph = roomGraph();
+        for (const RoomGraph::Edge &edge : graph->edges(room->graphIndex())) {
+            if (graph->room(edge.oppositeRoom) == m_destination) {
+                Portal *portal = edge.portal;
                 QString exitName = portal->nameFromRoom(room);
                 if (Util::isDirection(exitName)) {
                     return QString("%1 %2 %3.")
-                           .arg(Util::capitalize(subject), m_simplePresent, exitName);
+                           .arg(Util::capitalize(subject), simplePresent, exitName);
                 } else if (exitName == "out") {
                     return QString("%1 %2 outside.")
-                           .arg(Util::capitalize(subject), m_simplePresent);
+                           .arg(Util::capitalize(subject), simplePresent);
                 } else {
                     if (portal->canOpenFromRoom(room)) {
                         return QString("%1 %2 through the %3.")
-                               .arg(Util::capitalize(subject), m_simplePresent, exitName);
+                               .arg(Util::capitalize(subject), simplePresent, exitName);
                     } else {
                         return QString("%1 %2 to the %3.")
-                               .arg(Util::capitalize(subject), m_simplePresent, exitName);
+                               .arg(Util::capitalize(subject), simplePresent, exitName);
                     }
                 }
             }
         }
 
-        return QString("%1 %2 %3.").arg(Util::capitalize(subject), m_simplePresent,
+        return QString("%1 %2 %3.").arg(Util::capitalize(subject), simplePresent,
                                         Util::directionForVector(m_direction));
     } else if (room == m_destination) {
-        return QString("%1 %2 up to you.").arg(Util::capitalize(subject), m_simplePresent);
+        return QString("%1 %2 up to you.").arg(Util::capitalize(subject), simplePresent);
     }
 
     Vector3D vector = room->position() - originRoom()->position();
@@ -110,9 +147,9 @@ QString MovementVisualEvent::descriptionForStrengthAndCharacterInRoom(double str
         prefix = "You see";
     }
 
-    QString helperVerb;
+    QString helper;
     if (prefix.endsWith(",")) {
-        helperVerb = m_helperVerb + " ";
+        helper = helperVerb + " ";
     }
 
     QString direction;
@@ -124,22 +161,26 @@ QString MovementVisualEvent::descriptionForStrengthAndCharacterInRoom(double str
         direction = Util::directionForVector(m_direction);
     }
 
-    return QString("%1 %2 %3%4 %5.").arg(prefix, subject, helperVerb, m_continuous, direction);
+    return QString("%1 %2 %3%4 %5.").arg(prefix, subject, helper, m_continuous, direction);
 }
 
-bool MovementVisualEvent::isWithinSight(Room *targetRoom, Room *sourceRoom) {
+bool MovementVisualEvent::isWithinSight(const RoomGraph *graph, int targetIndex,
+                                        int sourceIndex) {
 
+    Room *sourceRoom = graph->room(sourceIndex);
     if (sourceRoom == originRoom() || sourceRoom == m_destination) {
         return true;
     }
 
-    Vector3D sourceVector = (sourceRoom->position() - originRoom()->position()).normalized();
-    Vector3D targetVector = (targetRoom->position() - sourceRoom->position()).normalized();
+    Point3D sourcePosition = graph->position(sourceIndex);
+    Vector3D sourceVector = (sourcePosition - originRoom()->position()).normalized();
+    Vector3D targetVector = (graph->position(targetIndex) - sourcePosition).normalized();
     if (sourceVector == targetVector) {
         return true;
     }
 
-    if (~sourceRoom->flags() & RoomFlags::HasWalls) {
+    RoomFlags sourceFlags = graph->flags(sourceIndex);
+    if (~sourceFlags & RoomFlags::HasWalls) {
         if (targetVector.z == sourceVector.z) {
             return true;
         }
@@ -149,18 +190,18 @@ bool MovementVisualEvent::isWithinSight(Room *targetRoom, Room *sourceRoom) {
         }
     }
 
-    if ((~sourceRoom->flags() & RoomFlags::HasCeiling && targetVector.z >= sourceVector.z) ||
-        (~sourceRoom->flags() & RoomFlags::HasFloor && targetVector.z <= sourceVector.z)) {
+    if ((~sourceFlags & RoomFlags::HasCeiling && targetVector.z >= sourceVector.z) ||
+        (~sourceFlags & RoomFlags::HasFloor && targetVector.z <= sourceVector.z)) {
         return true;
     }
 
     if (m_destination) {
-        sourceVector = (sourceRoom->position() - m_destination->position()).normalized();
+        sourceVector = (sourcePosition - m_destination->position()).normalized();
         if (sourceVector == targetVector) {
             return true;
         }
 
-        if (~sourceRoom->flags() & RoomFlags::HasWalls) {
+        if (~sourceFlags & RoomFlags::HasWalls) {
             if (targetVector.z == sourceVector.z) {
                 return true;
             }
@@ -171,6 +212,6 @@ bool MovementVisualEvent::isWithinSight(Room *targetRoom, Room *sourceRoom) {
         }
     }
 
-    return ((~sourceRoom->flags() & RoomFlags::HasCeiling && targetVector.z >= sourceVector.z) ||
-            (~sourceRoom->flags() & RoomFlags::HasFloor && targetVector.z <= sourceVector.z));
+    return ((~sourceFlags & RoomFlags::HasCeiling && targetVector.z >= sourceVector.z) ||
+            (~sourceFlags & RoomFlags::HasFloor && targetVector.z <= sourceVector.z));
 }
@@ -44,9 +44,18 @@ class MovementVisualEvent : public VisualEvent {
                                                                              Room *room) const;
 
     protected:
-        virtual bool isWithinSight(Room *targetRoom, Room *sourceRoom);
+        virtual bool isWithinSight(const RoomGraph *graph, int targetIndex, int sourceIndex);
+
+        virtual Room *destinationRoom() const { return m_destination; }
+
+        virtual QString mergeableDescriptionForStrengthInRoom(double strength, Room *room);
+        virtual GameObjectPtr mergeSubject() const;
 
     private:
+        QString subjectNameAtStrength(double strength) const;
+        QString describe(const QString &subject, const QString &simplePresent,
+                         const QString &helperVerb, Room *room) const;
+
         GameObjectPtr m_subject;
 
         Room *m_destination;
@@ -57,6 +66,9 @@ class MovementVisualEvent : public VisualEvent {
         QString m_simplePresent;
         QString m_helperVerb;
         QString m_continuous;
+
+        mutable double m_subjectStrength;
+        mutable QString m_subjectName;
 };
 
 #endif // MOVEMENTVISUALEVENT_H
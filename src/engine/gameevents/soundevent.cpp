@@ -1,12 +1,14 @@
 #include "soundevent.h"
 
 #include "character.h"
-#include "portal.h"
 #include "room.h"
+#include "roomgraph.h"
 
 
 #define super GameEvent
 
+static const InternedString OnSound("onsound");
+
 SoundEvent::SoundEvent(Room *origin, double strength) :
     SoundEvent(GameEventType::Sound, origin, strength) {
 }
@@ -29,28 +31,26 @@ void SoundEvent::visitRoom(Room *room, double strength) {
             }
 
             Character *character = characterPtr.cast<Character *>();
-            QString message = descriptionForStrengthAndCharacterInRoom(strength, character, room);
-            if (character->isPlayer()) {
-                character->send(message);
-            } else {
-                character->invokeTrigger("onsound", message);
-            }
+            perceive(character, room, strength, OnSound);
 
             addAffectedCharacter(characterPtr);
         }
 
-        for (const GameObjectPtr &portalPtr : room->portals()) {
-            Portal *portal = portalPtr.cast<Portal *>();
-            Room *room1 = portal->room().unsafeCast<Room *>();
-            Room *room2 = portal->room2().unsafeCast<Room *>();
-            Room *oppositeRoom = (room == room1 ? room2 : room1);
-            if (hasBeenVisited(oppositeRoom) || !portal->canHearThrough()) {
+        // don't bother propagating any further if nobody's around to hear it
+        const RoomGraph *graph = roomGraph();
+        int index = room->graphIndex();
+        if (!graph->hasOccupantsWithinReach(index, GameEventType::Sound, strength)) {
+            return;
+        }
+
+        for (const RoomGraph::Edge &edge : graph->edges(index)) {
+            if (!edge.canHearThrough() || hasBeenVisited(edge.oppositeRoom)) {
                 continue;
             }
 
-            double propagatedStrength = strength * portal->eventMultiplier(GameEventType::Sound);
+            double propagatedStrength = strength * edge.multipliers[GameEventType::Sound];
             if (propagatedStrength >= 0.1) {
-                addVisit(oppositeRoom, propagatedStrength);
+                addVisit(edge.oppositeRoom, propagatedStrength);
             }
         }
     }
@@ -1,20 +1,26 @@
 #include "visualevent.h"
 
+#include <QVector>
+
 #include "character.h"
-#include "portal.h"
 #include "room.h"
+#include "roomgraph.h"
 #include "util.h"
 #include "vector3d.h"
 
 
 #define super GameEvent
 
+static const InternedString OnVisual("onvisual");
+
 VisualEvent::VisualEvent(Room *origin, double strength) :
     VisualEvent(GameEventType::Visual, origin, strength) {
 }
 
 VisualEvent::VisualEvent(GameEventType eventType, Room *origin, double strength) :
-    super(eventType, origin, strength) {
+    super(eventType, origin, strength),
+    m_visibilityChecked(false),
+    m_usesVisibilityTable(false) {
 }
 
 VisualEvent::~VisualEvent() {
@@ -22,6 +28,13 @@ VisualEvent::~VisualEvent() {
 
 void VisualEvent::visitRoom(Room *room, double strength) {
 
+    // the origin is always visited first, at which point all the rooms from which the event can
+    // be seen are queued at once
+    if (!m_visibilityChecked) {
+        m_visibilityChecked = true;
+        m_usesVisibilityTable = addVisibleRooms(strength);
+    }
+
     strength *= room->eventMultipliers()[GameEventType::Visual];
 
     if (strength >= 0.1) {
@@ -40,50 +53,170 @@ void VisualEvent::visitRoom(Room *room, double strength) {
                 }
             }
 
-            QString message = descriptionForStrengthAndCharacterInRoom(strength, character, room);
-            if (character->isPlayer()) {
-                character->send(message);
-            } else {
-                character->invokeTrigger("onvisual", message);
-            }
+            perceive(character, room, strength, OnVisual);
 
             addAffectedCharacter(characterPtr);
         }
 
-        for (const GameObjectPtr &portalPtr : room->portals()) {
-            Portal *portal = portalPtr.unsafeCast<Portal *>();
-            Room *room1 = portal->room().unsafeCast<Room *>();
-            Room *room2 = portal->room2().unsafeCast<Room *>();
-            Room *oppositeRoom = (room == room1 ? room2 : room1);
-            if (hasBeenVisited(oppositeRoom)) {
+        if (m_usesVisibilityTable) {
+            return;
+        }
+
+        // don't bother propagating any further if nobody's around to see it
+        const RoomGraph *graph = roomGraph();
+        int index = room->graphIndex();
+        if (!graph->hasOccupantsWithinReach(index, GameEventType::Visual, strength)) {
+            return;
+        }
+
+        for (const RoomGraph::Edge &edge : graph->edges(index)) {
+            if (!edge.canSeeThrough()) {
                 continue;
             }
 
-            if (!portal->canSeeThrough() || !isWithinSight(oppositeRoom, room)) {
+            if (hasBeenVisited(edge.oppositeRoom) ||
+                !isWithinSight(graph, edge.oppositeRoom, index)) {
                 continue;
             }
 
-            double propagatedStrength = strength * portal->eventMultiplier(GameEventType::Visual);
+            double propagatedStrength = strength * edge.multipliers[GameEventType::Visual];
             if (propagatedStrength >= 0.1) {
-                addVisit(oppositeRoom, propagatedStrength);
+                addVisit(edge.oppositeRoom, propagatedStrength);
+            }
+        }
+    }
+}
+
+Room *VisualEvent::destinationRoom() const {
+
+    return nullptr;
+}
+
+bool VisualEvent::addVisibleRooms(double strength) {
+
+    const RoomGraph *graph = roomGraph();
+    if (!graph->visibilityTablesEnabled() || strength <= 0.0) {
+        return false;
+    }
+
+    int originIndex = originRoom()->graphIndex();
+    Room *destination = destinationRoom();
+    int destinationIndex = (destination ? destination->graphIndex() : -1);
+
+    double originStrength = strength * graph->eventMultiplier(originIndex, GameEventType::Visual);
+    bool isPerceivable = graph->hasOccupantsWithinReach(originIndex, GameEventType::Visual,
+                                                        originStrength);
+    if (!isPerceivable && destinationIndex >= 0) {
+        isPerceivable = graph->hasOccupantsWithinReach(destinationIndex, GameEventType::Visual,
+                                                       strength);
+    }
+    if (!isPerceivable) {
+        return true;
+    }
+
+    const RoomGraph::VisibilityTable *table = graph->visibilityTable(eventType(), originIndex,
+                                                                     destinationIndex);
+    RoomGraph::VisibilityTable *newTable = nullptr;
+    if (!table) {
+        newTable = new RoomGraph::VisibilityTable();
+        buildVisibilityTable(graph, originIndex, destinationIndex, strength, newTable);
+        table = newTable;
+    }
+
+    // events for which the table isn't exact propagate room by room instead
+    bool usesTable = (table->isComplete && table->isExactFor(strength));
+    if (usesTable) {
+        for (const RoomGraph::VisibilityTable::Entry &entry : table->entries) {
+            addVisit(entry.room, strength * entry.strength);
+        }
+    }
+
+    if (newTable) {
+        graph->insertVisibilityTable(eventType(), originIndex, destinationIndex, newTable);
+    }
+
+    return usesTable;
+}
+
+void VisualEvent::buildVisibilityTable(const RoomGraph *graph, int originIndex,
+                                       int destinationIndex, double strength,
+                                       RoomGraph::VisibilityTable *table) {
+
+    // the same breadth-first traversal as the propagation in visitRoom(), so every room is
+    // reached in the same order and at the strength of the first path that gets there. strengths
+    // are relative to that of the event, and paths are cut off where an event of the given
+    // strength would become too weak
+    double threshold = 0.1 / strength;
+    QVector<bool> queued(graph->numRooms(), false);
+
+    RoomGraph::VisibilityTable::Entry entry;
+    entry.room = originIndex;
+    entry.strength = 1.0;
+    table->entries.append(entry);
+    queued[originIndex] = true;
+
+    if (destinationIndex >= 0 && !queued[destinationIndex]) {
+        entry.room = destinationIndex;
+        table->entries.append(entry);
+        queued[destinationIndex] = true;
+    }
+
+    for (int i = 0; i < table->entries.size(); i++) {
+        int index = table->entries[i].room;
+
+        // amplifying multipliers make the cutoff depend on more than the strength of the event
+        double roomMultiplier = graph->eventMultiplier(index, GameEventType::Visual);
+        if (roomMultiplier > 1.0) {
+            table->isComplete = false;
+            return;
+        }
+
+        double roomStrength = table->entries[i].strength * roomMultiplier;
+        if (roomStrength <= 0.0) {
+            continue;
+        }
+
+        for (const RoomGraph::Edge &edge : graph->edges(index)) {
+            if (!edge.canSeeThrough() || queued[edge.oppositeRoom] ||
+                !isWithinSight(graph, edge.oppositeRoom, index)) {
+                continue;
+            }
+
+            double multiplier = edge.multipliers[GameEventType::Visual];
+            if (multiplier > 1.0) {
+                table->isComplete = false;
+                return;
+            }
+
+            double propagatedStrength = roomStrength * multiplier;
+            if (propagatedStrength >= threshold) {
+                entry.room = edge.oppositeRoom;
+                entry.strength = propagatedStrength;
+                table->entries.append(entry);
+                table->minStrength = qMin(table->minStrength, propagatedStrength);
+                queued[edge.oppositeRoom] = true;
+            } else {
+                table->maxPrunedStrength = qMax(table->maxPrunedStrength, propagatedStrength);
             }
         }
     }
 }
 
-bool VisualEvent::isWithinSight(Room *targetRoom, Room *sourceRoom) {
+bool VisualEvent::isWithinSight(const RoomGraph *graph, int targetIndex, int sourceIndex) {
 
-    if (sourceRoom == originRoom()) {
+    if (graph->room(sourceIndex) == originRoom()) {
         return true;
     }
 
-    Vector3D sourceVector = (sourceRoom->position() - originRoom()->position()).normalized();
-    Vector3D targetVector = (targetRoom->position() - sourceRoom->position()).normalized();
+    Point3D sourcePosition = graph->position(sourceIndex);
+    Vector3D sourceVector = (sourcePosition - originRoom()->position()).normalized();
+    Vector3D targetVector = (graph->position(targetIndex) - sourcePosition).normalized();
     if (sourceVector == targetVector) {
         return true;
     }
 
-    if (~sourceRoom->flags() & RoomFlags::HasWalls) {
+    RoomFlags sourceFlags = graph->flags(sourceIndex);
+    if (~sourceFlags & RoomFlags::HasWalls) {
         if (targetVector.z == sourceVector.z) {
             return true;
         }
@@ -93,6 +226,6 @@ bool VisualEvent::isWithinSight(Room *targetRoom, Room *sourceRoom) {
         }
     }
 
-    return ((~sourceRoom->flags() & RoomFlags::HasCeiling && targetVector.z >= sourceVector.z) ||
-            (~sourceRoom->flags() & RoomFlags::HasFloor && targetVector.z <= sourceVector.z));
+    return ((~sourceFlags & RoomFlags::HasCeiling && targetVector.z >= sourceVector.z) ||
+            (~sourceFlags & RoomFlags::HasFloor && targetVector.z <= sourceVector.z));
 }
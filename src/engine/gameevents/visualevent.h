@@ -2,6 +2,7 @@
 #define VISUALEVENT_H
 
 #include "gameevent.h"
+#include "roomgraph.h"
 
 
 class VisualEvent : public GameEvent {
@@ -16,7 +17,17 @@ class VisualEvent : public GameEvent {
     protected:
         virtual void visitRoom(Room *room, double strength);
 
-        virtual bool isWithinSight(Room *targetRoom, Room *sourceRoom);
+        virtual bool isWithinSight(const RoomGraph *graph, int targetIndex, int sourceIndex);
+
+        virtual Room *destinationRoom() const;
+
+    private:
+        bool addVisibleRooms(double strength);
+        void buildVisibilityTable(const RoomGraph *graph, int originIndex, int destinationIndex,
+                                  double strength, RoomGraph::VisibilityTable *table);
+
+        bool m_visibilityChecked;
+        bool m_usesVisibilityTable;
 };
 
 #endif // VISUALEVENT_H
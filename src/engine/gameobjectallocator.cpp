@@ -0,0 +1,177 @@
+#include "gameobjectallocator.h"
+
+#include <algorithm>
+#include <new>
+
+#include <QMutex>
+#include <QMutexLocker>
+
+
+static const size_t Granularity = 16;
+
+// objects larger than this are left to the regular allocator
+static const size_t MaxPooledSize = 2048;
+
+static const int SlotsPerSlab = 256;
+
+class GameObjectSlab {
+
+    public:
+        GameObjectSlab(char *memory) :
+            memory(memory),
+            freeList(nullptr),
+            numFree(0),
+            isAvailable(false) {
+        }
+
+        char *memory;
+
+        // singly linked list through the first bytes of every free slot
+        void *freeList;
+        int numFree;
+
+        // whether the slab is listed among the pool's available slabs
+        bool isAvailable;
+};
+
+class GameObjectPool {
+
+    public:
+        GameObjectPool() :
+            objectSize(0),
+            numAllocated(0),
+            numFree(0) {
+        }
+
+        size_t objectSize;
+
+        // ordered by address, so the slab a slot belongs to can be found when it's freed
+        QVector<GameObjectSlab *> slabs;
+
+        // slabs that (may) have free slots, slabs that filled up are only dropped from this
+        // list once they're encountered during allocation
+        QVector<GameObjectSlab *> availableSlabs;
+
+        int numAllocated;
+        int numFree;
+};
+
+// objects are created in the game thread, but copies get deleted by the sync thread
+static QMutex s_mutex;
+
+static GameObjectPool s_pools[MaxPooledSize / Granularity];
+
+
+static bool slabPrecedes(const void *pointer, const GameObjectSlab *slab) {
+
+    return pointer < slab->memory;
+}
+
+static bool slabAddressLess(const GameObjectSlab *slab, const GameObjectSlab *other) {
+
+    return slab->memory < other->memory;
+}
+
+
+void *GameObjectAllocator::allocate(size_t size) {
+
+    if (size == 0 || size > MaxPooledSize) {
+        return ::operator new(size);
+    }
+
+    QMutexLocker locker(&s_mutex);
+
+    int poolIndex = (size - 1) / Granularity;
+    GameObjectPool &pool = s_pools[poolIndex];
+    while (!pool.availableSlabs.isEmpty() && pool.availableSlabs.last()->numFree == 0) {
+        pool.availableSlabs.last()->isAvailable = false;
+        pool.availableSlabs.removeLast();
+    }
+
+    if (pool.availableSlabs.isEmpty()) {
+        pool.objectSize = (poolIndex + 1) * Granularity;
+
+        GameObjectSlab *slab = new GameObjectSlab(
+                static_cast<char *>(::operator new(pool.objectSize * SlotsPerSlab)));
+        for (int i = SlotsPerSlab - 1; i >= 0; i--) {
+            void *slot = slab->memory + i * pool.objectSize;
+            *static_cast<void **>(slot) = slab->freeList;
+            slab->freeList = slot;
+        }
+        slab->numFree = SlotsPerSlab;
+        slab->isAvailable = true;
+
+        pool.slabs.insert(std::upper_bound(pool.slabs.begin(), pool.slabs.end(), slab,
+                                           slabAddressLess), slab);
+        pool.availableSlabs.append(slab);
+        pool.numFree += SlotsPerSlab;
+    }
+
+    GameObjectSlab *slab = pool.availableSlabs.last();
+    void *slot = slab->freeList;
+    slab->freeList = *static_cast<void **>(slot);
+    slab->numFree--;
+    pool.numFree--;
+    pool.numAllocated++;
+    return slot;
+}
+
+void GameObjectAllocator::deallocate(void *pointer, size_t size) {
+
+    if (!pointer) {
+        return;
+    }
+
+    if (size == 0 || size > MaxPooledSize) {
+        ::operator delete(pointer);
+        return;
+    }
+
+    QMutexLocker locker(&s_mutex);
+
+    GameObjectPool &pool = s_pools[(size - 1) / Granularity];
+    auto it = std::upper_bound(pool.slabs.begin(), pool.slabs.end(), pointer, slabPrecedes) - 1;
+    GameObjectSlab *slab = *it;
+
+    *static_cast<void **>(pointer) = slab->freeList;
+    slab->freeList = pointer;
+    slab->numFree++;
+    pool.numFree++;
+    pool.numAllocated--;
+
+    // empty slabs are returned, unless the pool would run out of free slots, so that a single
+    // object being created and deleted over and over doesn't allocate a slab every time
+    if (slab->numFree == SlotsPerSlab && pool.numFree > SlotsPerSlab) {
+        pool.slabs.erase(it);
+        if (slab->isAvailable) {
+            pool.availableSlabs.removeOne(slab);
+        }
+        pool.numFree -= SlotsPerSlab;
+
+        ::operator delete(slab->memory);
+        delete slab;
+    } else if (!slab->isAvailable) {
+        slab->isAvailable = true;
+        pool.availableSlabs.append(slab);
+    }
+}
+
+QVector<GameObjectAllocator::PoolStatistics> GameObjectAllocator::statistics() {
+
+    QMutexLocker locker(&s_mutex);
+
+    QVector<PoolStatistics> statistics;
+    for (const GameObjectPool &pool : s_pools) {
+        if (pool.slabs.isEmpty()) {
+            continue;
+        }
+
+        PoolStatistics poolStatistics;
+        poolStatistics.objectSize = pool.objectSize;
+        poolStatistics.numSlabs = pool.slabs.size();
+        poolStatistics.numAllocated = pool.numAllocated;
+        poolStatistics.numFree = pool.numFree;
+        statistics.append(poolStatistics);
+    }
+    return statistics;
+}
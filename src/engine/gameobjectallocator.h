@@ -0,0 +1,32 @@
+#ifndef GAMEOBJECTALLOCATOR_H
+#define GAMEOBJECTALLOCATOR_H
+
+#include <cstddef>
+
+#include <QVector>
+
+
+// game objects are allocated from slabs of equally sized slots, with a pool of slabs per object
+// size, so objects of the same type end up close together and freed slots get reused. slabs are
+// returned once all their objects are freed, except for the last one with free slots in a pool.
+//
+// only the objects themselves are pooled: their QObject private data and whatever their members
+// hold on the heap, like the data of strings, lists and variants, comes from the regular allocator
+class GameObjectAllocator {
+
+    public:
+        class PoolStatistics {
+            public:
+                int objectSize;
+                int numSlabs;
+                int numAllocated;
+                int numFree;
+        };
+
+        static void *allocate(size_t size);
+        static void deallocate(void *pointer, size_t size);
+
+        static QVector<PoolStatistics> statistics();
+};
+
+#endif // GAMEOBJECTALLOCATOR_H
@@ -8,15 +8,26 @@
 #include <QStringList>
 
 #include "conversionutil.h"
+#include "encodedmessage.h"
+#include "nameindex.h"
+#include "player.h"
 #include "realm.h"
 #include "util.h"
 
 
+static const int MIN_CAPACITY = 16;
+
+// lists below this size are scanned faster than they are hashed
+static const int MIN_INDEXED_SIZE = 16;
+
+
 GameObjectPtr::GameObjectPtr() :
     m_gameObject(nullptr),
     m_objectType(GameObjectType::Unknown),
     m_id(0),
-    m_list(nullptr) {
+    m_list(nullptr),
+    m_previous(nullptr),
+    m_next(nullptr) {
 }
 
 GameObjectPtr::GameObjectPtr(GameObject *gameObject) :
@@ -34,7 +45,9 @@ GameObjectPtr::GameObjectPtr(Realm *realm, GameObjectType objectType, uint id) :
     m_gameObject(nullptr),
     m_objectType(objectType),
     m_id(id),
-    m_list(nullptr) {
+    m_list(nullptr),
+    m_previous(nullptr),
+    m_next(nullptr) {
 
     if (realm->isInitialized()) {
         resolve(realm);
@@ -45,7 +58,9 @@ GameObjectPtr::GameObjectPtr(const GameObjectPtr &other) :
     m_gameObject(other.m_gameObject),
     m_objectType(other.m_objectType),
     m_id(other.m_id),
-    m_list(nullptr) {
+    m_list(nullptr),
+    m_previous(nullptr),
+    m_next(nullptr) {
 
     if (m_gameObject) {
         m_gameObject->registerPointer(this);
@@ -249,13 +264,16 @@ void swap(GameObjectPtr &first, GameObjectPtr &second) {
         return;
     }
 
-    if (first.m_gameObject) {
-        first.m_gameObject->registerPointer(&second);
-        first.m_gameObject->unregisterPointer(&first);
-    }
-    if (second.m_gameObject) {
-        second.m_gameObject->registerPointer(&first);
-        second.m_gameObject->unregisterPointer(&second);
+    // every pointer takes over the other's position in its object's list of pointers
+    if (first.m_gameObject && second.m_gameObject) {
+        GameObjectPtr placeholder;
+        second.m_gameObject->replacePointer(&second, &placeholder);
+        first.m_gameObject->replacePointer(&first, &second);
+        second.m_gameObject->replacePointer(&placeholder, &first);
+    } else if (first.m_gameObject) {
+        first.m_gameObject->replacePointer(&first, &second);
+    } else if (second.m_gameObject) {
+        second.m_gameObject->replacePointer(&second, &first);
     }
 
     std::swap(first.m_gameObject, second.m_gameObject);
@@ -273,8 +291,7 @@ void swap(GameObjectPtr &first, GameObjectPtr &second) {
 void swapWithinList(GameObjectPtr &first, GameObjectPtr &second) {
 
     if (second.m_gameObject) {
-        second.m_gameObject->registerPointer(&first);
-        second.m_gameObject->unregisterPointer(&second);
+        second.m_gameObject->replacePointer(&second, &first);
     }
 
     std::swap(first.m_gameObject, second.m_gameObject);
@@ -285,98 +302,81 @@ void swapWithinList(GameObjectPtr &first, GameObjectPtr &second) {
 
 bool GameObjectPtrList::iterator::operator!=(const GameObjectPtrList::iterator &other) const {
 
-    return m_list != other.m_list || m_index != other.m_index;
+    return m_item != other.m_item;
 }
 
 bool GameObjectPtrList::iterator::operator!=(const GameObjectPtrList::const_iterator &other) const {
 
-    return m_list != other.m_list || m_index != other.m_index;
+    return m_item != other.m_item;
 }
 
 GameObjectPtr &GameObjectPtrList::iterator::operator*() const {
 
-    if (!m_list) {
+    if (!m_item) {
         throw GameException(GameException::NullIteratorReference);
     }
-    return m_list->m_items[m_index];
+    return *m_item;
 }
 
 GameObjectPtrList::iterator &GameObjectPtrList::iterator::operator++() {
 
-    m_index++;
-    if (m_index == m_list->m_size && m_list->m_nextList) {
-        m_list = m_list->m_nextList;
-        m_index = 0;
-    }
+    m_item++;
     return *this;
 }
 
 GameObjectPtrList::iterator GameObjectPtrList::iterator::operator++(int) {
 
     GameObjectPtrList::iterator it(*this);
-    m_index++;
-    if (m_index == m_list->m_size && m_list->m_nextList) {
-        m_list = m_list->m_nextList;
-        m_index = 0;
-    }
+    m_item++;
     return it;
 }
 
 bool GameObjectPtrList::iterator::operator==(const GameObjectPtrList::iterator &other) const {
 
-    return m_list == other.m_list && m_index == other.m_index;
+    return m_item == other.m_item;
 }
 
 bool GameObjectPtrList::iterator::operator==(const GameObjectPtrList::const_iterator &other) const {
 
-    return m_list == other.m_list && m_index == other.m_index;
+    return m_item == other.m_item;
 }
 
 
 GameObjectPtrList::const_iterator::const_iterator(const GameObjectPtrList::iterator &other) :
-    m_list(other.m_list),
-    m_index(other.m_index) {
+    m_item(other.m_item) {
 }
 
 bool GameObjectPtrList::const_iterator::operator!=(const GameObjectPtrList::const_iterator &other)
     const {
 
-    return m_list != other.m_list || m_index != other.m_index;
+    return m_item != other.m_item;
 }
 
 const GameObjectPtr &GameObjectPtrList::const_iterator::operator*() const {
 
-    if (!m_list) {
+    if (!m_item) {
         throw GameException(GameException::NullIteratorReference);
     }
-    return m_list->m_items[m_index];
+    return *m_item;
 }
 
 GameObjectPtrList::const_iterator &GameObjectPtrList::const_iterator::operator++() {
 
-    m_index++;
-    if (m_index == m_list->m_size && m_list->m_nextList) {
-        m_list = m_list->m_nextList;
-        m_index = 0;
-    }
+    m_item++;
     return *this;
 }
 
 GameObjectPtrList::const_iterator GameObjectPtrList::const_iterator::operator++(int) {
 
     GameObjectPtrList::const_iterator it(*this);
-    m_index++;
-    if (m_index == m_list->m_size && m_list->m_nextList) {
-        m_list = m_list->m_nextList;
-        m_index = 0;
-    }
+    m_item++;
     return it;
 }
 
 bool GameObjectPtrList::const_iterator::operator==(const GameObjectPtrList::const_iterator &other)
     const {
 
-    return m_list == other.m_list && m_index == other.m_index;
+    return m_item == other.m_item;
 }
 
 
@@ -384,40 +384,25 @@ GameObjectPtrList::GameObjectPtrList() :
     m_size(0),
     m_capacity(0),
     m_items(nullptr),
-    m_nextList(nullptr) {
+    m_indexed(false),
+    m_index(nullptr),
+    m_nameIndexed(false),
+    m_nameIndex(nullptr) {
 }
 
 GameObjectPtrList::GameObjectPtrList(int size) :
-    m_size(0),
-    m_capacity(size),
-    m_items(nullptr),
-    m_nextList(nullptr) {
-
-    if (m_capacity) {
-        m_items = new GameObjectPtr[m_capacity];
+    GameObjectPtrList() {
 
-        for (int i = 0; i < m_capacity; i++) {
-            m_items[i].setOwnerList(this);
-        }
-    }
+    reserve(size);
 }
 
 GameObjectPtrList::GameObjectPtrList(const GameObjectPtrList &other) :
-    m_size(other.length()),
-    m_capacity(other.length()),
-    m_items(nullptr),
-    m_nextList(nullptr) {
-
-    if (m_capacity) {
-        m_items = new GameObjectPtr[m_capacity];
+    GameObjectPtrList() {
 
-        int index = 0;
-        for (const GameObjectPtr &pointer : other) {
-            m_items[index] = pointer;
-            m_items[index].setOwnerList(this);
-            index++;
-        }
-    }
+    // name indexing is not copied, copies are typically short-lived pools that are cheaper to
+    // scan than to index
+    m_indexed = other.m_indexed;
+    append(other);
 }
 
 GameObjectPtrList::GameObjectPtrList(GameObjectPtrList &&other) :
@@ -428,7 +413,8 @@ GameObjectPtrList::GameObjectPtrList(GameObjectPtrList &&other) :
 
 GameObjectPtrList::~GameObjectPtrList() {
 
-    delete m_nextList;
+    delete m_index;
+    delete m_nameIndex;
     delete[] m_items;
 }
 
@@ -438,128 +424,100 @@ void GameObjectPtrList::append(const GameObjectPtr &value) {
         return;
     }
 
-    if (m_capacity) {
-        if (m_size < m_capacity) {
-            m_items[m_size] = value;
-            m_size++;
-        } else {
-            if (!m_nextList) {
-                m_nextList = new GameObjectPtrList(qMax(2 * m_capacity, 16));
-            }
-
-            m_nextList->append(value);
-        }
-    } else {
-        m_size = 1;
-        m_capacity = 16;
+    if (m_size == m_capacity) {
+        grow(qMax(2 * m_capacity, MIN_CAPACITY));
+    }
 
-        m_items = new GameObjectPtr[m_capacity];
+    m_items[m_size] = value;
+    m_size++;
 
-        for (int i = 0; i < m_capacity; i++) {
-            m_items[i].setOwnerList(this);
-        }
+    if (m_index) {
+        (*m_index)[value.m_id]++;
+    } else if (m_indexed && m_size >= MIN_INDEXED_SIZE) {
+        buildIndex();
+    }
 
-        m_items[0] = value;
+    if (m_nameIndex && (!value.m_gameObject || !m_nameIndex->add(value.m_gameObject))) {
+        dropNameIndex();
     }
 }
 
 void GameObjectPtrList::append(const GameObjectPtrList &value) {
 
-    if (value.isEmpty()) {
+    int size = value.m_size;
+    if (size == 0) {
         return;
     }
 
-    reserve(qMax(length() + value.length(), 16));
+    reserve(qMax(m_size + size, MIN_CAPACITY));
 
-    for (const GameObjectPtr &item : value) {
-        append(item);
+    for (int i = 0; i < size; i++) {
+        append(value.m_items[i]);
     }
 }
 
 GameObjectPtrList::iterator GameObjectPtrList::begin() {
 
     GameObjectPtrList::iterator it;
-    it.m_list = this;
-    it.m_index = 0;
+    it.m_item = m_items;
     return it;
 }
 
 GameObjectPtrList::const_iterator GameObjectPtrList::begin() const {
 
     GameObjectPtrList::const_iterator it;
-    it.m_list = const_cast<GameObjectPtrList *>(this);
-    it.m_index = 0;
+    it.m_item = m_items;
     return it;
 }
 
 void GameObjectPtrList::clear() {
 
-    delete m_nextList;
+    delete m_index;
+    delete m_nameIndex;
     delete[] m_items;
 
     m_size = 0;
     m_capacity = 0;
     m_items = nullptr;
-    m_nextList = nullptr;
+    m_index = nullptr;
+    m_nameIndex = nullptr;
 }
 
 GameObjectPtrList::const_iterator GameObjectPtrList::constBegin() const {
 
     GameObjectPtrList::const_iterator it;
-    it.m_list = const_cast<GameObjectPtrList *>(this);
-    it.m_index = 0;
+    it.m_item = m_items;
     return it;
 }
 
 GameObjectPtrList::const_iterator GameObjectPtrList::constEnd() const {
 
-    if (m_nextList) {
-        return m_nextList->constEnd();
-    } else {
-        GameObjectPtrList::const_iterator it;
-        it.m_list = const_cast<GameObjectPtrList *>(this);
-        it.m_index = m_size;
-        return it;
-    }
+    GameObjectPtrList::const_iterator it;
+    it.m_item = m_items + m_size;
+    return it;
 }
 
 bool GameObjectPtrList::contains(const GameObjectPtr &value) const {
 
-    for (int i = 0; i < m_size; i++) {
-        if (m_items[i] == value) {
-            return true;
-        }
+    if (m_index) {
+        return m_index->contains(value.m_id);
     }
 
-    if (m_nextList) {
-        return m_nextList->contains(value);
-    } else {
-        return false;
-    }
+    return indexOf(value) != -1;
 }
 
 GameObjectPtrList::iterator GameObjectPtrList::end() {
 
-    if (m_nextList) {
-        return m_nextList->end();
-    } else {
-        GameObjectPtrList::iterator it;
-        it.m_list = this;
-        it.m_index = m_size;
-        return it;
-    }
+    GameObjectPtrList::iterator it;
+    it.m_item = m_items + m_size;
+    return it;
 }
 
 GameObjectPtrList::const_iterator GameObjectPtrList::end() const {
 
-    if (m_nextList) {
-        return m_nextList->end();
-    } else {
-        GameObjectPtrList::const_iterator it;
-        it.m_list = const_cast<GameObjectPtrList *>(this);
-        it.m_index = m_size;
-        return it;
-    }
+    GameObjectPtrList::const_iterator it;
+    it.m_item = m_items + m_size;
+    return it;
 }
 
 GameObjectPtr &GameObjectPtrList::first() {
@@ -574,34 +532,22 @@ const GameObjectPtr &GameObjectPtrList::first() const {
 
 int GameObjectPtrList::indexOf(const GameObjectPtr &value) const {
 
+    if (m_index && !m_index->contains(value.m_id)) {
+        return -1;
+    }
+
     for (int i = 0; i < m_size; i++) {
         if (m_items[i] == value) {
             return i;
         }
     }
 
-    if (m_nextList) {
-        int index = m_nextList->indexOf(value);
-        if (index != -1) {
-            index += m_size;
-        }
-        return index;
-    } else {
-        return -1;
-    }
+    return -1;
 }
 
 void GameObjectPtrList::insert(const GameObjectPtr &value) {
 
-    for (int i = 0; i < m_size; i++) {
-        if (m_items[i] == value) {
-            return;
-        }
-    }
-
-    if (m_nextList) {
-        m_nextList->insert(value);
-    } else {
+    if (!contains(value)) {
         append(value);
     }
 }
@@ -613,33 +559,25 @@ bool GameObjectPtrList::isEmpty() const {
 
 GameObjectPtr &GameObjectPtrList::last() {
 
-    if (m_nextList) {
-        return m_nextList->last();
-    } else {
-        return m_items[m_size - 1];
-    }
+    return m_items[m_size - 1];
 }
 
 const GameObjectPtr &GameObjectPtrList::last() const {
 
-    if (m_nextList) {
-        return m_nextList->last();
-    } else {
-        return m_items[m_size - 1];
-    }
+    return m_items[m_size - 1];
 }
 
 int GameObjectPtrList::length() const {
 
-    if (m_nextList) {
-        return m_size + m_nextList->length();
-    } else {
-        return m_size;
-    }
+    return m_size;
 }
 
 int GameObjectPtrList::removeAll(const GameObjectPtr &value) {
 
+    if (m_index && !m_index->contains(value.m_id)) {
+        return 0;
+    }
+
     int numRemovals = 0;
     for (int i = 0; i < m_size; i++) {
         if (m_items[i] == value) {
@@ -649,114 +587,137 @@ int GameObjectPtrList::removeAll(const GameObjectPtr &value) {
         }
     }
 
-    if (m_nextList) {
-        numRemovals += m_nextList->removeAll(value);
-    }
-
     return numRemovals;
 }
 
 void GameObjectPtrList::removeAt(int i) {
 
-    if (i < m_size) {
-        m_items[i].setOwnerList(nullptr);
-        m_items[i] = GameObjectPtr();
-        for (int j = i; j < m_size - 1; j++) {
-            swapWithinList(m_items[j], m_items[j + 1]);
-        }
-        m_items[i].setOwnerList(this);
-        if (m_nextList) {
-            m_items[m_size - 1] = m_nextList->m_items[0];
-            m_nextList->removeAt(0);
-        } else {
-            m_size--;
+    if (i < 0 || i >= m_size) {
+        throw GameException(GameException::IndexOutOfBounds,
+                            QString("Index %1 should be within [0,%2)").arg(i).arg(m_size));
+    }
+
+    if (m_index) {
+        QHash<uint, int>::iterator it = m_index->find(m_items[i].m_id);
+        if (it != m_index->end() && --it.value() == 0) {
+            m_index->erase(it);
         }
-    } else {
-        if (m_nextList) {
-            m_nextList->removeAt(i - m_size);
+    }
+
+    if (m_nameIndex) {
+        // pointers to deleted objects can no longer tell which name they were indexed under
+        if (m_items[i].m_gameObject) {
+            m_nameIndex->remove(m_items[i].m_gameObject);
         } else {
-            throw GameException(GameException::IndexOutOfBounds,
-                                QString("Index %1 should be within [0,%2)").arg(i).arg(m_size));
+            dropNameIndex();
         }
     }
 
-    if (m_nextList && m_nextList->m_size == 0) {
-        delete m_nextList;
-        m_nextList = nullptr;
+    m_items[i].setOwnerList(nullptr);
+    m_items[i] = GameObjectPtr();
+    for (int j = i; j < m_size - 1; j++) {
+        swapWithinList(m_items[j], m_items[j + 1]);
     }
+    m_items[i].setOwnerList(this);
+    m_size--;
 }
 
 bool GameObjectPtrList::removeOne(const GameObjectPtr &value) {
 
-    for (int i = 0; i < m_size; i++) {
-        if (m_items[i] == value) {
-            removeAt(i);
-            return true;
-        }
-    }
-
-    if (m_nextList) {
-        return m_nextList->removeOne(value);
-    } else {
+    int index = indexOf(value);
+    if (index == -1) {
         return false;
     }
+
+    removeAt(index);
+    return true;
 }
 
 void GameObjectPtrList::reserve(int size) {
 
-    if (size) {
-        if (m_capacity) {
-            if (m_size >= size) {
-                return;
-            }
-            if (m_size == m_capacity) {
-                if (m_nextList) {
-                    m_nextList->reserve(size - m_size);
-                } else {
-                    m_nextList = new GameObjectPtrList(qMax(2 * m_capacity, m_size - size));
-                }
-            }
-        } else {
-            m_capacity = size;
-            m_items = new GameObjectPtr[m_capacity];
-
-            for (int i = 0; i < m_capacity; i++) {
-                m_items[i].setOwnerList(this);
-            }
-        }
+    if (size > m_capacity) {
+        grow(size);
     }
 }
 
 int GameObjectPtrList::size() const {
 
-    if (m_nextList) {
-        return m_size + m_nextList->size();
-    } else {
-        return m_size;
+    return m_size;
+}
+
+void GameObjectPtrList::setIndexed(bool indexed) {
+
+    m_indexed = indexed;
+
+    if (!m_indexed) {
+        delete m_index;
+        m_index = nullptr;
+    } else if (!m_index && m_size >= MIN_INDEXED_SIZE) {
+        buildIndex();
     }
 }
 
-void swap(GameObjectPtrList &first, GameObjectPtrList &second) {
+void GameObjectPtrList::setNameIndexed(bool nameIndexed) {
 
-    std::swap(first.m_size, second.m_size);
-    std::swap(first.m_capacity, second.m_capacity);
-    std::swap(first.m_items, second.m_items);
-    std::swap(first.m_nextList, second.m_nextList);
+    m_nameIndexed = nameIndexed;
+
+    if (!m_nameIndexed) {
+        dropNameIndex();
+    }
 }
 
-bool GameObjectPtrList::operator!=(const GameObjectPtrList &other) const {
+GameObjectPtrList GameObjectPtrList::objectsByName(const QString &prefix) const {
 
-    if (size() != other.size()) {
-        return true;
+    GameObjectPtrList objects;
+
+    if (m_nameIndexed && m_size >= MIN_INDEXED_SIZE) {
+        if (m_nameIndex && m_nameIndex->nameGeneration() != GameObject::nameGeneration()) {
+            dropNameIndex();
+        }
+        if (!m_nameIndex) {
+            buildNameIndex();
+        }
+        if (m_nameIndex) {
+            for (GameObject *object : m_nameIndex->objectsByName(prefix)) {
+                objects.append(GameObjectPtr(object));
+            }
+            return objects;
+        }
     }
 
-    for (int i = 0; i < size(); i++) {
-        if (operator[](i) != other[i]) {
-            return true;
+    for (int i = 0; i < m_size; i++) {
+        for (const QString &word : NameIndex::nameTokens(m_items[i]->name())) {
+            if (word.startsWith(prefix)) {
+                objects.append(m_items[i]);
+                break;
+            }
         }
     }
+    return objects;
+}
 
-    return false;
+void swap(GameObjectPtrList &first, GameObjectPtrList &second) {
+
+    std::swap(first.m_size, second.m_size);
+    std::swap(first.m_capacity, second.m_capacity);
+    std::swap(first.m_items, second.m_items);
+    std::swap(first.m_indexed, second.m_indexed);
+    std::swap(first.m_index, second.m_index);
+    std::swap(first.m_nameIndexed, second.m_nameIndexed);
+    std::swap(first.m_nameIndex, second.m_nameIndex);
+
+    // the items need to know which list to remove themselves from at the end of their life
+    for (int i = 0; i < first.m_capacity; i++) {
+        first.m_items[i].setOwnerList(&first);
+    }
+    for (int i = 0; i < second.m_capacity; i++) {
+        second.m_items[i].setOwnerList(&second);
+    }
+}
+
+bool GameObjectPtrList::operator!=(const GameObjectPtrList &other) const {
+
+    return !operator==(other);
 }
 
 GameObjectPtrList GameObjectPtrList::operator+(const GameObjectPtrList &other) const {
@@ -770,8 +731,11 @@ GameObjectPtrList GameObjectPtrList::operator+(const GameObjectPtrList &other) c
 
 GameObjectPtrList &GameObjectPtrList::operator=(const GameObjectPtrList &other) {
 
-    clear();
-    append(other);
+    if (&other != this) {
+        clear();
+        append(other);
+    }
+
     return *this;
 }
 
@@ -786,12 +750,12 @@ GameObjectPtrList &GameObjectPtrList::operator=(GameObjectPtrList &&other) {
 
 bool GameObjectPtrList::operator==(const GameObjectPtrList &other) const {
 
-    if (size() != other.size()) {
+    if (m_size != other.m_size) {
         return false;
     }
 
-    for (int i = 0; i < size(); i++) {
-        if (operator[](i) != other[i]) {
+    for (int i = 0; i < m_size; i++) {
+        if (m_items[i] != other.m_items[i]) {
             return false;
         }
     }
@@ -801,16 +765,12 @@ bool GameObjectPtrList::operator==(const GameObjectPtrList &other) const {
 
 const GameObjectPtr &GameObjectPtrList::operator[](int i) const {
 
-    if (i < m_size) {
-        return m_items[i];
-    } else {
-        if (m_nextList) {
-            return (*m_nextList)[i - m_size];
-        } else {
-            throw GameException(GameException::IndexOutOfBounds,
-                                QString("Index %1 should be within [0,%2)").arg(i).arg(m_size));
-        }
+    if (i < 0 || i >= m_size) {
+        throw GameException(GameException::IndexOutOfBounds,
+                            QString("Index %1 should be within [0,%2)").arg(i).arg(m_size));
     }
+
+    return m_items[i];
 }
 
 void GameObjectPtrList::resolvePointers(Realm *realm) {
@@ -823,28 +783,31 @@ void GameObjectPtrList::resolvePointers(Realm *realm) {
             i--;
         }
     }
-    if (m_nextList) {
-        m_nextList->resolvePointers(realm);
-    }
 }
 
 void GameObjectPtrList::unresolvePointers() {
 
+    dropNameIndex();
+
     for (int i = 0; i < m_size; i++) {
         m_items[i].unresolve();
     }
-    if (m_nextList) {
-        m_nextList->unresolvePointers();
-    }
 }
 
 void GameObjectPtrList::send(const QString &message, int color) const {
 
+    send(EncodedMessage(message, color));
+}
+
+void GameObjectPtrList::send(const EncodedMessage &message) const {
+
     for (int i = 0; i < m_size; i++) {
-        m_items[i]->send(message, color);
-    }
-    if (m_nextList) {
-        m_nextList->send(message, color);
+        const GameObjectPtr &item = m_items[i];
+        if (item->isPlayer()) {
+            item.unsafeCast<Player *>()->send(message);
+        } else {
+            item->send(message.message(), message.color());
+        }
     }
 }
 
@@ -897,3 +860,48 @@ void GameObjectPtrList::fromVariant(const QVariant &variant, GameObjectPtrList &
         pointerList.append(pointer);
     }
 }
+
+void GameObjectPtrList::grow(int capacity) {
+
+    GameObjectPtr *items = new GameObjectPtr[capacity];
+    for (int i = 0; i < capacity; i++) {
+        items[i].setOwnerList(this);
+    }
+
+    // moving the pointers only relinks them, there is no need to register them again
+    for (int i = 0; i < m_size; i++) {
+        swapWithinList(items[i], m_items[i]);
+    }
+
+    delete[] m_items;
+
+    m_items = items;
+    m_capacity = capacity;
+}
+
+void GameObjectPtrList::buildIndex() {
+
+    m_index = new QHash<uint, int>();
+    m_index->reserve(m_size);
+    for (int i = 0; i < m_size; i++) {
+        (*m_index)[m_items[i].m_id]++;
+    }
+}
+
+void GameObjectPtrList::buildNameIndex() const {
+
+    m_nameIndex = new NameIndex();
+    for (int i = 0; i < m_size; i++) {
+        if (!m_items[i].m_gameObject || !m_nameIndex->add(m_items[i].m_gameObject)) {
+            // unresolved pointers and duplicates are left to a plain scan
+            dropNameIndex();
+            return;
+        }
+    }
+}
+
+void GameObjectPtrList::dropNameIndex() const {
+
+    delete m_nameIndex;
+    m_nameIndex = nullptr;
+}
@@ -1,6 +1,7 @@
 #ifndef GAMEOBJECTPTR_H
 #define GAMEOBJECTPTR_H
 
+#include <QHash>
 #include <QList>
 #include <QObject>
 #include <QScriptEngine>
@@ -14,8 +15,10 @@
 #include "metatyperegistry.h"
 
 
+class EncodedMessage;
 class GameObject;
 class GameObjectPtrList;
+class NameIndex;
 class Realm;
 
 class GameObjectPtr {
@@ -83,6 +86,9 @@ class GameObjectPtr {
         static QScriptValue toScriptValue(QScriptEngine *engine, const GameObjectPtr &pointer);
         static void fromScriptValue(const QScriptValue &object, GameObjectPtr &pointer);
 
+        friend class GameObject;
+        friend class GameObjectPtrList;
+
         friend void swap(GameObjectPtr &first, GameObjectPtr &second);
         friend void swapWithinList(GameObjectPtr &first, GameObjectPtr &second);
 
@@ -93,6 +99,10 @@ class GameObjectPtr {
         uint m_id;
 
         GameObjectPtrList *m_list;
+
+        // links in the intrusive list of pointers registered with the object
+        GameObjectPtr *m_previous;
+        GameObjectPtr *m_next;
 };
 
 PT_DECLARE_SERIALIZABLE_METATYPE(GameObjectPtr)
@@ -120,8 +130,7 @@ class GameObjectPtrList {
                 bool operator==(const const_iterator &other) const;
 
             private:
-                GameObjectPtrList *m_list;
-                int m_index;
+                GameObjectPtr *m_item;
         };
 
         typedef iterator Iterator;
@@ -145,8 +154,7 @@ class GameObjectPtrList {
                 bool operator==(const const_iterator &other) const;
 
             private:
-                GameObjectPtrList *m_list;
-                int m_index;
+                GameObjectPtr *m_item;
         };
 
         typedef const_iterator ConstIterator;
@@ -207,6 +215,21 @@ class GameObjectPtrList {
 
         int size() const;
 
+        // indexed lists keep a hash of their items once they grow large enough, which makes
+        // membership tests constant-time at the cost of slightly slower appends and removals
+        bool isIndexed() const { return m_indexed; }
+        void setIndexed(bool indexed);
+
+        // name-indexed lists keep an index of the words in the names of their items once they
+        // grow large enough, which is kept up to date as items are added and removed and is
+        // rebuilt when any listed object is renamed
+        bool isNameIndexed() const { return m_nameIndexed; }
+        void setNameIndexed(bool nameIndexed);
+
+        // returns the items with a word in their name starting with the given (lowercase)
+        // prefix, in list order
+        GameObjectPtrList objectsByName(const QString &prefix) const;
+
         friend void swap(GameObjectPtrList &first, GameObjectPtrList &second);
 
         bool operator!=(const GameObjectPtrList &other) const;
@@ -233,6 +256,7 @@ class GameObjectPtrList {
         void unresolvePointers();
 
         void send(const QString &message, int color = Silver) const;
+        void send(const EncodedMessage &message) const;
 
         QString joinFancy(Options options = NoOptions) const;
 
@@ -244,10 +268,20 @@ class GameObjectPtrList {
         static void fromVariant(const QVariant &variant, GameObjectPtrList &pointerList);
 
     private:
+        void grow(int capacity);
+        void buildIndex();
+        void buildNameIndex() const;
+        void dropNameIndex() const;
+
         int m_size;
         int m_capacity;
         GameObjectPtr *m_items;
-        GameObjectPtrList *m_nextList;
+
+        bool m_indexed;
+        QHash<uint, int> *m_index;
+
+        bool m_nameIndexed;
+        mutable NameIndex *m_nameIndex;
 };
 
 PT_DECLARE_SERIALIZABLE_METATYPE(GameObjectPtrList)
@@ -5,6 +5,9 @@
 #include "commandinterpreter.h"
 #include "group.h"
 #include "logutil.h"
+#include "movementsoundevent.h"
+#include "movementvisualevent.h"
+#include "portal.h"
 #include "realm.h"
 #include "room.h"
 #include "util.h"
@@ -19,6 +22,13 @@
 
 #define super StatsItem
 
+static const InternedString OnActive("onactive");
+static const InternedString OnCharacterEntered("oncharacterentered");
+static const InternedString OnCharacterExit("oncharacterexit");
+static const InternedString OnEnter("onenter");
+static const InternedString OnEntered("onentered");
+static const InternedString OnSpawn("onspawn");
+
 Character::Character(Realm *realm, uint id, Options options) :
     Character(realm, GameObjectType::Character, id, options) {
 
@@ -40,11 +50,15 @@ Character::Character(Realm *realm, GameObjectType objectType, uint id, Options o
     m_maxMp(0),
     m_gold(0.0),
     m_effectsTimerId(0),
+    m_actionTimerId(0),
+    m_invokingGo(false),
     m_secondsStunned(0),
     m_stunTimerId(0),
     m_leaveOnActive(false),
     m_regenerationIntervalId(0) {
 
+    m_inventory.setNameIndexed(true);
+
     setAutoDelete(false);
 }
 
@@ -89,6 +103,11 @@ void Character::removeInventoryItem(const GameObjectPtr &item) {
     }
 }
 
+GameObjectPtrList Character::inventoryByName(const QString &prefix) const {
+
+    return m_inventory.objectsByName(prefix);
+}
+
 void Character::setInventory(const GameObjectPtrList &inventory) {
 
     if (m_inventory != inventory) {
@@ -320,6 +339,40 @@ void Character::clearNegativeEffects() {
     }
 }
 
+void Character::setCurrentAction(const QString &currentAction) {
+
+    // scripts may mark a character as busy, or no longer busy, without setting a full action
+    m_currentAction = currentAction;
+}
+
+void Character::setAction(const QString &action, const QScriptValue &options) {
+
+    GameObjectPtr target;
+    int duration = 0;
+    if (options.isObject()) {
+        GameObjectPtr::fromScriptValue(options.property("target"), target);
+        duration = options.property("duration").toInt32();
+    }
+
+    setAction(action, target, duration);
+}
+
+void Character::setAction(const QString &action, const GameObjectPtr &target, int duration) {
+
+    m_currentAction = action;
+    m_target = target;
+
+    if (!m_weapon.isNull() && m_weapon->name() == "binocular") {
+        invokeScriptMethod("remove", m_weapon);
+    }
+
+    if (m_actionTimerId) {
+        realm()->stopTimer(m_actionTimerId);
+    }
+
+    m_actionTimerId = (duration > 0 ? realm()->startTimer(this, duration) : 0);
+}
+
 void Character::enter(const GameObjectPtr &roomPtr) {
 
     try {
@@ -332,7 +385,7 @@ void Character::enter(const GameObjectPtr &roomPtr) {
 
         for (const GameObjectPtr &character : room->characters()) {
             if (character != this) {
-                character->invokeTrigger("oncharacterentered", this);
+                character->invokeTrigger(OnCharacterEntered, this);
             }
         }
     } catch (GameException &exception) {
@@ -350,6 +403,167 @@ void Character::leave(const GameObjectPtr &roomPtr) {
     }
 }
 
+void Character::go(const GameObjectPtr &pointer) {
+
+    if (pointer.isNull()) {
+        return;
+    }
+
+    // scripts can still customize movement, the native implementation is then only used when
+    // the customization calls back into it
+    if (!m_invokingGo && hasScriptMethod("go")) {
+        m_invokingGo = true;
+        invokeScriptMethod("go", pointer);
+        m_invokingGo = false;
+        return;
+    }
+
+    NO_STUN
+
+    try {
+        Room *source = currentRoom().cast<Room *>();
+
+        QString exitName;
+        Room *destination = nullptr;
+        Portal *portal = nullptr;
+
+        if (pointer->isPortal()) {
+            portal = pointer.cast<Portal *>();
+            exitName = portal->nameFromRoom(source);
+            destination = portal->oppositeOf(source).cast<Room *>();
+        } else if (pointer->isRoom()) {
+            for (const GameObjectPtr &potentialPortal : source->portals()) {
+                if (potentialPortal.cast<Portal *>()->oppositeOf(source) == pointer) {
+                    portal = potentialPortal.cast<Portal *>();
+                    exitName = portal->nameFromRoom(source);
+                    break;
+                }
+            }
+            destination = pointer.cast<Room *>();
+        } else {
+            return;
+        }
+
+        GameObjectPtrList characters = source->characters();
+        for (const GameObjectPtr &character : characters) {
+            if (character != this) {
+                if (!character->invokeTrigger(OnCharacterExit, this, exitName)) {
+                    return;
+                }
+            }
+        }
+
+        if (portal) {
+            if (portal->canOpen() && !portal->isOpen()) {
+                send(QString("The %1 is closed.").arg(exitName));
+                return;
+            }
+            if (!portal->invokeTrigger(OnEnter, this)) {
+                return;
+            }
+            if (!portal->canPassThrough()) {
+                send("You cannot go there.");
+                return;
+            }
+        }
+
+        QString action = (m_currentAction == "walk" || m_currentAction == "run" ? "run" : "walk");
+        setAction(action, GameObjectPtr(), 4000);
+
+        GameObjectPtrList followers;
+        if (!m_group.isNull()) {
+            Group *group = m_group.cast<Group *>();
+            if (group->leader() == this) {
+                for (const GameObjectPtr &member : group->members()) {
+                    if (member.cast<Character *>()->currentRoom() != source) {
+                        continue;
+                    }
+
+                    bool blocked = false;
+                    for (const GameObjectPtr &character : characters) {
+                        if (!character->invokeTrigger(OnCharacterExit, this, exitName)) {
+                            blocked = true;
+                            break;
+                        }
+                    }
+                    if (blocked) {
+                        continue;
+                    }
+
+                    if (portal && !portal->invokeTrigger(OnEnter, member)) {
+                        continue;
+                    }
+
+                    followers.append(member);
+                }
+            }
+        }
+
+        Vector3D movement = destination->position() - source->position();
+        Vector3D direction = movement.normalized();
+
+        leave(source);
+        setDirection(direction);
+        enter(destination);
+
+        for (const GameObjectPtr &followerPtr : followers) {
+            Character *follower = followerPtr.cast<Character *>();
+            follower->leave(source);
+            follower->setDirection(direction);
+            follower->enter(destination);
+            follower->send(QString("You follow %1.").arg(name()));
+        }
+
+        GameObjectPtrList party;
+        party.append(this);
+        party.append(followers);
+
+        QString simplePresent = (followers.isEmpty() ? action + "s" : action);
+        QString continuous = QString(followers.isEmpty() ? "is" : "are") + " " +
+                             (action == "walk" ? "walking" : "running");
+
+        MovementVisualEvent *visualEvent = new MovementVisualEvent(source, 1.0);
+        visualEvent->setSubject(followers.isEmpty() ? GameObjectPtr(this) : m_group);
+        visualEvent->setDestination(destination);
+        visualEvent->setMovement(movement);
+        visualEvent->setDirection(direction);
+        visualEvent->setVerb(simplePresent, continuous);
+        visualEvent->setExcludedCharacters(party);
+        visualEvent->fire();
+
+        if (m_race.isNull() || m_race->name() != "animal") {
+            double soundStrength = (action == "walk" ? 1.0 : 3.0);
+            QString soundDescription = "someone";
+
+            if (!followers.isEmpty()) {
+                soundDescription = "some people";
+                for (int i = 0; i < followers.length(); i++) {
+                    soundStrength += qMax(0.8 - 0.2 * i, 0.3);
+                }
+            }
+
+            MovementSoundEvent *soundEvent = new MovementSoundEvent(source, soundStrength);
+            soundEvent->setDescription(soundDescription);
+            soundEvent->setDistantDescription(soundDescription);
+            soundEvent->setVeryDistantDescription(soundDescription);
+            soundEvent->setDestination(destination);
+            soundEvent->setMovement(movement);
+            soundEvent->setDirection(direction);
+            soundEvent->setVerb(simplePresent, continuous);
+            soundEvent->setExcludedCharacters(party + visualEvent->affectedCharacters());
+            soundEvent->fire();
+        }
+
+        if (isPlayer()) {
+            LogUtil::countRoomVisit(QString("%1(name = \"%2\")")
+                                    .arg(destination->objectType().toString(), destination->name()),
+                                    1 + followers.length());
+        }
+    } catch (GameException &exception) {
+        LogUtil::logError("Exception in Character::go(): %1", exception.what());
+    }
+}
+
 void Character::follow(const GameObjectPtr &characterPtr) {
 
     try {
@@ -534,7 +748,7 @@ void Character::init() {
 
         super::init();
 
-        invokeTrigger("onspawn");
+        invokeTrigger(OnSpawn);
     } catch (GameException &exception) {
         LogUtil::logError("Exception in Character::init(): %1", exception.what());
     }
@@ -564,6 +778,9 @@ void Character::invokeTimer(int timerId) {
     if (timerId == m_effectsTimerId) {
         int nextTimeout = updateEffects(QDateTime::currentMSecsSinceEpoch());
         m_effectsTimerId = (nextTimeout > -1 ? realm()->startTimer(this, nextTimeout) : 0);
+    } else if (timerId == m_actionTimerId) {
+        m_currentAction = "";
+        m_actionTimerId = 0;
     } else if (timerId == m_stunTimerId) {
         m_secondsStunned--;
 
@@ -576,7 +793,7 @@ void Character::invokeTimer(int timerId) {
                 leave(currentRoom());
                 m_leaveOnActive = false;
             } else {
-                invokeTrigger("onactive");
+                invokeTrigger(OnActive);
             }
         }
     } else if (timerId == m_regenerationIntervalId) {
@@ -592,6 +809,11 @@ void Character::killAllTimers() {
 
     clearEffects();
 
+    if (m_actionTimerId) {
+        realm()->stopTimer(m_actionTimerId);
+        m_actionTimerId = 0;
+    }
+
     m_secondsStunned = 0;
     if (m_stunTimerId) {
         realm()->stopTimer(m_stunTimerId);
@@ -612,7 +834,7 @@ void Character::changeName(const QString &newName) {
 
 void Character::enteredRoom() {
 
-    invokeTrigger("onentered");
+    invokeTrigger(OnEntered);
     invokeScriptMethod("enteredRoom");
 }
 
@@ -1,6 +1,7 @@
 #ifndef CHARACTER_H
 #define CHARACTER_H
 
+#include <QScriptValue>
 #include <QString>
 
 #include "effect.h"
@@ -35,6 +36,7 @@ class Character : public StatsItem {
         Q_INVOKABLE void removeInventoryItem(const GameObjectPtr &item);
         void setInventory(const GameObjectPtrList &inventory);
         Q_PROPERTY(GameObjectPtrList inventory READ inventory WRITE setInventory)
+        Q_INVOKABLE GameObjectPtrList inventoryByName(const QString &prefix) const;
 
         const GameObjectPtrList &sellableItems() const { return m_sellableItems; }
         Q_INVOKABLE void addSellableItem(const GameObjectPtr &item);
@@ -112,9 +114,22 @@ class Character : public StatsItem {
         Q_INVOKABLE void clearNegativeEffects();
         Q_PROPERTY(EffectList effects READ effects STORED false)
 
+        const QString &currentAction() const { return m_currentAction; }
+        void setCurrentAction(const QString &currentAction);
+        Q_PROPERTY(QString currentAction READ currentAction WRITE setCurrentAction STORED false)
+
+        const GameObjectPtr &target() const { return m_target; }
+        Q_PROPERTY(GameObjectPtr target READ target STORED false)
+
+        Q_INVOKABLE void setAction(const QString &action,
+                                   const QScriptValue &options = QScriptValue());
+        void setAction(const QString &action, const GameObjectPtr &target, int duration = 0);
+
         Q_INVOKABLE void enter(const GameObjectPtr &roomPtr);
         Q_INVOKABLE void leave(const GameObjectPtr &roomPtr);
 
+        Q_INVOKABLE void go(const GameObjectPtr &pointer);
+
         Q_INVOKABLE void follow(const GameObjectPtr &character);
         Q_INVOKABLE void lose(const GameObjectPtr &character = GameObjectPtr());
         Q_INVOKABLE void disband();
@@ -172,6 +187,11 @@ class Character : public StatsItem {
         EffectList m_effects;
         int m_effectsTimerId;
 
+        QString m_currentAction;
+        GameObjectPtr m_target;
+        int m_actionTimerId;
+        bool m_invokingGo;
+
         int m_secondsStunned;
         int m_stunTimerId;
         bool m_leaveOnActive;
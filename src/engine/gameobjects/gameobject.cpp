@@ -15,6 +15,7 @@
 
 #include "area.h"
 #include "character.h"
+#include "characterstats.h"
 #include "class.h"
 #include "container.h"
 #include "conversionutil.h"
@@ -36,19 +37,168 @@
 #include "scriptengine.h"
 #include "shield.h"
 #include "util.h"
+#include "vector3d.h"
 #include "weapon.h"
 
 
 QMap<QString, QScriptValue> GameObject::s_prototypeMap = QMap<QString, QScriptValue>();
 
+uint GameObject::s_nameGeneration = 0;
+
+
+static const InternedString OnInit("oninit");
 
-static int GameEventMultiplierMapType;
 static int GameObjectPtrType;
 static int GameObjectPtrListType;
-static int Point3DType;
 static int ScriptFunctionMapType;
 
 
+// these go through moc's property dispatch, not through direct calls to the typed getter and
+// setter, but they avoid boxing the value in a QVariant
+template<class T>
+static T readProperty(const GameObject *object, const GameObject::PropertyDescriptor &property) {
+
+    T value = T();
+    void *argv[] = { &value };
+    const_cast<GameObject *>(object)->qt_metacall(QMetaObject::ReadProperty, property.index, argv);
+    return value;
+}
+
+template<class T>
+static void writeProperty(GameObject *object, const GameObject::PropertyDescriptor &property,
+                          T &value) {
+
+    int status = -1;
+    int flags = 0;
+    void *argv[] = { &value, nullptr, &status, &flags };
+    object->qt_metacall(QMetaObject::WriteProperty, property.index, argv);
+}
+
+template<class T>
+static void copyTypedProperty(const GameObject *source, GameObject *destination,
+                              const GameObject::PropertyDescriptor &property) {
+
+    T value = readProperty<T>(source, property);
+    writeProperty(destination, property, value);
+}
+
+static void copyVariantProperty(const GameObject *source, GameObject *destination,
+                                const GameObject::PropertyDescriptor &property) {
+
+    property.metaProperty.write(destination, property.metaProperty.read(source));
+}
+
+template<class T>
+static QString serializableToJsonString(const GameObject *object,
+                                        const GameObject::PropertyDescriptor &property,
+                                        Options options) {
+
+    Q_UNUSED(options)
+
+    return T::toJsonString(readProperty<T>(object, property));
+}
+
+static QString boolToJsonString(const GameObject *object,
+                                const GameObject::PropertyDescriptor &property, Options options) {
+
+    Q_UNUSED(options)
+
+    return readProperty<bool>(object, property) ? "true" : "false";
+}
+
+static QString intToJsonString(const GameObject *object,
+                               const GameObject::PropertyDescriptor &property, Options options) {
+
+    Q_UNUSED(options)
+
+    return QString::number(readProperty<int>(object, property));
+}
+
+static QString doubleToJsonString(const GameObject *object,
+                                  const GameObject::PropertyDescriptor &property, Options options) {
+
+    Q_UNUSED(options)
+
+    return QString::number(readProperty<double>(object, property));
+}
+
+static QString stringToJsonString(const GameObject *object,
+                                  const GameObject::PropertyDescriptor &property, Options options) {
+
+    Q_UNUSED(options)
+
+    QString string = readProperty<QString>(object, property);
+    return string.isEmpty() ? QString() : ConversionUtil::jsString(string);
+}
+
+static QString variantToJsonString(const GameObject *object,
+                                   const GameObject::PropertyDescriptor &property,
+                                   Options options) {
+
+    return ConversionUtil::toJsonString(property.metaProperty.read(object), options);
+}
+
+static GameObject::PropertyDescriptor describeProperty(const QMetaProperty &metaProperty) {
+
+    GameObject::PropertyDescriptor property;
+    property.metaProperty = metaProperty;
+    property.name = metaProperty.name();
+    property.index = metaProperty.propertyIndex();
+    property.userType = metaProperty.userType();
+    property.toJsonString = variantToJsonString;
+    property.fromJsonVariant = nullptr;
+    property.copy = copyVariantProperty;
+
+    int userType = property.userType;
+    if (userType == QMetaType::Bool) {
+        property.toJsonString = boolToJsonString;
+        property.copy = copyTypedProperty<bool>;
+    } else if (userType == QMetaType::Int) {
+        property.toJsonString = intToJsonString;
+        property.copy = copyTypedProperty<int>;
+    } else if (userType == QMetaType::Double) {
+        property.toJsonString = doubleToJsonString;
+        property.copy = copyTypedProperty<double>;
+    } else if (userType == QMetaType::QString) {
+        property.toJsonString = stringToJsonString;
+        property.copy = copyTypedProperty<QString>;
+    } else if (userType == QMetaType::QVariantMap) {
+        property.copy = copyTypedProperty<QVariantMap>;
+    } else if (userType == qMetaTypeId<CharacterStats>()) {
+        property.toJsonString = serializableToJsonString<CharacterStats>;
+        property.copy = copyTypedProperty<CharacterStats>;
+    } else if (userType == qMetaTypeId<GameEventMultiplierMap>()) {
+        property.toJsonString = serializableToJsonString<GameEventMultiplierMap>;
+        property.copy = copyTypedProperty<GameEventMultiplierMap>;
+    } else if (userType == qMetaTypeId<GameObjectPtr>()) {
+        property.toJsonString = serializableToJsonString<GameObjectPtr>;
+        property.copy = copyTypedProperty<GameObjectPtr>;
+    } else if (userType == qMetaTypeId<GameObjectPtrList>()) {
+        property.toJsonString = serializableToJsonString<GameObjectPtrList>;
+        property.copy = copyTypedProperty<GameObjectPtrList>;
+    } else if (userType == qMetaTypeId<Point3D>()) {
+        property.toJsonString = serializableToJsonString<Point3D>;
+        property.copy = copyTypedProperty<Point3D>;
+    } else if (userType == qMetaTypeId<ScriptFunctionMap>()) {
+        property.toJsonString = serializableToJsonString<ScriptFunctionMap>;
+        property.copy = copyTypedProperty<ScriptFunctionMap>;
+    } else if (userType == qMetaTypeId<Vector3D>()) {
+        property.toJsonString = serializableToJsonString<Vector3D>;
+        property.copy = copyTypedProperty<Vector3D>;
+    }
+
+    if (metaProperty.type() == QVariant::UserType) {
+        const char *typeName = QMetaType::typeName(userType);
+        if (typeName) {
+            property.fromJsonVariant =
+                    MetaTypeRegistry::jsonConverters(typeName).jsonVariantToTypeConverter;
+        }
+    }
+
+    return property;
+}
+
+
 GameObject::GameObject(Realm *realm, GameObjectType objectType, uint id, Options options) :
     QObject(),
     m_realm(realm),
@@ -56,6 +206,11 @@ GameObject::GameObject(Realm *realm, GameObjectType objectType, uint id, Options
     m_id(id),
     m_options((Options) (options & Copy ? options : options | AutoDelete)),
     m_deleted(false),
+    m_pointers(nullptr),
+    m_previousOfType(nullptr),
+    m_nextOfType(nullptr),
+    m_prototype(nullptr),
+    m_hasInstances(false),
     m_intervalHash(nullptr),
     m_timeoutHash(nullptr) {
 
@@ -70,10 +225,8 @@ GameObject::GameObject(Realm *realm, GameObjectType objectType, uint id, Options
         }
     } else {
         if (m_id == 0) {
-            GameEventMultiplierMapType = QMetaType::type("GameEventMultiplierMap");
             GameObjectPtrType = QMetaType::type("GameObjectPtr");
             GameObjectPtrListType = QMetaType::type("GameObjectPtrList");
-            Point3DType = QMetaType::type("Point3D");
             ScriptFunctionMapType = QMetaType::type("ScriptFunctionMap");
         }
     }
@@ -85,14 +238,27 @@ GameObject::~GameObject() {
         m_realm->unregisterObject(this);
     }
 
-    for (GameObjectPtr *pointer : m_pointers) {
+    delete m_prototype;
+
+    while (m_pointers) {
+        GameObjectPtr *pointer = m_pointers;
+        m_pointers = pointer->m_next;
+        if (m_pointers) {
+            m_pointers->m_previous = nullptr;
+        }
+        pointer->m_next = nullptr;
+
         pointer->unresolve(EndOfLife);
     }
-    m_pointers.clear();
 
     killAllTimers();
 }
 
+GameObject *GameObject::prototype() const {
+
+    return m_prototype ? m_prototype->unsafeCast<GameObject *>() : nullptr;
+}
+
 bool GameObject::isArea() const {
 
     return m_objectType == GameObjectType::Area;
@@ -171,13 +337,19 @@ bool GameObject::hasStats() const {
 
 void GameObject::setName(const QString &name) {
 
-    if (m_name != name) {
-        m_name = name;
+    InternedString internedName(name);
+    if (m_name != internedName) {
+        m_name = internedName;
 
-        setObjectName(name);
+        setObjectName(m_name.toString());
         setModified();
 
-        changeName(m_name);
+        // naming a fresh object should not invalidate the name indices of every list
+        if (isListed()) {
+            s_nameGeneration++;
+        }
+
+        changeName(m_name.toString());
     }
 }
 
@@ -190,7 +362,7 @@ QString GameObject::definiteName(const GameObjectPtrList &pool, int options) con
             int position = 0;
             int total = 0;
             for (const GameObjectPtr &other : pool) {
-                if (other->name() == name()) {
+                if (other->m_name == m_name) {
                     total++;
 
                     if (other->id() == id()) {
@@ -205,7 +377,7 @@ QString GameObject::definiteName(const GameObjectPtrList &pool, int options) con
         }
     } catch (GameException &exception) {
         LogUtil::logError("Exception in GameObject::definiteName(): %1", exception.what());
-        return m_name;
+        return name();
     }
 }
 
@@ -217,15 +389,16 @@ QString GameObject::indefiniteName(int options) const {
                static_cast<const Item *>(this)->flags() & ItemFlags::AlwaysUseDefiniteArticle) {
         return (options & Capitalized ? "The " : "the ") + name();
     } else {
-        return (options & Capitalized ? Util::capitalize(m_indefiniteArticle) :
-                                        m_indefiniteArticle) + " " + name();
+        return (options & Capitalized ? Util::capitalize(indefiniteArticle()) :
+                                        indefiniteArticle()) + " " + name();
     }
 }
 
 void GameObject::setPlural(const QString &plural) {
 
-    if (m_plural != plural) {
-        m_plural = plural;
+    InternedString internedPlural(plural);
+    if (m_plural != internedPlural) {
+        m_plural = internedPlural;
 
         setModified();
     }
@@ -233,8 +406,9 @@ void GameObject::setPlural(const QString &plural) {
 
 void GameObject::setIndefiniteArticle(const QString &indefiniteArticle) {
 
-    if (m_indefiniteArticle != indefiniteArticle) {
-        m_indefiniteArticle = indefiniteArticle;
+    InternedString internedArticle(indefiniteArticle);
+    if (m_indefiniteArticle != internedArticle) {
+        m_indefiniteArticle = internedArticle;
 
         setModified();
     }
@@ -251,95 +425,179 @@ void GameObject::setDescription(const QString &description) {
 
 void GameObject::setData(const QVariantMap &data) {
 
-    if (m_data != data) {
-        m_data = data;
+    DataMap dataMap = DataMap::fromVariantMap(data);
+    if (m_data != dataMap) {
+        m_data = dataMap;
 
         setModified();
     }
 }
 
-void GameObject::setBoolData(const QString &name, bool value) {
+QVariant GameObject::dataValue(const InternedString &name) const {
+
+    return m_data.value(name);
+}
 
-    if (!m_data.contains(name) || m_data[name].type() != QVariant::Bool ||
-        m_data[name].toBool() != value) {
-        m_data[name] = value;
+bool GameObject::boolData(const InternedString &name) const {
 
+    return m_data.boolValue(name);
+}
+
+int GameObject::intData(const InternedString &name) const {
+
+    return m_data.intValue(name);
+}
+
+double GameObject::doubleData(const InternedString &name) const {
+
+    return m_data.doubleValue(name);
+}
+
+QString GameObject::stringData(const InternedString &name) const {
+
+    return m_data.value(name).toString();
+}
+
+void GameObject::setBoolData(const InternedString &name, bool value) {
+
+    if (m_data.setBool(name, value)) {
         setModified();
     }
 }
 
-void GameObject::setIntData(const QString &name, int value) {
-
-    if (!m_data.contains(name) || m_data[name].type() != QVariant::Int ||
-        m_data[name].toInt() != value) {
-        m_data[name] = value;
+void GameObject::setIntData(const InternedString &name, int value) {
 
+    if (m_data.setInt(name, value)) {
         setModified();
     }
 }
 
-void GameObject::setStringData(const QString &name, const QString &value) {
+void GameObject::setDoubleData(const InternedString &name, double value) {
 
-    if (!m_data.contains(name) || m_data[name].type() != QVariant::String ||
-        m_data[name].toString() != value) {
-        m_data[name] = value;
+    if (m_data.setDouble(name, value)) {
+        setModified();
+    }
+}
+
+void GameObject::setStringData(const InternedString &name, const QString &value) {
 
+    if (m_data.setValue(name, value)) {
         setModified();
     }
 }
 
-void GameObject::setGameObjectData(const QString &name, const GameObjectPtr &value) {
+void GameObject::setGameObjectData(const InternedString &name, const GameObjectPtr &value) {
 
-    if (!m_data.contains(name) || m_data[name].type() != QVariant::UserType ||
-        m_data[name].userType() != GameObjectPtrType ||
-        m_data[name].value<GameObjectPtr>() != value) {
-        m_data[name] = QVariant::fromValue(value);
+    QVariant current = m_data.value(name);
+    if (current.userType() != GameObjectPtrType || current.value<GameObjectPtr>() != value) {
+        m_data.setValue(name, QVariant::fromValue(value));
 
         setModified();
     }
 }
 
-void GameObject::setGameObjectListData(const QString &name, const GameObjectPtrList &value) {
+void GameObject::setGameObjectListData(const InternedString &name,
+                                       const GameObjectPtrList &value) {
 
-    if (!m_data.contains(name) || m_data[name].type() != QVariant::UserType ||
-        m_data[name].userType() != GameObjectPtrListType ||
-        m_data[name].value<GameObjectPtrList>() != value) {
-        m_data[name] = QVariant::fromValue(value);
+    QVariant current = m_data.value(name);
+    if (current.userType() != GameObjectPtrListType ||
+        current.value<GameObjectPtrList>() != value) {
+        m_data.setValue(name, QVariant::fromValue(value));
 
         setModified();
     }
 }
 
-void GameObject::setTrigger(const QString &name, const ScriptFunction &function) {
+ScriptFunctionMap GameObject::triggers() const {
+
+    ScriptFunctionMap triggers;
+    GameObject *prototype = this->prototype();
+    if (prototype) {
+        for (auto it = prototype->m_triggers.constBegin();
+             it != prototype->m_triggers.constEnd(); ++it) {
+            triggers.insert(it.key(), it.value());
+        }
+    }
+    for (auto it = m_triggers.constBegin(); it != m_triggers.constEnd(); ++it) {
+        if (it.value().source.isEmpty()) {
+            triggers.remove(it.key());
+        } else {
+            triggers.insert(it.key(), it.value());
+        }
+    }
+    return triggers;
+}
+
+ScriptFunction GameObject::trigger(const InternedString &name) const {
 
-    if (!m_triggers.contains(name) || m_triggers[name] != function) {
+    const ScriptFunction *function = findTrigger(name);
+    return function ? *function : ScriptFunction();
+}
+
+bool GameObject::hasTrigger(const InternedString &name) const {
+
+    return findTrigger(name) != nullptr;
+}
+
+void GameObject::setTrigger(const InternedString &name, const ScriptFunction &function) {
+
+    auto it = m_triggers.find(name);
+    if (it == m_triggers.end()) {
         m_triggers.insert(name, function);
 
+        setModified();
+    } else if (it.value() != function) {
+        it.value() = function;
+
         setModified();
     }
 }
 
-void GameObject::unsetTrigger(const QString &name) {
+void GameObject::unsetTrigger(const InternedString &name) {
 
-    if (m_triggers.remove(name) > 0) {
+    // a trigger inherited from the prototype is masked by an empty override
+    GameObject *prototype = this->prototype();
+    if (prototype && prototype->m_triggers.contains(name)) {
+        setTrigger(name, ScriptFunction());
+    } else if (m_triggers.remove(name) > 0) {
         setModified();
     }
 }
 
 void GameObject::setTriggers(const ScriptFunctionMap &triggers) {
 
-    if (m_triggers != triggers) {
-        m_triggers = triggers;
+    QHash<InternedString, ScriptFunction> internedTriggers;
+    for (auto it = triggers.constBegin(); it != triggers.constEnd(); ++it) {
+        internedTriggers.insert(it.key(), it.value());
+    }
+
+    // instances only keep the triggers that differ from those of their prototype
+    GameObject *prototype = this->prototype();
+    if (prototype) {
+        for (auto it = prototype->m_triggers.constBegin();
+             it != prototype->m_triggers.constEnd(); ++it) {
+            auto instanceIt = internedTriggers.find(it.key());
+            if (instanceIt == internedTriggers.end()) {
+                internedTriggers.insert(it.key(), ScriptFunction());
+            } else if (instanceIt.value() == it.value()) {
+                internedTriggers.erase(instanceIt);
+            }
+        }
+    }
+
+    if (m_triggers != internedTriggers) {
+        m_triggers = internedTriggers;
 
         setModified();
     }
 }
 
-bool GameObject::invokeTrigger(const QString &name,
+bool GameObject::invokeTrigger(const InternedString &name,
                                const QScriptValue &arg1, const QScriptValue &arg2,
                                const QScriptValue &arg3, const QScriptValue &arg4) {
 
-    if (!m_triggers.contains(name)) {
+    const ScriptFunction *function = findTrigger(name);
+    if (!function) {
         return true;
     }
 
@@ -361,7 +619,7 @@ bool GameObject::invokeTrigger(const QString &name,
     }
 
     ScriptEngine *engine = m_realm->scriptEngine();
-    QScriptValue returnValue = engine->executeFunction(m_triggers[name], this, arguments);
+    QScriptValue returnValue = engine->executeFunction(*function, this, arguments);
     if (returnValue.isBool()) {
         return returnValue.toBool();
     } else {
@@ -369,79 +627,125 @@ bool GameObject::invokeTrigger(const QString &name,
     }
 }
 
-bool GameObject::invokeTrigger(const QString &triggerName,
+bool GameObject::invokeTrigger(const InternedString &triggerName,
                                GameObject *arg1, const GameObjectPtr &arg2,
                                const QScriptValue &arg3, const QScriptValue &arg4) {
 
+    if (!hasTrigger(triggerName)) {
+        return true;
+    }
+
     ScriptEngine *engine = m_realm->scriptEngine();
     return invokeTrigger(triggerName,
                          engine->toScriptValue(arg1), engine->toScriptValue(arg2), arg3, arg4);
 }
 
-bool GameObject::invokeTrigger(const QString &triggerName,
+bool GameObject::invokeTrigger(const InternedString &triggerName,
                                GameObject *arg1, const GameObjectPtrList &arg2,
                                const QScriptValue &arg3, const QScriptValue &arg4) {
 
+    if (!hasTrigger(triggerName)) {
+        return true;
+    }
+
     ScriptEngine *engine = m_realm->scriptEngine();
     return invokeTrigger(triggerName,
                          engine->toScriptValue(arg1), engine->toScriptValue(arg2), arg3, arg4);
 }
 
-bool GameObject::invokeTrigger(const QString &triggerName,
+bool GameObject::invokeTrigger(const InternedString &triggerName,
                                GameObject *arg1, const GameObjectPtr &arg2,
                                const GameObjectPtrList &arg3, const QScriptValue &arg4) {
 
+    if (!hasTrigger(triggerName)) {
+        return true;
+    }
+
     ScriptEngine *engine = m_realm->scriptEngine();
     return invokeTrigger(triggerName,
                          engine->toScriptValue(arg1), engine->toScriptValue(arg2),
                          engine->toScriptValue(arg3), arg4);
 }
 
-bool GameObject::invokeTrigger(const QString &triggerName,
+bool GameObject::invokeTrigger(const InternedString &triggerName,
                                GameObject *arg1, const QScriptValue &arg2,
                                const QScriptValue &arg3, const QScriptValue &arg4) {
 
+    if (!hasTrigger(triggerName)) {
+        return true;
+    }
+
     ScriptEngine *engine = m_realm->scriptEngine();
     return invokeTrigger(triggerName, engine->toScriptValue(arg1), arg2, arg3, arg4);
 }
 
-bool GameObject::invokeTrigger(const QString &triggerName,
+bool GameObject::invokeTrigger(const InternedString &triggerName,
                                const GameObjectPtr &arg1, const GameObjectPtr &arg2,
                                const QScriptValue &arg3, const QScriptValue &arg4) {
 
+    if (!hasTrigger(triggerName)) {
+        return true;
+    }
+
     ScriptEngine *engine = m_realm->scriptEngine();
     return invokeTrigger(triggerName,
                          engine->toScriptValue(arg1), engine->toScriptValue(arg2), arg3, arg4);
 }
 
-bool GameObject::invokeTrigger(const QString &triggerName,
+bool GameObject::invokeTrigger(const InternedString &triggerName,
                                const GameObjectPtr &arg1, const QScriptValue &arg2,
                                const QScriptValue &arg3, const QScriptValue &arg4) {
 
+    if (!hasTrigger(triggerName)) {
+        return true;
+    }
+
     ScriptEngine *engine = m_realm->scriptEngine();
     return invokeTrigger(triggerName, engine->toScriptValue(arg1), arg2, arg3, arg4);
 }
 
+const ScriptFunction *GameObject::findTrigger(const InternedString &name) const {
+
+    auto it = m_triggers.constFind(name);
+    if (it != m_triggers.constEnd()) {
+        return it.value().source.isEmpty() ? nullptr : &it.value();
+    }
+
+    // instances share the triggers of their prototype, unless they override or mask them
+    GameObject *prototype = this->prototype();
+    if (prototype) {
+        it = prototype->m_triggers.constFind(name);
+        if (it != prototype->m_triggers.constEnd()) {
+            return &it.value();
+        }
+    }
+    return nullptr;
+}
+
 bool GameObject::hasScriptMethod(const QString &methodName) {
 
-    ScriptEngine *engine = m_realm->scriptEngine();
-    QScriptValue scriptObject = engine->toScriptValue(this);
+    // all objects of the same class share their prototype, so there's no need to create a
+    // script object for this object once the prototype is known
+    QString className(metaObject()->className());
+    if (!s_prototypeMap.contains(className)) {
+        m_realm->scriptEngine()->toScriptValue(this);
+    }
 
-    QScriptValue method = scriptObject.prototype().property(methodName);
-    return method.isFunction();
+    return s_prototypeMap[className].property("prototype").property(methodName).isFunction();
 }
 
 QScriptValue GameObject::invokeScriptMethod(const QString &methodName,
                                             const QScriptValue &arg1, const QScriptValue &arg2,
                                             const QScriptValue &arg3, const QScriptValue &arg4) {
 
+    if (!hasScriptMethod(methodName)) {
+        return QScriptValue();
+    }
+
     ScriptEngine *engine = m_realm->scriptEngine();
     QScriptValue scriptObject = engine->toScriptValue(this);
 
     QScriptValue method = scriptObject.prototype().property(methodName);
-    if (!method.isFunction()) {
-        return QScriptValue();
-    }
 
     QScriptValueList arguments;
     if (arg1.isValid()) {
@@ -475,6 +779,10 @@ QScriptValue GameObject::invokeScriptMethod(const QString &methodName,
                                             const QScriptValue &arg3,
                                             const QScriptValue &arg4) {
 
+    if (!hasScriptMethod(methodName)) {
+        return QScriptValue();
+    }
+
     ScriptEngine *engine = m_realm->scriptEngine();
     return invokeScriptMethod(methodName, engine->toScriptValue(arg1), arg2, arg3, arg4);
 }
@@ -485,6 +793,10 @@ QScriptValue GameObject::invokeScriptMethod(const QString &methodName,
                                             const QScriptValue &arg3,
                                             const QScriptValue &arg4) {
 
+    if (!hasScriptMethod(methodName)) {
+        return QScriptValue();
+    }
+
     ScriptEngine *engine = m_realm->scriptEngine();
     return invokeScriptMethod(methodName, engine->toScriptValue(arg1), arg2, arg3, arg4);
 }
@@ -635,16 +947,30 @@ void GameObject::killAllTimers() {
 
 void GameObject::init() {
 
-    invokeTrigger("oninit");
+    invokeTrigger(OnInit);
 }
 
 GameObject *GameObject::copy() {
 
     GameObject *object = GameObject::createByObjectType(realm(), objectType());
-    for (const QMetaProperty &metaProperty : storedMetaProperties()) {
-        const char *name = metaProperty.name();
-        object->setProperty(name, property(name));
+    for (const PropertyDescriptor &property : storedProperties()) {
+        if (property.userType != ScriptFunctionMapType) {
+            property.copy(this, object, property);
+        }
     }
+
+    // copies become instances of the same prototype, so that triggers are shared rather than
+    // duplicated, objects that are never saved cannot act as prototype
+    if (m_prototype) {
+        object->m_prototype = new GameObjectPtr(*m_prototype);
+        object->m_triggers = m_triggers;
+    } else if (~m_options & DontSave) {
+        object->m_prototype = new GameObjectPtr(this);
+        m_hasInstances = true;
+    } else {
+        object->m_triggers = m_triggers;
+    }
+
     object->init();
     return object;
 }
@@ -659,6 +985,10 @@ void GameObject::setDeleted() {
     if (~m_options & Copy && ~m_options & NeverDelete && !m_deleted) {
         m_deleted = true;
 
+        if (m_hasInstances) {
+            detachInstances();
+        }
+
         if (m_options & DontSave) {
             m_realm->enqueueEvent(new DeleteObjectEvent(m_id));
         } else {
@@ -667,19 +997,69 @@ void GameObject::setDeleted() {
     }
 }
 
+void GameObject::detachInstances() {
+
+    // instances of a deleted prototype become standalone objects, so they take over the
+    // triggers they don't override
+    for (GameObject *object : m_realm->allObjects(m_objectType)) {
+        if (!object->m_prototype || object->prototype() != this) {
+            continue;
+        }
+
+        for (auto it = m_triggers.constBegin(); it != m_triggers.constEnd(); ++it) {
+            if (!object->m_triggers.contains(it.key())) {
+                object->m_triggers.insert(it.key(), it.value());
+            }
+        }
+        for (auto it = object->m_triggers.begin(); it != object->m_triggers.end();) {
+            if (it.value().source.isEmpty()) {
+                it = object->m_triggers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        delete object->m_prototype;
+        object->m_prototype = nullptr;
+
+        object->setModified();
+    }
+
+    m_hasInstances = false;
+}
+
 QString GameObject::toJsonString(Options options) const {
 
     QStringList dumpedProperties;
     if (~options & SkipId) {
         dumpedProperties.append(QString("  \"id\": %1").arg(m_id));
     }
-    for (const QMetaProperty &metaProperty : storedMetaProperties()) {
-        const char *name = metaProperty.name();
 
-        QString jsonString = ConversionUtil::toJsonString(property(name),
-                                                          (Options) (options & IncludeTypeInfo));
+    // instances are saved in full, the prototype may still change after an instance was last
+    // saved, and only triggers are looked up through it at runtime
+    if (m_prototype) {
+        dumpedProperties.append(QString("  \"prototype\": %1")
+                                .arg(GameObjectPtr::toJsonString(*m_prototype)));
+    }
+
+    for (const PropertyDescriptor &property : storedProperties()) {
+        QString jsonString;
+        if (m_prototype && property.userType == ScriptFunctionMapType) {
+            // instances save only the triggers they override, masked ones as empty functions
+            ScriptFunctionMap triggers;
+            for (auto it = m_triggers.constBegin(); it != m_triggers.constEnd(); ++it) {
+                triggers.insert(it.key(), it.value());
+            }
+            jsonString = ScriptFunctionMap::toJsonString(triggers);
+        } else {
+            jsonString = property.toJsonString(this, property,
+                                               (Options) (options & IncludeTypeInfo));
+        }
         if (!jsonString.isEmpty()) {
-            dumpedProperties.append(QString("  \"%1\": %2").arg(name, jsonString));
+            dumpedProperties.append(QString("  \"%1\": %2").arg(property.name, jsonString));
+        } else if (m_prototype && property.userType != ScriptFunctionMapType) {
+            // an empty value still overrides the one of the prototype
+            dumpedProperties.append(QString("  \"%1\": null").arg(property.name));
         }
     }
     return "{\n" + dumpedProperties.join(",\n") + "\n}";
@@ -718,38 +1098,115 @@ void GameObject::loadJson(const QString &jsonString) {
         throw GameException(GameException::InvalidGameObjectJson, jsonString);
     }
 
-    for (const QMetaProperty &meta : storedMetaProperties()) {
-        const char *name = meta.name();
-        if (!map.contains(name)) {
+    QVariantMap::const_iterator prototypeIt = map.constFind("prototype");
+    if (prototypeIt != map.constEnd()) {
+        GameObjectPtr prototype;
+        GameObjectPtr::fromVariant(prototypeIt.value(), prototype);
+        if (!prototype.isNull()) {
+            delete m_prototype;
+            m_prototype = new GameObjectPtr(prototype);
+            if (this->prototype()) {
+                this->prototype()->m_hasInstances = true;
+            }
+        }
+    }
+
+    const QVector<PropertyDescriptor> &properties = storedProperties();
+    m_inheritedProperties = (m_prototype ? QBitArray(properties.size()) : QBitArray());
+
+    for (int i = 0; i < properties.size(); i++) {
+        const PropertyDescriptor &property = properties[i];
+        QVariantMap::const_iterator it = map.constFind(property.name);
+        if (it == map.constEnd()) {
+            if (m_prototype) {
+                m_inheritedProperties.setBit(i);
+            }
+            continue;
+        }
+
+        if (m_prototype && property.userType == ScriptFunctionMapType) {
+            // the prototype may not be loaded yet, so the overrides are taken as they are
+            ScriptFunctionMap triggers;
+            ScriptFunctionMap::fromVariant(it.value(), triggers);
+            m_triggers.clear();
+            for (auto triggerIt = triggers.constBegin(); triggerIt != triggers.constEnd();
+                 ++triggerIt) {
+                m_triggers.insert(triggerIt.key(), triggerIt.value());
+            }
+            continue;
+        }
+
+        if (!it.value().isValid()) {
+            property.metaProperty.write(this, QVariant(property.userType, nullptr));
             continue;
         }
 
-        meta.write(this, ConversionUtil::fromVariant(meta.type(), meta.userType(), map[name]));
+        property.metaProperty.write(this, property.fromJsonVariant ?
+                                          property.fromJsonVariant(it.value()) :
+                                          ConversionUtil::fromVariant(property.metaProperty.type(),
+                                                                      property.userType,
+                                                                      it.value()));
+    }
+
+    // while the realm is loading, its prototype may not have been loaded yet
+    if (m_realm->isInitialized()) {
+        inheritFromPrototype();
+    }
+}
+
+void GameObject::inheritFromPrototype() {
+
+    QBitArray inheritedProperties = m_inheritedProperties;
+    m_inheritedProperties.clear();
+    if (!m_prototype || inheritedProperties.count(true) == 0) {
+        return;
+    }
+
+    GameObject *prototype = m_realm->getObject(m_prototype->m_objectType, m_prototype->m_id);
+    if (!prototype || prototype->m_objectType != m_objectType) {
+        LogUtil::logError("Prototype of object %1:%2 not found", m_objectType.toString(),
+                          QString::number(m_id));
+        return;
+    }
+
+    prototype->inheritFromPrototype();
+
+    const QVector<PropertyDescriptor> &properties = storedProperties();
+    for (int i = 0; i < properties.size(); i++) {
+        const PropertyDescriptor &property = properties[i];
+        if (inheritedProperties.testBit(i) && property.userType != ScriptFunctionMapType) {
+            property.copy(prototype, this, property);
+        }
     }
 }
 
 void GameObject::resolvePointers() {
 
-    for (const QMetaProperty &metaProperty : storedMetaProperties()) {
-        if (metaProperty.type() == QVariant::UserType) {
-            if (metaProperty.userType() == GameObjectPtrType) {
-                GameObjectPtr pointer;
-                void *value = &pointer;
-                qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-                try {
-                    pointer.resolve(m_realm);
-                } catch (const GameException &exception) {
-                    Q_UNUSED(exception)
-                    pointer = GameObjectPtr();
-                }
-                qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
-            } else if (metaProperty.userType() == GameObjectPtrListType) {
-                GameObjectPtrList list;
-                void *value = &list;
-                qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-                list.resolvePointers(m_realm);
-                qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
+    if (m_prototype && !m_prototype->m_gameObject) {
+        try {
+            m_prototype->resolve(m_realm);
+            prototype()->m_hasInstances = true;
+        } catch (const GameException &exception) {
+            Q_UNUSED(exception)
+            delete m_prototype;
+            m_prototype = nullptr;
+        }
+    }
+
+    for (const PropertyDescriptor &property : storedProperties()) {
+        if (property.userType == GameObjectPtrType) {
+            GameObjectPtr pointer = readProperty<GameObjectPtr>(this, property);
+            try {
+                pointer.resolve(m_realm);
+            } catch (const GameException &exception) {
+                Q_UNUSED(exception)
+                pointer = GameObjectPtr();
             }
+            writeProperty(this, property, pointer);
+        } else if (property.userType == GameObjectPtrListType) {
+            GameObjectPtrList list = readProperty<GameObjectPtrList>(this, property);
+            list.resolvePointers(m_realm);
+            writeProperty(this, property, list);
         }
     }
 }
@@ -765,22 +1222,22 @@ QVector<QMetaProperty> GameObject::metaProperties() const {
     return properties;
 }
 
-QVector<QMetaProperty> GameObject::storedMetaProperties() const {
+const QVector<GameObject::PropertyDescriptor> &GameObject::storedProperties() const {
 
-    static QHash<int, QVector<QMetaProperty> > storedProperties;
-    if (!storedProperties.contains(m_objectType.intValue())) {
-        QVector<QMetaProperty> properties;
+    static QVector<PropertyDescriptor> storedProperties[GameObjectType::NumValues];
+
+    QVector<PropertyDescriptor> &properties = storedProperties[m_objectType.value];
+    if (properties.isEmpty()) {
         int count = metaObject()->propertyCount(),
             offset = GameObject::staticMetaObject.propertyOffset();
         for (int i = offset; i < count; i++) {
             QMetaProperty metaProperty = metaObject()->property(i);
             if (metaProperty.isStored()) {
-                properties << metaProperty;
+                properties << describeProperty(metaProperty);
             }
         }
-        storedProperties[m_objectType.intValue()] = properties;
     }
-    return storedProperties[m_objectType.intValue()];
+    return properties;
 }
 
 GameObject *GameObject::createByObjectType(Realm *realm, GameObjectType objectType, uint id,
@@ -850,50 +1307,24 @@ GameObject *GameObject::createCopy(GameObject *other) {
     GameObject *copy = createByObjectType(other->realm(), other->objectType(), other->id(), Copy);
     copy->m_deleted = other->m_deleted;
 
-    for (const QMetaProperty &metaProperty : other->storedMetaProperties()) {
-        if (metaProperty.type() == QVariant::UserType) {
-            if (metaProperty.userType() == GameEventMultiplierMapType) {
-                GameEventMultiplierMap map;
-                void *value = &map;
-                other->qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-                copy->qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
-            } else if (metaProperty.userType() == GameObjectPtrType) {
-                GameObjectPtr pointer;
-                void *value = &pointer;
-                other->qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-                pointer.unresolve();
-                copy->qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
-            } else if (metaProperty.userType() == GameObjectPtrListType) {
-                GameObjectPtrList list;
-                void *value = &list;
-                other->qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-                list.unresolvePointers();
-                copy->qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
-            } else if (metaProperty.userType() == Point3DType) {
-                Point3D point;
-                void *value = &point;
-                other->qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-                copy->qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
-            } else if (metaProperty.userType() == ScriptFunctionMapType) {
-                ScriptFunctionMap map;
-                void *value = &map;
-                other->qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-                copy->qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
-            } else {
-                metaProperty.write(copy, metaProperty.read(other));
-            }
-        } else if (metaProperty.type() == QVariant::Map) {
-            QVariantMap map;
-            void *value = &map;
-            other->qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-            copy->qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
-        } else if (metaProperty.type() == QVariant::String) {
-            QString string;
-            void *value = &string;
-            other->qt_metacall(QMetaObject::ReadProperty, metaProperty.propertyIndex(), &value);
-            copy->qt_metacall(QMetaObject::WriteProperty, metaProperty.propertyIndex(), &value);
+    if (other->m_prototype) {
+        copy->m_prototype = new GameObjectPtr(*other->m_prototype);
+        copy->m_prototype->unresolve();
+    }
+
+    for (const PropertyDescriptor &property : other->storedProperties()) {
+        if (property.userType == GameObjectPtrType) {
+            GameObjectPtr pointer = readProperty<GameObjectPtr>(other, property);
+            pointer.unresolve();
+            writeProperty(copy, property, pointer);
+        } else if (property.userType == GameObjectPtrListType) {
+            GameObjectPtrList list = readProperty<GameObjectPtrList>(other, property);
+            list.unresolvePointers();
+            writeProperty(copy, property, list);
+        } else if (property.userType == ScriptFunctionMapType) {
+            copy->m_triggers = other->m_triggers;
         } else {
-            metaProperty.write(copy, metaProperty.read(other));
+            property.copy(other, copy, property);
         }
     }
 
@@ -991,14 +1422,34 @@ void GameObject::setAutoDelete(bool autoDelete) {
     }
 }
 
+bool GameObject::isListed() const {
+
+    // pointers to objects that are never deleted are not tracked
+    if (m_options & NeverDelete) {
+        return true;
+    }
+
+    for (GameObjectPtr *pointer = m_pointers; pointer; pointer = pointer->m_next) {
+        if (pointer->m_list) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void GameObject::registerPointer(GameObjectPtr *pointer) {
 
     if (m_options & NeverDelete) {
         return;
     } 
 
-    Q_ASSERT(!m_pointers.contains(pointer));
-    m_pointers.append(pointer);
+    Q_ASSERT(pointer != m_pointers && !pointer->m_previous && !pointer->m_next);
+
+    pointer->m_next = m_pointers;
+    if (m_pointers) {
+        m_pointers->m_previous = pointer;
+    }
+    m_pointers = pointer;
 }
 
 void GameObject::unregisterPointer(GameObjectPtr *pointer) {
@@ -1007,15 +1458,47 @@ void GameObject::unregisterPointer(GameObjectPtr *pointer) {
         return;
     } 
 
-    int index = m_pointers.indexOf(pointer);
-    Q_ASSERT(index > -1);
-    m_pointers.remove(index);
+    Q_ASSERT(pointer == m_pointers || pointer->m_previous);
+
+    if (pointer->m_previous) {
+        pointer->m_previous->m_next = pointer->m_next;
+    } else {
+        m_pointers = pointer->m_next;
+    }
+    if (pointer->m_next) {
+        pointer->m_next->m_previous = pointer->m_previous;
+    }
+    pointer->m_previous = nullptr;
+    pointer->m_next = nullptr;
 
-    if (m_options & AutoDelete && m_pointers.isEmpty()) {
+    if (m_options & AutoDelete && !m_pointers) {
         setDeleted();
     }
 }
 
+void GameObject::replacePointer(GameObjectPtr *pointer, GameObjectPtr *replacement) {
+
+    if (m_options & NeverDelete) {
+        return;
+    }
+
+    Q_ASSERT(pointer == m_pointers || pointer->m_previous);
+
+    replacement->m_previous = pointer->m_previous;
+    replacement->m_next = pointer->m_next;
+
+    if (replacement->m_previous) {
+        replacement->m_previous->m_next = replacement;
+    } else {
+        m_pointers = replacement;
+    }
+    if (replacement->m_next) {
+        replacement->m_next->m_previous = replacement;
+    }
+    pointer->m_previous = nullptr;
+    pointer->m_next = nullptr;
+}
+
 void GameObject::changeName(const QString &newName) {
 
     if (m_options & AutomaticNameForms) {
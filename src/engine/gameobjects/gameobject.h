@@ -1,13 +1,18 @@
 #ifndef GAMEOBJECT_H
 #define GAMEOBJECT_H
 
+#include <QBitArray>
 #include <QHash>
+#include <QMetaProperty>
 #include <QObject>
 #include <QScriptEngine>
 #include <QVariantMap>
 #include <QVector>
 
 #include "constants.h"
+#include "datamap.h"
+#include "gameobjectallocator.h"
+#include "internedstring.h"
 #include "metatyperegistry.h"
 #include "scriptfunctionmap.h"
 
@@ -41,13 +46,39 @@ class GameObject : public QObject {
     Q_OBJECT
 
     friend class GameObjectPtr;
+    friend class Realm;
     friend void swap(GameObjectPtr &first, GameObjectPtr &second);
     friend void swapWithinList(GameObjectPtr &first, GameObjectPtr &second);
 
     public:
+        // stored property of an object type, with conversion functions picked once per type
+        // instead of per property access. values are still read and written through moc's
+        // qt_metacall() (without boxing them in a QVariant for known types), and loading still
+        // writes through QMetaProperty
+        class PropertyDescriptor {
+            public:
+                QMetaProperty metaProperty;
+                const char *name;
+                int index;
+                int userType;
+
+                QString (*toJsonString)(const GameObject *object,
+                                        const PropertyDescriptor &property, Options options);
+                QVariant (*fromJsonVariant)(const QVariant &variant);
+                void (*copy)(const GameObject *source, GameObject *destination,
+                             const PropertyDescriptor &property);
+        };
+
         GameObject(Realm *realm, GameObjectType objectType, uint id, Options options = NoOptions);
         virtual ~GameObject();
 
+        static void *operator new(size_t size) {
+            return GameObjectAllocator::allocate(size);
+        }
+        static void operator delete(void *pointer, size_t size) {
+            GameObjectAllocator::deallocate(pointer, size);
+        }
+
         Realm *realm() const { return m_realm; }
 
         GameObjectType objectType() const { return m_objectType; }
@@ -72,7 +103,9 @@ class GameObject : public QObject {
         uint id() const { return m_id; }
         Q_PROPERTY(uint id READ id STORED false)
 
-        const QString &name() const { return m_name; }
+        Q_INVOKABLE GameObject *prototype() const;
+
+        const QString &name() const { return m_name.toString(); }
         void setName(const QString &name);
         Q_PROPERTY(QString name READ name WRITE setName)
 
@@ -80,11 +113,11 @@ class GameObject : public QObject {
                                          int options = NoOptions) const;
         Q_INVOKABLE QString indefiniteName(int options = NoOptions) const;
 
-        const QString &plural() const { return m_plural; }
+        const QString &plural() const { return m_plural.toString(); }
         void setPlural(const QString &plural);
         Q_PROPERTY(QString plural READ plural WRITE setPlural)
 
-        const QString &indefiniteArticle() const { return m_indefiniteArticle; }
+        const QString &indefiniteArticle() const { return m_indefiniteArticle.toString(); }
         void setIndefiniteArticle(const QString &indefiniteArticle);
         Q_PROPERTY(QString indefiniteArticle READ indefiniteArticle WRITE setIndefiniteArticle)
 
@@ -92,54 +125,61 @@ class GameObject : public QObject {
         void setDescription(const QString &description);
         Q_PROPERTY(QString description READ description WRITE setDescription)
 
-        const QVariantMap &data() const { return m_data; }
+        QVariantMap data() const { return m_data.toVariantMap(); }
         void setData(const QVariantMap &data);
-        Q_INVOKABLE void setBoolData(const QString &name, bool value);
-        Q_INVOKABLE void setIntData(const QString &name, int value);
-        Q_INVOKABLE void setStringData(const QString &name, const QString &value);
-        Q_INVOKABLE void setGameObjectData(const QString &name, const GameObjectPtr &value);
-        Q_INVOKABLE void setGameObjectListData(const QString &name, const GameObjectPtrList &value);
+        Q_INVOKABLE QVariant dataValue(const InternedString &name) const;
+        Q_INVOKABLE bool boolData(const InternedString &name) const;
+        Q_INVOKABLE int intData(const InternedString &name) const;
+        Q_INVOKABLE double doubleData(const InternedString &name) const;
+        Q_INVOKABLE QString stringData(const InternedString &name) const;
+        Q_INVOKABLE void setBoolData(const InternedString &name, bool value);
+        Q_INVOKABLE void setIntData(const InternedString &name, int value);
+        Q_INVOKABLE void setDoubleData(const InternedString &name, double value);
+        Q_INVOKABLE void setStringData(const InternedString &name, const QString &value);
+        Q_INVOKABLE void setGameObjectData(const InternedString &name, const GameObjectPtr &value);
+        Q_INVOKABLE void setGameObjectListData(const InternedString &name,
+                                               const GameObjectPtrList &value);
         Q_PROPERTY(QVariantMap data READ data WRITE setData)
 
-        const ScriptFunctionMap &triggers() const { return m_triggers; }
-        ScriptFunction trigger(const QString &name) const { return m_triggers[name]; }
-        Q_INVOKABLE bool hasTrigger(const QString &name) const { return m_triggers.contains(name); }
-        Q_INVOKABLE void setTrigger(const QString &name, const ScriptFunction &function);
-        Q_INVOKABLE void unsetTrigger(const QString &name);
+        ScriptFunctionMap triggers() const;
+        ScriptFunction trigger(const InternedString &name) const;
+        Q_INVOKABLE bool hasTrigger(const InternedString &name) const;
+        Q_INVOKABLE void setTrigger(const InternedString &name, const ScriptFunction &function);
+        Q_INVOKABLE void unsetTrigger(const InternedString &name);
         void setTriggers(const ScriptFunctionMap &triggers);
         Q_PROPERTY(ScriptFunctionMap triggers READ triggers WRITE setTriggers)
 
-        Q_INVOKABLE bool invokeTrigger(const QString &triggerName,
+        Q_INVOKABLE bool invokeTrigger(const InternedString &triggerName,
                                        const QScriptValue &arg1 = QScriptValue(),
                                        const QScriptValue &arg2 = QScriptValue(),
                                        const QScriptValue &arg3 = QScriptValue(),
                                        const QScriptValue &arg4 = QScriptValue());
-        bool invokeTrigger(const QString &triggerName,
+        bool invokeTrigger(const InternedString &triggerName,
                            GameObject *arg1,
                            const GameObjectPtr &arg2,
                            const QScriptValue &arg3 = QScriptValue(),
                            const QScriptValue &arg4 = QScriptValue());
-        bool invokeTrigger(const QString &triggerName,
+        bool invokeTrigger(const InternedString &triggerName,
                            GameObject *arg1,
                            const GameObjectPtrList &arg2,
                            const QScriptValue &arg3 = QScriptValue(),
                            const QScriptValue &arg4 = QScriptValue());
-        bool invokeTrigger(const QString &triggerName,
+        bool invokeTrigger(const InternedString &triggerName,
                            GameObject *arg1,
                            const GameObjectPtr &arg2,
                            const GameObjectPtrList &arg3,
                            const QScriptValue &arg4 = QScriptValue());
-        bool invokeTrigger(const QString &triggerName,
+        bool invokeTrigger(const InternedString &triggerName,
                            GameObject *arg1,
                            const QScriptValue &arg2 = QScriptValue(),
                            const QScriptValue &arg3 = QScriptValue(),
                            const QScriptValue &arg4 = QScriptValue());
-        bool invokeTrigger(const QString &triggerName,
+        bool invokeTrigger(const InternedString &triggerName,
                            const GameObjectPtr &arg1,
                            const GameObjectPtr &arg2,
                            const QScriptValue &arg3 = QScriptValue(),
                            const QScriptValue &arg4 = QScriptValue());
-        bool invokeTrigger(const QString &triggerName,
+        bool invokeTrigger(const InternedString &triggerName,
                            const GameObjectPtr &arg1,
                            const QScriptValue &arg2 = QScriptValue(),
                            const QScriptValue &arg3 = QScriptValue(),
@@ -190,10 +230,11 @@ class GameObject : public QObject {
         void load(const QString &path);
         void loadJson(const QString &jsonString);
 
+        void inheritFromPrototype();
         void resolvePointers();
 
         QVector<QMetaProperty> metaProperties() const;
-        QVector<QMetaProperty> storedMetaProperties() const;
+        const QVector<PropertyDescriptor> &storedProperties() const;
 
         static GameObject *createByObjectType(Realm *realm, GameObjectType objectType, uint id = 0,
                                               Options options = NoOptions);
@@ -207,6 +248,9 @@ class GameObject : public QObject {
 
         static void clearPrototypeMap();
 
+        // changes whenever an object that is contained in a list is renamed
+        static uint nameGeneration() { return s_nameGeneration; }
+
     protected:
         bool mayReferenceOtherProperties() const;
         void setModified();
@@ -217,10 +261,17 @@ class GameObject : public QObject {
 
         void registerPointer(GameObjectPtr *pointer);
         void unregisterPointer(GameObjectPtr *pointer);
+        void replacePointer(GameObjectPtr *pointer, GameObjectPtr *replacement);
 
         virtual void changeName(const QString &newName);
 
     private:
+        const ScriptFunction *findTrigger(const InternedString &name) const;
+
+        bool isListed() const;
+
+        void detachInstances();
+
         Realm *m_realm;
 
         GameObjectType m_objectType;
@@ -229,19 +280,33 @@ class GameObject : public QObject {
 
         bool m_deleted;
 
-        QVector<GameObjectPtr *> m_pointers;
+        GameObjectPtr *m_pointers;
+
+        // links in the realm's list of registered objects of the same type
+        GameObject *m_previousOfType;
+        GameObject *m_nextOfType;
 
-        QString m_name;
-        QString m_plural;
-        QString m_indefiniteArticle;
+        // instances look up the triggers they don't override in their prototype, an empty
+        // override masks an inherited trigger. the bits mark the stored properties that were
+        // missing from the instance's file and are still to be inherited from the prototype
+        // once it's loaded
+        GameObjectPtr *m_prototype;
+        QBitArray m_inheritedProperties;
+        bool m_hasInstances;
+
+        InternedString m_name;
+        InternedString m_plural;
+        InternedString m_indefiniteArticle;
         QString m_description;
-        QVariantMap m_data;
-        ScriptFunctionMap m_triggers;
+        DataMap m_data;
+        QHash<InternedString, ScriptFunction> m_triggers;
 
         QHash<int, QScriptValue> *m_intervalHash;
         QHash<int, QScriptValue> *m_timeoutHash;
 
         static QMap<QString, QScriptValue> s_prototypeMap;
+
+        static uint s_nameGeneration;
 };
 
 PT_DECLARE_METATYPE(GameObject *)
@@ -1,5 +1,8 @@
 #include "group.h"
 
+#include "encodedmessage.h"
+#include "player.h"
+
 
 #define super GameObject
 
@@ -38,8 +41,11 @@ void Group::setMembers(const GameObjectPtrList &members) {
 
 void Group::send(const QString &message, int color) const {
 
-    m_leader->send(message, color);
-    for (const GameObjectPtr &member : m_members) {
-        member->send(message, color);
+    EncodedMessage encodedMessage(message, color);
+    if (m_leader->isPlayer()) {
+        m_leader.unsafeCast<Player *>()->send(encodedMessage);
+    } else {
+        m_leader->send(message, color);
     }
+    m_members.send(encodedMessage);
 }
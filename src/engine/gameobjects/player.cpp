@@ -2,6 +2,7 @@
 
 #include <QCryptographicHash>
 
+#include "gameeventaggregator.h"
 #include "realm.h"
 #include "session.h"
 #include "util.h"
@@ -108,22 +109,25 @@ bool Player::isOnline() const {
     return m_session != nullptr;
 }
 
-void Player::send(const QString &_message, int color) const {
+void Player::send(const QString &message, int color) const {
 
     if (!m_session) {
         return;
     }
 
-    QString message;
-    if (_message.endsWith("\n") ||
-        (_message.startsWith("{") && _message.endsWith("}"))) {
-        message = _message;
-    } else {
-        message = _message + "\n";
+    send(EncodedMessage(message, color));
+}
+
+void Player::send(const EncodedMessage &message) const {
+
+    if (!m_session) {
+        return;
     }
 
-    if ((Color) color != Silver) {
-        message = Util::colorize(message, (Color) color);
+    // perceptions collected before this message should also arrive before it
+    GameEventAggregator *aggregator = realm()->eventAggregator();
+    if (aggregator->isCollecting()) {
+        aggregator->flush(this);
     }
 
     m_session->send(message);
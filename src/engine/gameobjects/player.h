@@ -5,6 +5,8 @@
 
 #include <QString>
 
+#include "encodedmessage.h"
+
 
 class Session;
 
@@ -36,6 +38,7 @@ class Player : public Character {
         Q_INVOKABLE bool isOnline() const;
 
         virtual void send(const QString &message, int color = Silver) const;
+        void send(const EncodedMessage &message) const;
 
         Q_INVOKABLE void quit();
 
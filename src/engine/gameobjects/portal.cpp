@@ -1,6 +1,8 @@
 #include "portal.h"
 
+#include "realm.h"
 #include "room.h"
+#include "roomgraph.h"
 
 
 #define super GameObject
@@ -17,6 +19,7 @@ void Portal::setName2(const QString &name2) {
 
     if (m_name2 != name2) {
         m_name2 = name2;
+        invalidateExitNames();
 
         setModified();
     }
@@ -52,7 +55,13 @@ void Portal::setDestination2(const QString &destination2) {
 void Portal::setRoom(const GameObjectPtr &room) {
 
     if (m_room != room) {
+        invalidateExitNames();
         m_room = room;
+        invalidateExitNames();
+
+        if (~options() & Copy) {
+            realm()->roomGraph()->invalidate();
+        }
 
         setModified();
     }
@@ -61,7 +70,13 @@ void Portal::setRoom(const GameObjectPtr &room) {
 void Portal::setRoom2(const GameObjectPtr &room2) {
 
     if (m_room2 != room2) {
+        invalidateExitNames();
         m_room2 = room2;
+        invalidateExitNames();
+
+        if (~options() & Copy) {
+            realm()->roomGraph()->invalidate();
+        }
 
         setModified();
     }
@@ -81,6 +96,10 @@ void Portal::setFlags(PortalFlags flags) {
     if (m_flags != flags) {
         m_flags = flags;
 
+        if (~options() & Copy) {
+            realm()->roomGraph()->updatePortal(this);
+        }
+
         setModified();
     }
 }
@@ -90,6 +109,10 @@ void Portal::setEventMultipliers(const GameEventMultiplierMap &multipliers) {
     if (m_eventMultipliers != multipliers) {
         m_eventMultipliers = multipliers;
 
+        if (~options() & Copy) {
+            realm()->roomGraph()->updatePortal(this);
+        }
+
         setModified();
     }
 }
@@ -195,3 +218,27 @@ void Portal::setOpen(bool open) {
         setFlags(m_flags & ~PortalFlags::IsOpen);
     }
 }
+
+void Portal::changeName(const QString &newName) {
+
+    super::changeName(newName);
+
+    invalidateExitNames();
+}
+
+void Portal::invalidateExitNames() {
+
+    if (options() & Copy) {
+        return;
+    }
+
+    // rooms keep a map of the names of their exits
+    Room *room = m_room.unsafeCast<Room *>();
+    if (room) {
+        room->invalidateExitNames();
+    }
+    Room *room2 = m_room2.unsafeCast<Room *>();
+    if (room2) {
+        room2->invalidateExitNames();
+    }
+}
@@ -87,7 +87,12 @@ class Portal : public GameObject {
         void setOpen(bool open);
         Q_PROPERTY(bool open READ isOpen WRITE setOpen STORED false)
 
+    protected:
+        virtual void changeName(const QString &newName);
+
     private:
+        void invalidateExitNames();
+
         QString m_name2;
 
         QString m_description2;
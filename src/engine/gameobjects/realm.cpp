@@ -21,6 +21,7 @@ Realm::Realm(Options options) :
     super(this, GameObjectType::Realm, 0, (Options) (options | DontRegister | NeverDelete)),
     m_initialized(false),
     m_nextId(1),
+    m_roomGraph(this),
     m_timeIntervalId(0),
     m_gameThread(this),
     m_scriptEngine(nullptr) {
@@ -43,6 +44,8 @@ Realm::Realm(Options options) :
     }
 
     for (uint i = 0; i < GameObjectType::NumValues; i++) {
+        m_firstObjects[i] = nullptr;
+        m_lastObjects[i] = nullptr;
         m_numObjects[i] = 0;
     }
 
@@ -83,8 +86,17 @@ void Realm::init() {
         }
     }
 
-    for (GameObject *object : m_objectMap) {
-        object->resolvePointers();
+    // instances can only inherit from their prototypes once all objects are loaded
+    for (int i = 0, numObjects = m_objects.size(); i < numObjects; i++) {
+        if (m_objects[i]) {
+            m_objects[i]->inheritFromPrototype();
+        }
+    }
+
+    for (int i = 0, numObjects = m_objects.size(); i < numObjects; i++) {
+        if (m_objects[i]) {
+            m_objects[i]->resolvePointers();
+        }
     }
 
     m_syncThread.start(QThread::LowestPriority);
@@ -94,8 +106,11 @@ void Realm::init() {
 
     super::init();
 
-    for (GameObject *object : m_objectMap) {
-        object->init();
+    // objects may register new objects while being iterated over
+    for (int i = 0, numObjects = m_objects.size(); i < numObjects; i++) {
+        if (m_objects[i]) {
+            m_objects[i]->init();
+        }
     }
 
     m_timeIntervalId = startInterval(this, 150000);
@@ -112,15 +127,30 @@ void Realm::registerObject(GameObject *gameObject) {
     Q_ASSERT(gameObject);
 
     uint id = gameObject->id();
-    m_objectMap.insert(id, gameObject);
+    if (id >= (uint) m_objects.size()) {
+        m_objects.resize(id + 1);
+    }
+    Q_ASSERT(!m_objects[id]);
+    m_objects[id] = gameObject;
 
     int objectType = gameObject->objectType().value;
+    gameObject->m_previousOfType = m_lastObjects[objectType];
+    gameObject->m_nextOfType = nullptr;
+    if (m_lastObjects[objectType]) {
+        m_lastObjects[objectType]->m_nextOfType = gameObject;
+    } else {
+        m_firstObjects[objectType] = gameObject;
+    }
+    m_lastObjects[objectType] = gameObject;
+    m_numObjects[objectType]++;
+
     switch (objectType) {
         case GameObjectType::Area:
             m_areas.append(gameObject);
             break;
         case GameObjectType::Room:
             m_rooms.append(gameObject);
+            m_roomGraph.invalidate();
             break;
         case GameObjectType::Class:
             m_classes.append(gameObject);
@@ -128,25 +158,43 @@ void Realm::registerObject(GameObject *gameObject) {
         case GameObjectType::Race:
             m_races.append(gameObject);
             break;
-        default:
-            m_numObjects[objectType]++;
-            break;
     }
 
     if (id >= m_nextId) {
-        m_nextId = id;
-        do {
-            m_nextId++;
-        } while (m_objectMap.contains(m_nextId));
+        m_nextId = id + 1;
     }
 }
 
 void Realm::unregisterObject(GameObject *gameObject) {
 
     Q_ASSERT(gameObject);
-    m_objectMap.remove(gameObject->id());
+
+    uint id = gameObject->id();
+    if (id >= (uint) m_objects.size() || m_objects[id] != gameObject) {
+        return;
+    }
+    m_objects[id] = nullptr;
 
     int objectType = gameObject->objectType().value;
+    if (gameObject->m_previousOfType) {
+        gameObject->m_previousOfType->m_nextOfType = gameObject->m_nextOfType;
+    } else {
+        m_firstObjects[objectType] = gameObject->m_nextOfType;
+    }
+    if (gameObject->m_nextOfType) {
+        gameObject->m_nextOfType->m_previousOfType = gameObject->m_previousOfType;
+    } else {
+        m_lastObjects[objectType] = gameObject->m_previousOfType;
+    }
+    gameObject->m_previousOfType = nullptr;
+    gameObject->m_nextOfType = nullptr;
+
+    if (objectType == GameObjectType::Room) {
+        m_rooms.removeOne(gameObject);
+        m_roomGraph.invalidate();
+    } else if (objectType == GameObjectType::Portal) {
+        m_roomGraph.invalidate();
+    }
     if (m_numObjects[objectType] > 0) {
         m_numObjects[objectType]--;
     }
@@ -160,10 +208,10 @@ GameObject *Realm::getObject(GameObjectType objectType, uint id) {
         }
     }
 
-    if (m_objectMap.contains(id)) {
-        GameObject *object = m_objectMap[id];
-        Q_ASSERT(object);
-        if (objectType == GameObjectType::Unknown || object->objectType() == objectType) {
+    if (id < (uint) m_objects.size()) {
+        GameObject *object = m_objects.at(id);
+        if (object &&
+            (objectType == GameObjectType::Unknown || object->objectType() == objectType)) {
             return object;
         }
     }
@@ -184,17 +232,18 @@ GameObject *Realm::createObject(const QString &objectType) {
 QVector<GameObject *> Realm::allObjects(GameObjectType objectType) const {
 
     QVector<GameObject *> objects;
-    objects.reserve(m_numObjects[objectType.value]);
     if (objectType == GameObjectType::Unknown) {
-        for (GameObject *object : m_objectMap) {
-            objects.append(object);
-        }
-    } else {
-        for (GameObject *object : m_objectMap) {
-            if (object->objectType() == objectType) {
+        for (GameObject *object : m_objects) {
+            if (object) {
                 objects.append(object);
             }
         }
+    } else {
+        objects.reserve(m_numObjects[objectType.value]);
+        for (GameObject *object = m_firstObjects[objectType.value]; object;
+             object = object->m_nextOfType) {
+            objects.append(object);
+        }
     }
     return objects;
 }
@@ -257,6 +306,30 @@ void Realm::setDateTime(const QDateTime &dateTime) {
     }
 }
 
+GameObjectPtrList Realm::roomsWithin(const Point3D &point, int radius) {
+
+    m_roomGraph.validate();
+
+    GameObjectPtrList rooms;
+    for (int index : m_roomGraph.roomsWithin(point, radius)) {
+        rooms.append(m_roomGraph.room(index));
+    }
+    return rooms;
+}
+
+GameObjectPtrList Realm::charactersWithin(const Point3D &point, int radius) {
+
+    m_roomGraph.validate();
+
+    GameObjectPtrList characters;
+    for (int index : m_roomGraph.roomsWithin(point, radius)) {
+        if (m_roomGraph.occupancy(index) > 0) {
+            characters.append(m_roomGraph.room(index)->characters());
+        }
+    }
+    return characters;
+}
+
 GameEvent *Realm::createEvent(const QString &eventType, const GameObjectPtr &origin,
                               double strength) {
 
@@ -271,11 +344,8 @@ GameEvent *Realm::createEvent(const QString &eventType, const GameObjectPtr &ori
 
 uint Realm::uniqueObjectId() {
 
-    uint uniqueId = m_nextId;
-    do {
-        m_nextId++;
-    } while (m_objectMap.contains(m_nextId));
-    return uniqueId;
+    // ids are never reused, because they may still be referred to from disk
+    return m_nextId++;
 }
 
 void Realm::enqueueEvent(Event *event) {
@@ -8,11 +8,13 @@
 #include <QVector>
 
 #include "gameevent.h"
+#include "gameeventaggregator.h"
 #include "gameobject.h"
 #include "gameobjectptr.h"
 #include "gameobjectsyncthread.h"
 #include "gamethread.h"
 #include "logthread.h"
+#include "roomgraph.h"
 
 
 class CommandInterpreter;
@@ -61,6 +63,13 @@ class Realm : public GameObject {
         Q_INVOKABLE GameObjectPtrList races() const { return m_races; }
         Q_INVOKABLE GameObjectPtrList classes() const { return m_classes; }
 
+        RoomGraph *roomGraph() { return &m_roomGraph; }
+
+        Q_INVOKABLE GameObjectPtrList roomsWithin(const Point3D &point, int radius);
+        Q_INVOKABLE GameObjectPtrList charactersWithin(const Point3D &point, int radius);
+
+        GameEventAggregator *eventAggregator() { return &m_eventAggregator; }
+
         Q_INVOKABLE GameEvent *createEvent(const QString &eventType, const GameObjectPtr &origin,
                                            double strength);
 
@@ -91,6 +100,8 @@ class Realm : public GameObject {
 
         virtual void invokeTimer(int timerId);
 
+        const GameThread *gameThread() const { return &m_gameThread; }
+
         ScriptEngine *scriptEngine() const { return m_scriptEngine; }
         void setScriptEngine(ScriptEngine *scriptEngine);
 
@@ -107,7 +118,9 @@ class Realm : public GameObject {
         bool m_initialized;
 
         uint m_nextId;
-        QHash<uint, GameObject *> m_objectMap;
+        QVector<GameObject *> m_objects;
+        GameObject *m_firstObjects[GameObjectType::NumValues];
+        GameObject *m_lastObjects[GameObjectType::NumValues];
         QHash<QString, Player *> m_playerMap;
 
         QStringList m_reservedNames;
@@ -118,6 +131,10 @@ class Realm : public GameObject {
         GameObjectPtrList m_classes;
         int m_numObjects[GameObjectType::NumValues];
 
+        RoomGraph m_roomGraph;
+
+        GameEventAggregator m_eventAggregator;
+
         QDateTime m_dateTime;
         int m_timeIntervalId;
 
@@ -1,18 +1,32 @@
 #include "room.h"
 
+#include "character.h"
 #include "item.h"
 #include "portal.h"
+#include "realm.h"
+#include "roomgraph.h"
+#include "scriptengine.h"
 #include "util.h"
+#include "visualutil.h"
 
 
 #define super GameObject
 
+static const InternedString OnLook("onlook");
+
 Room::Room(Realm *realm, uint id, Options options) :
     super(realm, GameObjectType::Room, id, (Options) (options | NeverDelete)),
     m_type(RoomType::Room),
     m_position(0, 0, 0),
     m_flags(RoomFlags::NoFlags),
-    m_portals(8) {
+    m_portals(8),
+    m_numExitNamesPortals(-1),
+    m_graphIndex(-1) {
+
+    m_characters.setIndexed(true);
+    m_characters.setNameIndexed(true);
+    m_items.setIndexed(true);
+    m_items.setNameIndexed(true);
 }
 
 Room::~Room() {
@@ -41,6 +55,10 @@ void Room::setPosition(const Point3D &position) {
     if (m_position != position) {
         m_position = position;
 
+        if (~options() & Copy) {
+            realm()->roomGraph()->updateRoom(this);
+        }
+
         setModified();
     }
 }
@@ -50,6 +68,10 @@ void Room::setFlags(RoomFlags flags) {
     if (m_flags != flags) {
         m_flags = flags;
 
+        if (~options() & Copy) {
+            realm()->roomGraph()->updateRoom(this);
+        }
+
         setModified();
     }
 }
@@ -58,6 +80,11 @@ void Room::addPortal(const GameObjectPtr &portal) {
 
     if (!m_portals.contains(portal)) {
         m_portals.append(portal);
+        invalidateExitNames();
+
+        if (~options() & Copy) {
+            realm()->roomGraph()->invalidate();
+        }
 
         setModified();
     }
@@ -66,6 +93,12 @@ void Room::addPortal(const GameObjectPtr &portal) {
 void Room::removePortal(const GameObjectPtr &portal) {
 
     if (m_portals.removeOne(portal)) {
+        invalidateExitNames();
+
+        if (~options() & Copy) {
+            realm()->roomGraph()->invalidate();
+        }
+
         setModified();
     }
 }
@@ -74,6 +107,11 @@ void Room::setPortals(const GameObjectPtrList &portals) {
 
     if (m_portals != portals) {
         m_portals = portals;
+        invalidateExitNames();
+
+        if (~options() & Copy) {
+            realm()->roomGraph()->invalidate();
+        }
 
         setModified();
     }
@@ -83,18 +121,60 @@ void Room::addCharacter(const GameObjectPtr &character) {
 
     if (!m_characters.contains(character)) {
         m_characters.append(character);
+
+        if (~options() & Copy) {
+            realm()->roomGraph()->updateOccupancy(this);
+        }
     }
 }
 
 void Room::removeCharacter(const GameObjectPtr &character) {
 
-    m_characters.removeOne(character);
+    if (m_characters.removeOne(character)) {
+        if (~options() & Copy) {
+            realm()->roomGraph()->updateOccupancy(this);
+        }
+    }
+}
+
+bool Room::hasExitNamed(const QString &name) const {
+
+    if (m_numExitNamesPortals != m_portals.size()) {
+        m_exitNames.clear();
+
+        GameObjectPtr room(const_cast<Room *>(this));
+        for (const GameObjectPtr &portalPtr : m_portals) {
+            QString portalName = portalPtr.cast<Portal *>()->nameFromRoom(room);
+            m_exitNames.insert(portalName);
+            for (const QString &portalNamePart : portalName.split(' ')) {
+                m_exitNames.insert(portalNamePart);
+            }
+        }
+
+        m_numExitNamesPortals = m_portals.size();
+    }
+
+    return m_exitNames.contains(name);
+}
+
+void Room::invalidateExitNames() {
+
+    m_numExitNamesPortals = -1;
+}
+
+GameObjectPtrList Room::charactersByName(const QString &prefix) const {
+
+    return m_characters.objectsByName(prefix);
 }
 
 void Room::setCharacters(const GameObjectPtrList &characters) {
 
     if (m_characters != characters) {
         m_characters = characters;
+
+        if (~options() & Copy) {
+            realm()->roomGraph()->updateOccupancy(this);
+        }
     }
 }
 
@@ -114,6 +194,11 @@ void Room::removeItem(const GameObjectPtr &item) {
     }
 }
 
+GameObjectPtrList Room::itemsByName(const QString &prefix) const {
+
+    return m_items.objectsByName(prefix);
+}
+
 void Room::setItems(const GameObjectPtrList &items) {
 
     if (m_items != items) {
@@ -128,6 +213,10 @@ void Room::setEventMultipliers(const GameEventMultiplierMap &multipliers) {
     if (m_eventMultipliers != multipliers) {
         m_eventMultipliers = multipliers;
 
+        if (~options() & Copy) {
+            realm()->roomGraph()->updateRoom(this);
+        }
+
         setModified();
     }
 }
@@ -136,3 +225,26 @@ double Room::eventMultiplier(GameEventType eventType) const {
 
     return m_eventMultipliers[eventType];
 }
+
+QString Room::lookAtBy(GameObject *character) {
+
+    if (hasTrigger(OnLook)) {
+        ScriptEngine *engine = realm()->scriptEngine();
+
+        QScriptValueList arguments;
+        arguments.append(engine->toScriptValue(character));
+
+        ScriptFunction function = trigger(OnLook);
+        QScriptValue description = engine->executeFunction(function, this, arguments);
+        if (description.isString()) {
+            return description.toString();
+        }
+    }
+
+    Character *observer = qobject_cast<Character *>(character);
+    if (!observer) {
+        return super::lookAtBy(character);
+    }
+
+    return VisualUtil::describeRoom(this, observer);
+}
@@ -1,6 +1,8 @@
 #ifndef ROOM_H
 #define ROOM_H
 
+#include <QSet>
+
 #include "gameeventmultipliermap.h"
 #include "gameobject.h"
 #include "gameobjectptr.h"
@@ -61,17 +63,23 @@ class Room : public GameObject {
         void setPortals(const GameObjectPtrList &portals);
         Q_PROPERTY(GameObjectPtrList portals READ portals WRITE setPortals)
 
+        // exit names are the names of the portals as seen from this room, and the words in them
+        bool hasExitNamed(const QString &name) const;
+        void invalidateExitNames();
+
         const GameObjectPtrList &characters() const { return m_characters; }
         Q_INVOKABLE void addCharacter(const GameObjectPtr &character);
         Q_INVOKABLE void removeCharacter(const GameObjectPtr &character);
         void setCharacters(const GameObjectPtrList &characters);
         Q_PROPERTY(GameObjectPtrList characters READ characters WRITE setCharacters STORED false)
+        Q_INVOKABLE GameObjectPtrList charactersByName(const QString &prefix) const;
 
         const GameObjectPtrList &items() const { return m_items; }
         Q_INVOKABLE void addItem(const GameObjectPtr &item);
         Q_INVOKABLE void removeItem(const GameObjectPtr &item);
         void setItems(const GameObjectPtrList &items);
         Q_PROPERTY(GameObjectPtrList items READ items WRITE setItems)
+        Q_INVOKABLE GameObjectPtrList itemsByName(const QString &prefix) const;
 
         const GameEventMultiplierMap &eventMultipliers() const { return m_eventMultipliers; }
         void setEventMultipliers(const GameEventMultiplierMap &multipliers);
@@ -80,6 +88,11 @@ class Room : public GameObject {
 
         Q_INVOKABLE double eventMultiplier(GameEventType eventType) const;
 
+        Q_INVOKABLE virtual QString lookAtBy(GameObject *character);
+
+        int graphIndex() const { return m_graphIndex; }
+        void setGraphIndex(int graphIndex) { m_graphIndex = graphIndex; }
+
     private:
         GameObjectPtr m_area;
 
@@ -91,11 +104,18 @@ class Room : public GameObject {
 
         GameObjectPtrList m_portals;
 
+        // portals that get deleted are removed from the list without notice, so the exit names
+        // remember how many portals they were built from
+        mutable QSet<QString> m_exitNames;
+        mutable int m_numExitNamesPortals;
+
         GameObjectPtrList m_characters;
 
         GameObjectPtrList m_items;
 
         GameEventMultiplierMap m_eventMultipliers;
+
+        int m_graphIndex;
 };
 
 #endif // ROOM_H
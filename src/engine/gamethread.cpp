@@ -1,19 +1,27 @@
 #include "gamethread.h"
 
 #include <QDateTime>
+#include <QMutexLocker>
 
 #include "event.h"
+#include "gameeventaggregator.h"
 #include "gameexception.h"
 #include "logutil.h"
 #include "realm.h"
 #include "timerevent.h"
 
 
+static const int MaxBatchDuration = 50;
+
 GameThread::GameThread(Realm *realm) :
     QThread(),
     m_quit(false),
     m_realm(realm),
-    m_nextTimerId(0) {
+    m_averageLatency(0),
+    m_maxLatency(0),
+    m_numProcessedEvents(0),
+    m_nextTimerId(0),
+    m_batchTimestamp(0) {
 }
 
 GameThread::~GameThread() {
@@ -21,13 +29,51 @@ GameThread::~GameThread() {
 
 void GameThread::enqueueEvent(Event *event) {
 
+    QueuedEvent queuedEvent;
+    queuedEvent.event = event;
+    queuedEvent.timestamp = QDateTime::currentMSecsSinceEpoch();
+
     m_mutex.lock();
-    m_eventQueue.enqueue(event);
+    m_eventQueue.enqueue(queuedEvent);
     m_mutex.unlock();
 
     m_waitCondition.wakeAll();
 }
 
+int GameThread::queueLength() const {
+
+    QMutexLocker locker(&m_mutex);
+    return m_eventQueue.length();
+}
+
+int GameThread::queueLatency() const {
+
+    QMutexLocker locker(&m_mutex);
+
+    // the average is only updated when events are taken from the queue, so once the queue has
+    // drained it no longer says anything about the latency new events will see
+    if (m_eventQueue.isEmpty()) {
+        return 0;
+    }
+
+    // if the game thread is stuck on a slow event, the age of the oldest waiting event is a
+    // better indication of the current latency than the average of the events already processed
+    int age = QDateTime::currentMSecsSinceEpoch() - m_eventQueue.head().timestamp;
+    return qMax(m_averageLatency, age);
+}
+
+int GameThread::maxQueueLatency() const {
+
+    QMutexLocker locker(&m_mutex);
+    return m_maxLatency;
+}
+
+quint64 GameThread::numProcessedEvents() const {
+
+    QMutexLocker locker(&m_mutex);
+    return m_numProcessedEvents;
+}
+
 void GameThread::terminate() {
 
     m_quit = true;
@@ -94,7 +140,13 @@ void GameThread::run() {
                 event = takeFirstTimer();
                 timeout = false;
             } else {
-                event = m_eventQueue.dequeue();
+                QueuedEvent queuedEvent = m_eventQueue.dequeue();
+                event = queuedEvent.event;
+
+                int latency = QDateTime::currentMSecsSinceEpoch() - queuedEvent.timestamp;
+                m_averageLatency = (7 * m_averageLatency + latency) / 8;
+                m_maxLatency = qMax(m_maxLatency, latency);
+                m_numProcessedEvents++;
             }
 
             m_mutex.unlock();
@@ -102,19 +154,39 @@ void GameThread::run() {
             processEvent(event);
 
             m_mutex.lock();
+
+            // perceptions of game events are collected for as long as there's more work waiting,
+            // so that simultaneous events can be merged, but their delivery is never held up for
+            // more than a fraction of a second
+            if ((m_eventQueue.isEmpty() && msecsTillNextTimer() > 0) ||
+                QDateTime::currentMSecsSinceEpoch() - m_batchTimestamp > MaxBatchDuration) {
+                m_mutex.unlock();
+
+                deliverPerceptions();
+
+                m_mutex.lock();
+            }
         }
 
         m_mutex.unlock();
     }
 
     while (!m_eventQueue.isEmpty()) {
-        Event *event = m_eventQueue.dequeue();
+        Event *event = m_eventQueue.dequeue().event;
         processEvent(event);
     }
+
+    deliverPerceptions();
 }
 
 void GameThread::processEvent(Event *event) {
 
+    GameEventAggregator *aggregator = m_realm->eventAggregator();
+    if (!aggregator->isCollecting()) {
+        aggregator->beginBatch();
+        m_batchTimestamp = QDateTime::currentMSecsSinceEpoch();
+    }
+
     try {
         event->process();
 
@@ -129,6 +201,20 @@ void GameThread::processEvent(Event *event) {
     delete event;
 }
 
+void GameThread::deliverPerceptions() {
+
+    try {
+        m_realm->eventAggregator()->endBatch();
+
+        m_realm->enqueueModifiedObjects();
+    } catch (const GameException &exception) {
+        LogUtil::logError("Game Exception: %1\n"
+                          "While delivering perceptions of game events", exception.what());
+    } catch (...) {
+        LogUtil::logError("Unknown exception while delivering perceptions of game events");
+    }
+}
+
 unsigned long GameThread::msecsTillNextTimer() const {
 
     if (m_timers.isEmpty()) {
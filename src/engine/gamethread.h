@@ -19,6 +19,11 @@ class GameThread : public QThread {
 
         void enqueueEvent(Event *event);
 
+        int queueLength() const;
+        int queueLatency() const;
+        int maxQueueLatency() const;
+        quint64 numProcessedEvents() const;
+
         void terminate();
 
         int startTimer(GameObject *object, int timeout);
@@ -32,12 +37,21 @@ class GameThread : public QThread {
 
     private:
         QWaitCondition m_waitCondition;
-        QMutex m_mutex;
+        mutable QMutex m_mutex;
         volatile bool m_quit;
 
         Realm *m_realm;
 
-        QQueue<Event *> m_eventQueue;
+        struct QueuedEvent {
+            Event *event;
+            qint64 timestamp;
+        };
+
+        QQueue<QueuedEvent> m_eventQueue;
+
+        int m_averageLatency;
+        int m_maxLatency;
+        quint64 m_numProcessedEvents;
 
         struct Timer {
             int id;
@@ -51,7 +65,10 @@ class GameThread : public QThread {
         QList<Timer> m_timers;
         int m_nextTimerId;
 
+        qint64 m_batchTimestamp;
+
         void processEvent(Event *event);
+        void deliverPerceptions();
 
         unsigned long msecsTillNextTimer() const;
         Event *takeFirstTimer();
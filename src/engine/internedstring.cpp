@@ -0,0 +1,95 @@
+#include "internedstring.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QScriptValue>
+
+
+static QMutex *tableMutex() {
+
+    static QMutex mutex;
+    return &mutex;
+}
+
+
+InternedString::InternedString() :
+    m_entry(intern(QString())) {
+}
+
+InternedString::InternedString(const char *string) :
+    m_entry(intern(QString::fromUtf8(string))) {
+}
+
+InternedString::InternedString(const QString &string) :
+    m_entry(intern(string)) {
+}
+
+InternedString::Entry::Entry(const QString &string) :
+    string(string),
+    hash(qHash(string)),
+    ref(1) {
+}
+
+int InternedString::numInternedStrings() {
+
+    QMutexLocker locker(tableMutex());
+    return table().size();
+}
+
+QHash<QString, InternedString::Entry *> &InternedString::table() {
+
+    // interned strings may be used in static initializers, so the table is created on first use
+    static QHash<QString, Entry *> table;
+    return table;
+}
+
+QScriptValue InternedString::toScriptValue(QScriptEngine *engine, const InternedString &string) {
+
+    Q_UNUSED(engine);
+    return QScriptValue(string.toString());
+}
+
+void InternedString::fromScriptValue(const QScriptValue &value, InternedString &string) {
+
+    string = InternedString(value.toString());
+}
+
+InternedString::Entry *InternedString::intern(const QString &string) {
+
+    // the empty entry holds a reference to itself, so it's never released
+    static Entry emptyEntry((QString()));
+
+    if (string.isEmpty()) {
+        emptyEntry.ref.ref();
+        return &emptyEntry;
+    }
+
+    QMutexLocker locker(tableMutex());
+    Entry *&entry = table()[string];
+    if (entry) {
+        entry->ref.ref();
+    } else {
+        entry = new Entry(string);
+    }
+    return entry;
+}
+
+void InternedString::release(Entry *entry) {
+
+    int ref = entry->ref.load();
+    while (ref > 1) {
+        if (entry->ref.testAndSetOrdered(ref, ref - 1)) {
+            return;
+        }
+        ref = entry->ref.load();
+    }
+
+    // the last reference is only dropped while holding the lock, so that intern() cannot hand
+    // out the entry while it's being removed
+    QMutexLocker locker(tableMutex());
+    if (!entry->ref.deref()) {
+        table().remove(entry->string);
+        delete entry;
+    }
+}
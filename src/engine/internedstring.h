@@ -0,0 +1,93 @@
+#ifndef INTERNEDSTRING_H
+#define INTERNEDSTRING_H
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QString>
+
+#include "metatyperegistry.h"
+
+
+class QScriptEngine;
+class QScriptValue;
+
+// string of which every distinct value is stored only once, so that interned strings can be
+// compared by pointer and hashed without looking at their contents, values are released again
+// once no interned string refers to them anymore
+class InternedString {
+
+    public:
+        InternedString();
+        InternedString(const char *string);
+        InternedString(const QString &string);
+        InternedString(const InternedString &other);
+        ~InternedString();
+
+        InternedString &operator=(const InternedString &other);
+
+        bool isEmpty() const { return m_entry->string.isEmpty(); }
+
+        const QString &toString() const { return m_entry->string; }
+        operator const QString &() const { return m_entry->string; }
+
+        uint hash() const { return m_entry->hash; }
+
+        bool operator==(const InternedString &other) const { return m_entry == other.m_entry; }
+        bool operator!=(const InternedString &other) const { return m_entry != other.m_entry; }
+
+        // orders by identity rather than alphabetically, which is all sorted lookups need
+        bool operator<(const InternedString &other) const {
+            return quintptr(m_entry) < quintptr(other.m_entry);
+        }
+
+        static int numInternedStrings();
+
+        static QScriptValue toScriptValue(QScriptEngine *engine, const InternedString &string);
+        static void fromScriptValue(const QScriptValue &value, InternedString &string);
+
+    private:
+        struct Entry {
+            QString string;
+            uint hash;
+            QAtomicInt ref;
+
+            Entry(const QString &string);
+        };
+
+        Entry *m_entry;
+
+        static QHash<QString, Entry *> &table();
+
+        static Entry *intern(const QString &string);
+        static void release(Entry *entry);
+};
+
+inline InternedString::InternedString(const InternedString &other) :
+    m_entry(other.m_entry) {
+
+    m_entry->ref.ref();
+}
+
+inline InternedString::~InternedString() {
+
+    release(m_entry);
+}
+
+inline InternedString &InternedString::operator=(const InternedString &other) {
+
+    if (m_entry != other.m_entry) {
+        other.m_entry->ref.ref();
+        release(m_entry);
+        m_entry = other.m_entry;
+    }
+    return *this;
+}
+
+inline uint qHash(const InternedString &string) {
+
+    return string.hash();
+}
+
+PT_DECLARE_METATYPE(InternedString)
+
+#endif // INTERNEDSTRING_H
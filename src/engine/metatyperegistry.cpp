@@ -9,6 +9,7 @@
 #include "gameeventmultipliermap.h"
 #include "gameobject.h"
 #include "gameobjectptr.h"
+#include "internedstring.h"
 #include "item.h"
 #include "modifier.h"
 #include "point3d.h"
@@ -78,6 +79,8 @@ void MetaTypeRegistry::registerMetaTypes(QScriptEngine *engine) {
     REGISTER_SERIALIZABLE_META_TYPE(GameObjectPtr)
     REGISTER_SERIALIZABLE_META_LIST_TYPE(GameObjectPtrList)
 
+    REGISTER_META_TYPE(InternedString)
+
     REGISTER_SERIALIZABLE_META_TYPE(ItemFlags)
 
     REGISTER_META_TYPE(Modifier)
@@ -0,0 +1,97 @@
+#include "nameindex.h"
+
+#include <algorithm>
+
+#include "gameobject.h"
+
+
+NameIndex::NameIndex() :
+    m_nextSequence(0),
+    m_nameGeneration(GameObject::nameGeneration()) {
+}
+
+bool NameIndex::add(GameObject *object) {
+
+    if (m_sequences.contains(object)) {
+        return false;
+    }
+
+    // objects are only ever appended, so every token keeps its entries sorted by sequence
+    Entry entry;
+    entry.sequence = m_nextSequence++;
+    entry.object = object;
+    m_sequences.insert(object, entry.sequence);
+
+    for (const QString &token : nameTokens(object->name())) {
+        m_tokens[token].append(entry);
+    }
+    return true;
+}
+
+void NameIndex::remove(GameObject *object) {
+
+    QHash<GameObject *, quint32>::iterator it = m_sequences.find(object);
+    if (it == m_sequences.end()) {
+        return;
+    }
+
+    quint32 sequence = it.value();
+    m_sequences.erase(it);
+
+    for (const QString &token : nameTokens(object->name())) {
+        QMap<QString, QVector<Entry> >::iterator tokenIt = m_tokens.find(token);
+        if (tokenIt == m_tokens.end()) {
+            continue;
+        }
+
+        QVector<Entry> &entries = tokenIt.value();
+        QVector<Entry>::iterator entryIt = std::lower_bound(entries.begin(), entries.end(),
+                                                            sequence,
+                                                            [](const Entry &entry, quint32 sequence) {
+            return entry.sequence < sequence;
+        });
+        if (entryIt != entries.end() && entryIt->sequence == sequence) {
+            entries.erase(entryIt);
+        }
+        if (entries.isEmpty()) {
+            m_tokens.erase(tokenIt);
+        }
+    }
+}
+
+QVector<GameObject *> NameIndex::objectsByName(const QString &prefix) const {
+
+    // tokens sharing a prefix are adjacent in the map
+    QVector<Entry> matches;
+    int numRanges = 0;
+    for (auto it = m_tokens.lowerBound(prefix);
+         it != m_tokens.constEnd() && it.key().startsWith(prefix); ++it) {
+        matches += it.value();
+        numRanges++;
+    }
+
+    if (numRanges > 1) {
+        std::sort(matches.begin(), matches.end(), [](const Entry &first, const Entry &second) {
+            return first.sequence < second.sequence;
+        });
+    }
+
+    QVector<GameObject *> objects;
+    objects.reserve(matches.size());
+    quint32 previousSequence = 0;
+    for (int i = 0; i < matches.size(); i++) {
+        if (i > 0 && matches[i].sequence == previousSequence) {
+            continue;
+        }
+        objects.append(matches[i].object);
+        previousSequence = matches[i].sequence;
+    }
+    return objects;
+}
+
+QStringList NameIndex::nameTokens(const QString &name) {
+
+    QStringList tokens = name.toLower().split(' ');
+    tokens.removeDuplicates();
+    return tokens;
+}
@@ -0,0 +1,45 @@
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+
+class GameObject;
+
+// index from the lowercased words in the names of a list of objects to the objects carrying them,
+// used to find objects by a prefix of one of their words without looking at every name
+class NameIndex {
+
+    public:
+        NameIndex();
+
+        // the index only reflects the names objects had when this generation was current
+        uint nameGeneration() const { return m_nameGeneration; }
+
+        // returns false if the object is indexed already
+        bool add(GameObject *object);
+        void remove(GameObject *object);
+
+        // returns the matching objects in the order in which they were added
+        QVector<GameObject *> objectsByName(const QString &prefix) const;
+
+        static QStringList nameTokens(const QString &name);
+
+    private:
+        struct Entry {
+            quint32 sequence;
+            GameObject *object;
+        };
+
+        QMap<QString, QVector<Entry> > m_tokens;
+        QHash<GameObject *, quint32> m_sequences;
+        quint32 m_nextSequence;
+
+        uint m_nameGeneration;
+};
+
+#endif // NAMEINDEX_H
@@ -0,0 +1,533 @@
+#include "roomgraph.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QScopedArrayPointer>
+
+#include "realm.h"
+
+
+// rooms and the characters in them are indexed per cubic cell of the world, which is what
+// events check when deciding whether anybody could still perceive them, and what proximity
+// queries are answered from
+static const int CellSize = 100;
+
+// when characters are spread over more cells than this, checking them all costs more than it
+// saves and propagation is no longer pruned
+static const int MaxOccupiedCells = 64;
+
+static int cellCoordinate(int coordinate) {
+
+    return (coordinate >= 0 ? coordinate : coordinate - CellSize + 1) / CellSize;
+}
+
+static quint64 cellKey(int x, int y, int z) {
+
+    return (quint64) (x + 0x100000) << 42 | (quint64) (y + 0x100000) << 21 |
+           (quint64) (z + 0x100000);
+}
+
+static quint64 cellKey(const Point3D &position) {
+
+    return cellKey(cellCoordinate(position.x), cellCoordinate(position.y),
+                   cellCoordinate(position.z));
+}
+
+static double distanceToCell(int coordinate, int cellCoordinate) {
+
+    int min = cellCoordinate * CellSize;
+    int max = min + CellSize;
+    return (coordinate < min ? min - coordinate : (coordinate > max ? coordinate - max : 0));
+}
+
+static bool isCellWithinRadius(quint64 cell, int x, int y, int z, double radius) {
+
+    double dx = distanceToCell(x, (int) ((cell >> 42) & 0x1fffff) - 0x100000);
+    double dy = distanceToCell(y, (int) ((cell >> 21) & 0x1fffff) - 0x100000);
+    double dz = distanceToCell(z, (int) (cell & 0x1fffff) - 0x100000);
+    return dx * dx + dy * dy + dz * dz <= radius * radius;
+}
+
+// frontiers smaller than this are not worth splitting over multiple threads
+static const int MinChunkSize = 256;
+
+static quint64 visibilityKey(GameEventType eventType, int origin, int destination) {
+
+    return (quint64) eventType.value << 56 | (quint64) origin << 28 | (quint64) (destination + 1);
+}
+
+class ChunkRunnable : public QRunnable {
+
+    public:
+        ChunkRunnable(const std::function<void (int chunk)> &function, int chunk) :
+            QRunnable(),
+            m_function(function),
+            m_chunk(chunk) {
+        }
+
+        virtual void run() {
+
+            m_function(m_chunk);
+        }
+
+    private:
+        const std::function<void (int chunk)> &m_function;
+        int m_chunk;
+};
+
+
+RoomGraph::RoomGraph(Realm *realm) :
+    m_realm(realm),
+    m_valid(false),
+    m_visibilityTables(1 << 20),
+    m_visibilityTablesEnabled(true),
+    m_parallelThreshold(10000) {
+
+    clearCaches();
+}
+
+RoomGraph::~RoomGraph() {
+}
+
+void RoomGraph::invalidate() {
+
+    m_valid = false;
+    clearCaches();
+}
+
+void RoomGraph::validate() {
+
+    if (!m_valid) {
+        rebuild();
+    }
+}
+
+void RoomGraph::updateRoom(Room *room) {
+
+    if (!m_valid) {
+        return;
+    }
+
+    int index = room->graphIndex();
+    if (index < 0 || index >= m_rooms.size() || m_rooms[index] != room) {
+        invalidate();
+        return;
+    }
+
+    quint64 cell = m_cells[index];
+    setRoomAttributes(index, room);
+    if (m_cells[index] != cell) {
+        QVector<int> &cellRooms = m_cellRooms[cell];
+        cellRooms.remove(cellRooms.indexOf(index));
+        if (cellRooms.isEmpty()) {
+            m_cellRooms.remove(cell);
+        }
+        m_cellRooms[m_cells[index]].append(index);
+
+        addCellOccupancy(cell, -m_occupancy[index]);
+        addCellOccupancy(m_cells[index], m_occupancy[index]);
+    }
+
+    clearCaches();
+
+    // portal multipliers depend on the distance between the rooms they connect, so the edges
+    // in both directions need to be refreshed
+    for (int i = m_offsets[index]; i < m_offsets[index + 1]; i++) {
+        Edge &edge = m_edges[i];
+        setEdgeAttributes(edge, edge.portal);
+        updateEdges(edge.oppositeRoom, edge.portal);
+    }
+}
+
+void RoomGraph::updatePortal(Portal *portal) {
+
+    if (!m_valid) {
+        return;
+    }
+
+    clearCaches();
+
+    Room *room1 = portal->room().unsafeCast<Room *>();
+    Room *room2 = portal->room2().unsafeCast<Room *>();
+    if (room1) {
+        updateEdges(room1->graphIndex(), portal);
+    }
+    if (room2 && room2 != room1) {
+        updateEdges(room2->graphIndex(), portal);
+    }
+}
+
+void RoomGraph::updateOccupancy(Room *room) {
+
+    if (!m_valid) {
+        return;
+    }
+
+    int index = room->graphIndex();
+    if (index < 0 || index >= m_rooms.size() || m_rooms[index] != room) {
+        invalidate();
+        return;
+    }
+
+    int occupancy = room->characters().length();
+    if (m_occupancy[index] != occupancy) {
+        addCellOccupancy(m_cells[index], occupancy - m_occupancy[index]);
+        m_occupancy[index] = occupancy;
+    }
+}
+
+bool RoomGraph::hasOccupantsWithinReach(int index, GameEventType eventType,
+                                        double strength) const {
+
+    if (m_cellOccupancy.size() > MaxOccupiedCells) {
+        return true;
+    }
+
+    double rate = decayRate(eventType);
+    if (rate <= 0.0) {
+        return true;
+    }
+
+    // strength decays at least exponentially with the distance traveled, and the distance
+    // traveled is no shorter than the distance as the crow flies
+    double reach = log(strength / 0.1) / rate;
+    if (reach < 0.0) {
+        return false;
+    }
+
+    int x = m_x[index], y = m_y[index], z = m_z[index];
+    for (auto it = m_cellOccupancy.constBegin(); it != m_cellOccupancy.constEnd(); ++it) {
+        if (isCellWithinRadius(it.key(), x, y, z, reach)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QVector<int> RoomGraph::roomsWithin(const Point3D &point, int radius) const {
+
+    QVector<int> rooms;
+    if (radius < 0) {
+        return rooms;
+    }
+
+    int minX = cellCoordinate(point.x - radius), maxX = cellCoordinate(point.x + radius);
+    int minY = cellCoordinate(point.y - radius), maxY = cellCoordinate(point.y + radius);
+    int minZ = cellCoordinate(point.z - radius), maxZ = cellCoordinate(point.z + radius);
+
+    QVector<quint64> cells;
+    double numCells = (double) (maxX - minX + 1) * (maxY - minY + 1) * (maxZ - minZ + 1);
+    if (numCells > m_cellRooms.size()) {
+        // the radius is so large it's cheaper to check every cell that contains any rooms
+        for (auto it = m_cellRooms.constBegin(); it != m_cellRooms.constEnd(); ++it) {
+            if (isCellWithinRadius(it.key(), point.x, point.y, point.z, radius)) {
+                cells.append(it.key());
+            }
+        }
+    } else {
+        for (int x = minX; x <= maxX; x++) {
+            for (int y = minY; y <= maxY; y++) {
+                for (int z = minZ; z <= maxZ; z++) {
+                    quint64 cell = cellKey(x, y, z);
+                    if (m_cellRooms.contains(cell) &&
+                        isCellWithinRadius(cell, point.x, point.y, point.z, radius)) {
+                        cells.append(cell);
+                    }
+                }
+            }
+        }
+    }
+
+    double radiusSquared = (double) radius * radius;
+    for (quint64 cell : cells) {
+        for (int index : m_cellRooms[cell]) {
+            double dx = m_x[index] - point.x;
+            double dy = m_y[index] - point.y;
+            double dz = m_z[index] - point.z;
+            if (dx * dx + dy * dy + dz * dz <= radiusSquared) {
+                rooms.append(index);
+            }
+        }
+    }
+
+    std::sort(rooms.begin(), rooms.end());
+    return rooms;
+}
+
+void RoomGraph::setParallelThreshold(int parallelThreshold) {
+
+    m_parallelThreshold = parallelThreshold;
+}
+
+void RoomGraph::setVisibilityTablesEnabled(bool enabled) {
+
+    m_visibilityTablesEnabled = enabled;
+}
+
+QVector<int> RoomGraph::reachableRooms(int origin, const EdgeFilter &filter) const {
+
+    QScopedArrayPointer<QAtomicInt> claimed(new QAtomicInt[m_rooms.size()]);
+    claimed[origin].testAndSetRelaxed(0, 1);
+
+    QVector<int> rooms;
+    QVector<int> frontier;
+    frontier.append(origin);
+
+    // the search is expanded one level at a time, with every level split over the worker
+    // threads, and every level is sorted so that the result doesn't depend on which thread
+    // happened to claim a room first
+    while (!frontier.isEmpty()) {
+        rooms += frontier;
+
+        int numChunks = qBound(1, frontier.size() / MinChunkSize, m_threadPool.maxThreadCount());
+        QVector<QVector<int> > next(numChunks);
+
+        const int *frontierData = frontier.constData();
+        int frontierSize = frontier.size();
+        QVector<int> *nextData = next.data();
+        runInParallel(numChunks, [&](int chunk) {
+            int begin = frontierSize * chunk / numChunks;
+            int end = frontierSize * (chunk + 1) / numChunks;
+            for (int i = begin; i < end; i++) {
+                for (const Edge &edge : edges(frontierData[i])) {
+                    if (filter(edge) && claimed[edge.oppositeRoom].testAndSetRelaxed(0, 1)) {
+                        nextData[chunk].append(edge.oppositeRoom);
+                    }
+                }
+            }
+        });
+
+        frontier.clear();
+        for (const QVector<int> &chunk : next) {
+            frontier += chunk;
+        }
+        std::sort(frontier.begin(), frontier.end());
+    }
+
+    return rooms;
+}
+
+const RoomGraph::VisibilityTable *RoomGraph::visibilityTable(GameEventType eventType, int origin,
+                                                             int destination) const {
+
+    return m_visibilityTables.object(visibilityKey(eventType, origin, destination));
+}
+
+void RoomGraph::insertVisibilityTable(GameEventType eventType, int origin, int destination,
+                                      VisibilityTable *table) const {
+
+    // tables are weighed by the number of rooms they contain, so that the cache holds a bounded
+    // number of entries no matter how far the views from the cached rooms reach
+    m_visibilityTables.insert(visibilityKey(eventType, origin, destination), table,
+                              table->entries.size() + 1);
+}
+
+void RoomGraph::rebuild() {
+
+    // events that are being fired while the graph is rebuilt keep using the indices they already
+    // obtained, so rooms keep their index and slots of rooms that have been removed from the realm
+    // become tombstones that have no edges and are never reused
+    QVector<Room *> previousRooms = m_rooms;
+    m_rooms.fill(nullptr);
+
+    QHash<Room *, int> indices;
+    for (const GameObjectPtr &roomPtr : m_realm->rooms()) {
+        Room *room = roomPtr.unsafeCast<Room *>();
+        int index = room->graphIndex();
+        if (index < 0 || index >= previousRooms.size() || previousRooms[index] != room) {
+            index = m_rooms.size();
+            room->setGraphIndex(index);
+            m_rooms.append(room);
+        } else {
+            m_rooms[index] = room;
+        }
+        indices.insert(room, index);
+    }
+
+    int numRooms = m_rooms.size();
+
+    m_x.resize(numRooms);
+    m_y.resize(numRooms);
+    m_z.resize(numRooms);
+    m_flags.resize(numRooms);
+    m_multipliers.resize(numRooms * GameEventType::NumValues);
+    m_occupancy.resize(numRooms);
+    m_cells.resize(numRooms);
+    m_cellRooms.clear();
+    m_cellOccupancy.clear();
+
+    for (int i = 0; i < numRooms; i++) {
+        Room *room = m_rooms[i];
+        if (!room) {
+            m_flags[i] = RoomFlags::NoFlags;
+            std::fill_n(m_multipliers.data() + i * GameEventType::NumValues,
+                        (int) GameEventType::NumValues, 0.0);
+            m_occupancy[i] = 0;
+            continue;
+        }
+
+        setRoomAttributes(i, room);
+        m_cellRooms[m_cells[i]].append(i);
+
+        m_occupancy[i] = room->characters().length();
+        addCellOccupancy(m_cells[i], m_occupancy[i]);
+    }
+
+    m_offsets.resize(numRooms + 1);
+    m_edges.clear();
+
+    for (int i = 0; i < numRooms; i++) {
+        m_offsets[i] = m_edges.size();
+
+        Room *room = m_rooms[i];
+        if (!room) {
+            continue;
+        }
+
+        for (const GameObjectPtr &portalPtr : room->portals()) {
+            Portal *portal = portalPtr.unsafeCast<Portal *>();
+            Room *room1 = portal->room().unsafeCast<Room *>();
+            Room *room2 = portal->room2().unsafeCast<Room *>();
+            if (!room1 || !room2) {
+                continue;
+            }
+
+            int oppositeIndex = indices.value(room == room1 ? room2 : room1, -1);
+            if (oppositeIndex < 0) {
+                continue;
+            }
+
+            Edge edge;
+            edge.oppositeRoom = oppositeIndex;
+            edge.portal = portal;
+            setEdgeAttributes(edge, portal);
+            m_edges.append(edge);
+        }
+    }
+    m_offsets[numRooms] = m_edges.size();
+
+    m_valid = true;
+}
+
+void RoomGraph::setRoomAttributes(int index, Room *room) {
+
+    const Point3D &position = room->position();
+    m_x[index] = position.x;
+    m_y[index] = position.y;
+    m_z[index] = position.z;
+
+    m_cells[index] = cellKey(position);
+    m_flags[index] = room->flags();
+
+    double *multipliers = m_multipliers.data() + index * GameEventType::NumValues;
+    for (int i = 0; i < GameEventType::NumValues; i++) {
+        multipliers[i] = room->eventMultiplier((GameEventType::Values) i);
+    }
+}
+
+void RoomGraph::setEdgeAttributes(Edge &edge, Portal *portal) {
+
+    edge.flags = portal->flags();
+
+    for (int i = 0; i < GameEventType::NumValues; i++) {
+        edge.multipliers[i] = portal->eventMultiplier((GameEventType::Values) i);
+    }
+}
+
+void RoomGraph::updateEdges(int index, Portal *portal) {
+
+    if (index < 0 || index >= m_rooms.size()) {
+        return;
+    }
+
+    for (int i = m_offsets[index]; i < m_offsets[index + 1]; i++) {
+        Edge &edge = m_edges[i];
+        if (edge.portal == portal) {
+            setEdgeAttributes(edge, portal);
+        }
+    }
+}
+
+void RoomGraph::clearCaches() {
+
+    m_visibilityTables.clear();
+
+    for (int i = 0; i < GameEventType::NumValues; i++) {
+        m_decayRates[i] = -1.0;
+    }
+}
+
+void RoomGraph::addCellOccupancy(quint64 cell, int delta) {
+
+    if (delta == 0) {
+        return;
+    }
+
+    int occupancy = m_cellOccupancy.value(cell) + delta;
+    if (occupancy > 0) {
+        m_cellOccupancy[cell] = occupancy;
+    } else {
+        m_cellOccupancy.remove(cell);
+    }
+}
+
+double RoomGraph::decayRate(GameEventType eventType) const {
+
+    double &rate = m_decayRates[eventType.value];
+    if (rate >= 0.0) {
+        return rate;
+    }
+
+    // the lowest attenuation per unit of distance over all portals, or zero if there are
+    // portals or rooms through which events don't weaken at all
+    rate = HUGE_VAL;
+    for (int i = 0; i < m_rooms.size() && rate > 0.0; i++) {
+        if (eventMultiplier(i, eventType) > 1.0) {
+            rate = 0.0;
+            break;
+        }
+
+        for (const Edge &edge : edges(i)) {
+            double multiplier = edge.multipliers[eventType.value];
+            if (multiplier <= 0.0) {
+                continue;
+            }
+
+            // amplifying portals strengthen events even when they don't span any distance
+            if (multiplier > 1.0) {
+                rate = 0.0;
+                break;
+            }
+
+            double dx = m_x[edge.oppositeRoom] - m_x[i];
+            double dy = m_y[edge.oppositeRoom] - m_y[i];
+            double dz = m_z[edge.oppositeRoom] - m_z[i];
+            double length = sqrt(dx * dx + dy * dy + dz * dz);
+            if (length == 0.0) {
+                continue;
+            }
+
+            if (multiplier >= 1.0) {
+                rate = 0.0;
+                break;
+            }
+            rate = qMin(rate, -log(multiplier) / length);
+        }
+    }
+    return rate;
+}
+
+void RoomGraph::runInParallel(int numChunks,
+                              const std::function<void (int chunk)> &function) const {
+
+    for (int i = 1; i < numChunks; i++) {
+        m_threadPool.start(new ChunkRunnable(function, i));
+    }
+
+    function(0);
+
+    m_threadPool.waitForDone();
+}
@@ -0,0 +1,179 @@
+#ifndef ROOMGRAPH_H
+#define ROOMGRAPH_H
+
+#include <functional>
+
+#include <QCache>
+#include <QHash>
+#include <QThreadPool>
+#include <QVector>
+
+#include "gameevent.h"
+#include "point3d.h"
+#include "portal.h"
+#include "room.h"
+
+
+class Realm;
+
+class RoomGraph {
+
+    public:
+        class Edge {
+            public:
+                int oppositeRoom;
+                PortalFlags flags;
+                double multipliers[GameEventType::NumValues];
+                Portal *portal;
+
+                bool isOpen() const {
+                    return flags & PortalFlags::IsOpen;
+                }
+                bool canSeeThrough() const {
+                    return flags & (isOpen() ? PortalFlags::CanSeeThroughIfOpen :
+                                               PortalFlags::CanSeeThrough);
+                }
+                bool canHearThrough() const {
+                    return flags & (isOpen() ? PortalFlags::CanHearThroughIfOpen :
+                                               PortalFlags::CanHearThrough);
+                }
+                bool canPassThrough() const {
+                    return flags & (isOpen() ? PortalFlags::CanPassThroughIfOpen :
+                                               PortalFlags::CanPassThrough);
+                }
+        };
+
+        class EdgeRange {
+            public:
+                EdgeRange(const Edge *begin, const Edge *end) :
+                    m_begin(begin),
+                    m_end(end) {
+                }
+
+                const Edge *begin() const { return m_begin; }
+                const Edge *end() const { return m_end; }
+
+            private:
+                const Edge *m_begin;
+                const Edge *m_end;
+        };
+
+        class VisibilityTable {
+            public:
+                class Entry {
+                    public:
+                        int room;
+                        double strength;
+                };
+
+                bool isComplete;
+                double minStrength; // weakest strength at which a room was reached
+                double maxPrunedStrength; // strongest propagation that was cut off
+                QVector<Entry> entries;
+
+                VisibilityTable() :
+                    isComplete(true),
+                    minStrength(1.0),
+                    maxPrunedStrength(0.0) {
+                }
+
+                // returns whether an event of the given strength reaches exactly the rooms in
+                // the table, so that it reaches no more rooms and loses none of them to the
+                // 0.1 cutoff
+                bool isExactFor(double strength) const {
+                    return strength * minStrength >= 0.1 && strength * maxPrunedStrength < 0.1;
+                }
+        };
+
+        typedef std::function<bool (const Edge &edge)> EdgeFilter;
+
+        RoomGraph(Realm *realm);
+        ~RoomGraph();
+
+        bool isValid() const { return m_valid; }
+        void invalidate();
+        void validate();
+
+        void updateRoom(Room *room);
+        void updatePortal(Portal *portal);
+        void updateOccupancy(Room *room);
+
+        int numRooms() const { return m_rooms.size(); }
+        int numEdges() const { return m_edges.size(); }
+
+        // returns null for the index of a room that has been removed from the realm
+        Room *room(int index) const { return m_rooms[index]; }
+
+        Point3D position(int index) const { return Point3D(m_x[index], m_y[index], m_z[index]); }
+        RoomFlags flags(int index) const { return m_flags[index]; }
+        double eventMultiplier(int index, GameEventType eventType) const {
+            return m_multipliers[index * GameEventType::NumValues + eventType.value];
+        }
+
+        EdgeRange edges(int index) const {
+            const Edge *edges = m_edges.constData();
+            return EdgeRange(edges + m_offsets[index], edges + m_offsets[index + 1]);
+        }
+
+        int occupancy(int index) const { return m_occupancy[index]; }
+        bool hasOccupantsWithinReach(int index, GameEventType eventType, double strength) const;
+
+        QVector<int> roomsWithin(const Point3D &point, int radius) const;
+
+        int parallelThreshold() const { return m_parallelThreshold; }
+        void setParallelThreshold(int parallelThreshold);
+
+        bool visibilityTablesEnabled() const { return m_visibilityTablesEnabled; }
+        void setVisibilityTablesEnabled(bool enabled);
+
+        QVector<int> reachableRooms(int origin, const EdgeFilter &filter) const;
+
+        const VisibilityTable *visibilityTable(GameEventType eventType, int origin,
+                                               int destination = -1) const;
+        void insertVisibilityTable(GameEventType eventType, int origin, int destination,
+                                   VisibilityTable *table) const;
+
+    private:
+        void rebuild();
+
+        void setRoomAttributes(int index, Room *room);
+        void setEdgeAttributes(Edge &edge, Portal *portal);
+        void updateEdges(int index, Portal *portal);
+
+        void clearCaches();
+
+        void addCellOccupancy(quint64 cell, int delta);
+        double decayRate(GameEventType eventType) const;
+
+        void runInParallel(int numChunks, const std::function<void (int chunk)> &function) const;
+
+        Realm *m_realm;
+
+        bool m_valid;
+
+        QVector<Room *> m_rooms;
+
+        QVector<int> m_x;
+        QVector<int> m_y;
+        QVector<int> m_z;
+        QVector<RoomFlags> m_flags;
+        QVector<double> m_multipliers;
+        QVector<int> m_occupancy;
+        QVector<quint64> m_cells;
+
+        QHash<quint64, QVector<int> > m_cellRooms;
+        QHash<quint64, int> m_cellOccupancy;
+
+        mutable double m_decayRates[GameEventType::NumValues];
+
+        QVector<int> m_offsets;
+        QVector<Edge> m_edges;
+
+        mutable QCache<quint64, VisibilityTable> m_visibilityTables;
+        bool m_visibilityTablesEnabled;
+
+        int m_parallelThreshold;
+        mutable QThreadPool m_threadPool;
+};
+
+#endif // ROOMGRAPH_H
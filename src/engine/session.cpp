@@ -1,5 +1,8 @@
 #include "session.h"
 
+#include <QDateTime>
+#include <QTimer>
+
 #include "commandevent.h"
 #include "constants.h"
 #include "gameexception.h"
@@ -12,12 +15,24 @@
 #include "util.h"
 
 
+QAtomicInt Session::s_numThrottledCommands(0);
+QAtomicInt Session::s_numDroppedCommands(0);
+QAtomicInt Session::s_numDeferredSignIns(0);
+
 Session::Session(Realm *realm, const QString &description, const QString &source, QObject *parent) :
     QObject(parent),
     m_source(source),
+    m_encoding(EncodedMessage::WebSocketEncoding),
     m_sessionState(SessionClosed),
     m_realm(realm),
-    m_player(nullptr) {
+    m_player(nullptr),
+    m_inputTokens(inputLimits().commandBurst),
+    m_lastInputTimestamp(QDateTime::currentMSecsSinceEpoch()),
+    m_throttleNotified(false) {
+
+    m_inputTimer = new QTimer(this);
+    m_inputTimer->setSingleShot(true);
+    connect(m_inputTimer, SIGNAL(timeout()), SLOT(onInputTimer()));
 
     LogUtil::logSessionEvent(m_source, QString("Session opened (%1)").arg(description));
 }
@@ -132,9 +147,19 @@ void Session::setPlayer(GameObject *player) {
     }
 }
 
+void Session::setEncoding(EncodedMessage::Encoding encoding) {
+
+    m_encoding = encoding;
+}
+
 void Session::send(const QString &message) {
 
-    emit write(message);
+    emit write(EncodedMessage::encode(message, m_encoding));
+}
+
+void Session::send(const EncodedMessage &message) {
+
+    emit write(message.encoded(m_encoding));
 }
 
 void Session::onUserInput(QString data) {
@@ -152,6 +177,84 @@ void Session::onUserInput(QString data) {
         data = data.left(160);
     }
 
+    if (!m_pendingInput.isEmpty() || !admitInput()) {
+        if (m_sessionState == SigningIn) {
+            s_numDeferredSignIns.ref();
+        } else {
+            s_numThrottledCommands.ref();
+        }
+
+        const InputLimits &limits = inputLimits();
+        if (m_pendingInput.length() >= limits.maxPendingCommands) {
+            s_numDroppedCommands.ref();
+            if (limits.disconnectOnOverflow) {
+                LogUtil::logSessionEvent(m_source, "Input overflow, disconnecting");
+                send("You are sending too many commands. Disconnecting.\n");
+                setSessionState(SessionClosed);
+                return;
+            }
+        } else {
+            m_pendingInput.enqueue(data);
+        }
+
+        if (!m_throttleNotified) {
+            send(m_sessionState == SigningIn ? "The server is busy, please wait a moment...\n" :
+                                               "You are sending commands too fast, slow down!\n");
+            m_throttleNotified = true;
+        }
+
+        if (!m_inputTimer->isActive()) {
+            m_inputTimer->start(qMax(int(1000 / limits.commandsPerSecond), 10));
+        }
+        return;
+    }
+
+    dispatchInput(data);
+}
+
+void Session::onInputTimer() {
+
+    while (!m_pendingInput.isEmpty() && admitInput()) {
+        dispatchInput(m_pendingInput.dequeue());
+    }
+
+    if (m_pendingInput.isEmpty()) {
+        m_throttleNotified = false;
+    } else {
+        m_inputTimer->start(qMax(int(1000 / inputLimits().commandsPerSecond), 10));
+    }
+}
+
+bool Session::admitInput() {
+
+    const InputLimits &limits = inputLimits();
+
+    // defer sign-ins while the game thread is lagging, so that players who are already playing
+    // don't suffer even more when many people connect at once
+    if (m_sessionState == SigningIn &&
+        m_realm->gameThread()->queueLatency() > limits.maxQueueLatency) {
+        return false;
+    }
+
+    if (m_player && m_player->isAdmin()) {
+        return true;
+    }
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    m_inputTokens = qMin(m_inputTokens + limits.commandsPerSecond * (now - m_lastInputTimestamp) /
+                                         1000.0, (double) limits.commandBurst);
+    m_lastInputTimestamp = now;
+
+    if (m_inputTokens < 1.0) {
+        return false;
+    }
+
+    m_inputTokens -= 1.0;
+    return true;
+}
+
+void Session::dispatchInput(const QString &data) {
+
     if (m_sessionState == SignedIn) {
         m_realm->enqueueEvent(new CommandEvent(m_player, data));
     } else {
@@ -159,6 +262,33 @@ void Session::onUserInput(QString data) {
     }
 }
 
+const Session::InputLimits &Session::inputLimits() {
+
+    static InputLimits limits;
+    static bool initialized = false;
+    if (!initialized) {
+        limits.commandsPerSecond = qgetenv("PT_COMMANDS_PER_SECOND").toDouble();
+        if (limits.commandsPerSecond <= 0.0) {
+            limits.commandsPerSecond = 10.0;
+        }
+        limits.commandBurst = qgetenv("PT_COMMAND_BURST").toInt();
+        if (limits.commandBurst <= 0) {
+            limits.commandBurst = 20;
+        }
+        limits.maxPendingCommands = qgetenv("PT_MAX_PENDING_COMMANDS").toInt();
+        if (limits.maxPendingCommands <= 0) {
+            limits.maxPendingCommands = 50;
+        }
+        limits.disconnectOnOverflow = (qgetenv("PT_INPUT_OVERFLOW") == "disconnect");
+        limits.maxQueueLatency = qgetenv("PT_MAX_QUEUE_LATENCY").toInt();
+        if (limits.maxQueueLatency <= 0) {
+            limits.maxQueueLatency = 250;
+        }
+        initialized = true;
+    }
+    return limits;
+}
+
 QScriptValue Session::toScriptValue(QScriptEngine *engine, Session *const &session) {
 
     return engine->newQObject(session, QScriptEngine::QtOwnership,
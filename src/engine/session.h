@@ -1,14 +1,18 @@
 #ifndef SESSION_H
 #define SESSION_H
 
+#include <QAtomicInt>
 #include <QObject>
+#include <QQueue>
 #include <QScriptEngine>
 
+#include "encodedmessage.h"
 #include "metatyperegistry.h"
 
 
 class GameObject;
 class Player;
+class QTimer;
 class Realm;
 
 class Session : public QObject {
@@ -41,7 +45,25 @@ class Session : public QObject {
         Player *player() const { return m_player; }
         Q_INVOKABLE void setPlayer(GameObject *player);
 
+        EncodedMessage::Encoding encoding() const { return m_encoding; }
+        void setEncoding(EncodedMessage::Encoding encoding);
+
         Q_INVOKABLE void send(const QString &message);
+        void send(const EncodedMessage &message);
+
+        struct InputLimits {
+            double commandsPerSecond;
+            int commandBurst;
+            int maxPendingCommands;
+            bool disconnectOnOverflow;
+            int maxQueueLatency;
+        };
+
+        static const InputLimits &inputLimits();
+
+        static int numThrottledCommands() { return s_numThrottledCommands.fetchAndAddRelaxed(0); }
+        static int numDroppedCommands() { return s_numDroppedCommands.fetchAndAddRelaxed(0); }
+        static int numDeferredSignIns() { return s_numDeferredSignIns.fetchAndAddRelaxed(0); }
 
         static QScriptValue toScriptValue(QScriptEngine *engine, Session *const&session);
         static void fromScriptValue(const QScriptValue &object, Session *&session);
@@ -49,13 +71,17 @@ class Session : public QObject {
     public slots:
         void onUserInput(QString data);
 
+    private slots:
+        void onInputTimer();
+
     signals:
-        void write(const QString &data);
+        void write(const QByteArray &data);
 
         void terminate();
 
     private:
         QString m_source;
+        EncodedMessage::Encoding m_encoding;
 
         SessionState m_sessionState;
 
@@ -63,6 +89,19 @@ class Session : public QObject {
         Player *m_player;
 
         QScriptValue m_scriptObject;
+
+        double m_inputTokens;
+        qint64 m_lastInputTimestamp;
+        QQueue<QString> m_pendingInput;
+        QTimer *m_inputTimer;
+        bool m_throttleNotified;
+
+        static QAtomicInt s_numThrottledCommands;
+        static QAtomicInt s_numDroppedCommands;
+        static QAtomicInt s_numDeferredSignIns;
+
+        bool admitInput();
+        void dispatchInput(const QString &data);
 };
 
 PT_DECLARE_METATYPE(Session *)
@@ -62,6 +62,12 @@ TriggerRegistry::TriggerRegistry(QObject *parent) :
     m_triggers.insert("onitemdropped(item : item, owner : character) : void",
                       "The onitemdropped trigger is invoked on all characters in a room when an "
                       "item is dropped in that room.");
+    m_triggers.insert("onlook(activator : character) : string",
+                      "The onlook trigger may be defined on individual rooms, and is invoked when "
+                      "a character looks around in the room, for example after entering it. If "
+                      "the trigger returns a string, it is used as the description of the room "
+                      "instead of the generated description. Any other return value falls back "
+                      "to the generated description.");
     m_triggers.insert("onopen(activator : character) : bool",
                       "The onopen trigger is invoked on any item or exit when it's opened.");
     m_triggers.insert("onreceive(giver : character, item : item or amount) : bool",
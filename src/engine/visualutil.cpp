@@ -0,0 +1,636 @@
+#include "visualutil.h"
+
+#include <cmath>
+
+#include <QStringList>
+
+#include "character.h"
+#include "gameevent.h"
+#include "group.h"
+#include "item.h"
+#include "portal.h"
+#include "realm.h"
+#include "room.h"
+#include "util.h"
+
+
+static const double UNDER_QUART_PI = TAU / 8.02;
+static const double OVER_QUART_PI = TAU / 7.98;
+
+static const char *groupPrefixes[] = {
+    "To your left",
+    "To your right",
+    "Ahead of you, there",
+    "Behind you",
+    "There",
+    "Above you",
+    "On the left wall",
+    "On the right wall",
+    "On the wall",
+    "From the ceiling"
+};
+
+static const char *groupVerbs[][2] = {
+    { "is", "are" },
+    { "is", "are" },
+    { "is", "are" },
+    { "is", "are" },
+    { "is", "are" },
+    { "is", "are" },
+    { "hangs", "hang" },
+    { "hangs", "hang" },
+    { "hangs", "hang" },
+    { "hangs", "hang" }
+};
+
+static double vectorLength(const Vector3D &vector) {
+
+    return sqrt(vector.x * vector.x + vector.y * vector.y + vector.z * vector.z);
+}
+
+QString VisualUtil::describeRoom(Room *room, Character *character) {
+
+    QString text;
+
+    if (!room->name().isEmpty()) {
+        text += "\n" + Util::colorize(room->name(), Teal) + "\n\n";
+    }
+
+    bool hasDynamicPortals = !(room->flags() & RoomFlags::OmitDynamicPortalsFromDescription);
+    bool hasDistantCharacters =
+        !(room->flags() & RoomFlags::OmitDistantCharactersFromDescription);
+
+    GameObjectPtrList itemGroups[NumGroups];
+    divideItemsIntoGroups(room->items(), character->direction(), itemGroups);
+
+    GameObjectPtrList portalGroups[NumGroups];
+    CharacterInfoList characters;
+    bool hasCharacters = false;
+    if (hasDynamicPortals || hasDistantCharacters) {
+        hasCharacters = dividePortalsAndCharactersIntoGroups(character, room, portalGroups,
+                                                             characters);
+    }
+
+    QStringList itemTexts;
+    for (int group = 0; group < NumGroups; group++) {
+        const GameObjectPtrList &itemGroup = itemGroups[group];
+        if (itemGroup.isEmpty() && !(hasDynamicPortals && !portalGroups[group].isEmpty())) {
+            continue;
+        }
+
+        bool plural = firstItemIsPlural(itemGroup);
+
+        QStringList combinedItems = Util::combinePtrList(itemGroup);
+        if (hasDynamicPortals) {
+            for (const GameObjectPtr &portal : portalGroups[group]) {
+                combinedItems.append(nameWithDestinationFromRoom(portal.unsafeCast<Portal *>(),
+                                                                 room));
+            }
+        }
+
+        QString itemText = QString("%1 %2 %3.").arg(groupPrefixes[group],
+                                                    groupVerbs[group][plural ? 1 : 0],
+                                                    Util::joinFancy(combinedItems));
+        int index = itemText.indexOf("there is");
+        if (index > -1) {
+            itemText.replace(index, 8, "there's");
+        }
+        itemTexts.append(itemText);
+    }
+
+    QString characterText;
+    if (hasDistantCharacters && hasCharacters) {
+        characterText = describeCharactersRelativeTo(characters, character);
+    }
+
+    text += room->description();
+    if (!itemTexts.isEmpty()) {
+        if (!text.endsWith(" ") && !text.endsWith("\n")) {
+            text += " ";
+        }
+        text += itemTexts.join(" ");
+    }
+    if (!characterText.isEmpty()) {
+        if (!text.endsWith(" ") && !text.endsWith("\n")) {
+            text += " ";
+        }
+        text += characterText;
+    }
+    text += "\n";
+
+    QStringList exitNames;
+    for (const GameObjectPtr &portalPtr : room->portals()) {
+        Portal *portal = portalPtr.unsafeCast<Portal *>();
+        if (!portal->isHiddenFromRoom(room)) {
+            exitNames.append(portal->nameFromRoom(room));
+        }
+    }
+    if (!exitNames.isEmpty()) {
+        exitNames = Util::sortExitNames(exitNames);
+        text += Util::colorize("Obvious exits: " + exitNames.join(", ") + ".", Green) + "\n";
+    }
+
+    GameObjectPtrList others = room->characters();
+    others.removeOne(character);
+    if (!others.isEmpty()) {
+        text += QString("You see %1.\n").arg(Util::joinPtrList(others));
+    }
+
+    return text;
+}
+
+void VisualUtil::divideItemsIntoGroups(const GameObjectPtrList &items, const Vector3D &direction,
+                                       GameObjectPtrList groups[NumGroups]) {
+
+    for (const GameObjectPtr &itemPtr : items) {
+        Item *item = itemPtr.unsafeCast<Item *>();
+        if (item->isHidden()) {
+            continue;
+        }
+
+        const Point3D &position = item->position();
+        bool isCentered = (position.x == 0 && position.y == 0);
+        double angle = Util::angleBetweenXYVectors(direction,
+                                                   Vector3D(position.x, position.y, position.z));
+
+        if (item->flags() & ItemFlags::AttachedToCeiling) {
+            groups[Ceiling].append(item);
+        } else if (item->flags() & ItemFlags::AttachedToWall) {
+            if (isCentered ||
+                fabs(angle) > 3 * OVER_QUART_PI || fabs(angle) < UNDER_QUART_PI) {
+                groups[Wall].append(item);
+            } else if (angle > 0) {
+                groups[RightWall].append(item);
+            } else {
+                groups[LeftWall].append(item);
+            }
+        } else if (isCentered) {
+            groups[Center].append(item);
+        } else {
+            if (fabs(angle) > 3 * OVER_QUART_PI) {
+                groups[Behind].append(item);
+            } else if (fabs(angle) < UNDER_QUART_PI) {
+                groups[Ahead].append(item);
+            } else if (angle > 0) {
+                groups[Right].append(item);
+            } else {
+                groups[Left].append(item);
+            }
+        }
+    }
+}
+
+bool VisualUtil::dividePortalsAndCharactersIntoGroups(Character *character, Room *room,
+                                                      GameObjectPtrList groups[NumGroups],
+                                                      CharacterInfoList &characters) {
+
+    bool hasCharacters = false;
+    for (const GameObjectPtr &portalPtr : room->portals()) {
+        Portal *portal = portalPtr.unsafeCast<Portal *>();
+        if (portal->isHiddenFromRoom(room)) {
+            continue;
+        }
+
+        Vector3D position = portal->position() - room->position();
+        double angle = Util::angleBetweenXYVectors(character->direction(), position);
+
+        // only the characters seen through the last portal ahead are described
+        if (portal->canSeeThrough() && fabs(angle) < UNDER_QUART_PI) {
+            characters = charactersVisibleThroughPortal(character, room, portal);
+            hasCharacters = true;
+        }
+
+        QString name = portal->nameFromRoom(room);
+        if (Util::isDirection(name) || name == "out") {
+            continue;
+        }
+
+        if (fabs(angle) > 3 * OVER_QUART_PI) {
+            groups[Behind].append(portal);
+        } else if (fabs(angle) < UNDER_QUART_PI) {
+            groups[Ahead].append(portal);
+        } else if (angle > 0) {
+            groups[Right].append(portal);
+        } else {
+            groups[Left].append(portal);
+        }
+    }
+    return hasCharacters;
+}
+
+VisualUtil::CharacterInfoList VisualUtil::charactersVisibleThroughPortal(Character *character,
+                                                                         Room *sourceRoom,
+                                                                         Portal *portal,
+                                                                         double strength) {
+
+    CharacterInfoList characters;
+    QSet<GameObject *> visitedRooms;
+    charactersVisibleThroughPortal(character, sourceRoom, portal, strength, visitedRooms,
+                                   characters);
+    return characters;
+}
+
+void VisualUtil::charactersVisibleThroughPortal(Character *character, Room *sourceRoom,
+                                                Portal *portal, double strength,
+                                                QSet<GameObject *> &visitedRooms,
+                                                CharacterInfoList &characters) {
+
+    Room *room = portal->oppositeOf(sourceRoom).unsafeCast<Room *>();
+    double roomStrength = (strength > 0.0 ? strength :
+                                            sourceRoom->eventMultiplier(GameEventType::Visual)) *
+                          portal->eventMultiplier(GameEventType::Visual) *
+                          room->eventMultiplier(GameEventType::Visual);
+    if (roomStrength < 0.1) {
+        return;
+    }
+
+    Vector3D vector1 = room->position() - sourceRoom->position();
+    double distance = vectorLength(vector1);
+
+    visitedRooms.insert(sourceRoom);
+    visitedRooms.insert(room);
+
+    for (const GameObjectPtr &other : room->characters()) {
+        CharacterInfo info;
+        info.character = other;
+        info.strength = roomStrength;
+        info.distance = distance;
+        characters.append(info);
+    }
+
+    Room *currentRoom = character->currentRoom().unsafeCast<Room *>();
+    for (const GameObjectPtr &nextPortalPtr : room->portals()) {
+        Portal *nextPortal = nextPortalPtr.unsafeCast<Portal *>();
+        if (!nextPortal->canSeeThrough()) {
+            continue;
+        }
+
+        Room *nextRoom = nextPortal->oppositeOf(room).unsafeCast<Room *>();
+        if (nextRoom == sourceRoom || visitedRooms.contains(nextRoom)) {
+            continue;
+        }
+
+        Vector3D vector2 = nextRoom->position() - room->position();
+
+        if (room->flags() & RoomFlags::HasWalls) {
+            if (vector1.x != vector2.x || vector1.y != vector2.y) {
+                continue;
+            }
+        } else {
+            Vector3D vector3 = nextRoom->position() - currentRoom->position();
+            double angle = Util::angleBetweenXYVectors(character->direction(), vector3);
+            if (fabs(angle) > UNDER_QUART_PI) {
+                continue;
+            }
+        }
+
+        if ((room->flags() & RoomFlags::HasCeiling && vector2.z > vector1.z) ||
+            (room->flags() & RoomFlags::HasFloor && vector2.z < vector1.z)) {
+            continue;
+        }
+
+        charactersVisibleThroughPortal(character, room, nextPortal, roomStrength, visitedRooms,
+                                       characters);
+    }
+}
+
+QString VisualUtil::describeCharactersRelativeTo(CharacterInfoList characters,
+                                                 Character *relative) {
+
+    if (characters.isEmpty()) {
+        return QString();
+    }
+
+    enum CharacterGroup {
+        DistanceGroup,
+        AheadGroup,
+        RoofGroup,
+        NumCharacterGroups
+    };
+
+    static const char *prefixes[] = {
+        "In the distance",
+        "Ahead of you, there",
+        "On the roof"
+    };
+
+    CharacterInfoList groups[NumCharacterGroups];
+    for (const CharacterInfo &characterInfo : characters) {
+        Character *character = characterInfo.character.unsafeCast<Character *>();
+        Room *room = character->currentRoom().unsafeCast<Room *>();
+        if (room->flags() & RoomFlags::IsRoof) {
+            groups[RoofGroup].append(characterInfo);
+        } else if (characterInfo.distance > 50) {
+            groups[DistanceGroup].append(characterInfo);
+        } else {
+            groups[AheadGroup].append(characterInfo);
+        }
+    }
+
+    QStringList sentences;
+
+    for (int key = 0; key < NumCharacterGroups; key++) {
+        CharacterInfoList &group = groups[key];
+        if (group.isEmpty()) {
+            continue;
+        }
+
+        // groups are described as a whole, in place of their leader and members
+        for (int i = 0; i < group.size(); i++) {
+            CharacterInfo characterInfo = group[i];
+            if (characterInfo.character.isNull()) {
+                continue;
+            }
+
+            Character *character = characterInfo.character.unsafeCast<Character *>();
+            if (character->group().isNull()) {
+                continue;
+            }
+
+            Group *characterGroup = character->group().unsafeCast<Group *>();
+            if (characterGroup->leader() != character) {
+                continue;
+            }
+
+            group.remove(i);
+            for (const GameObjectPtr &member : characterGroup->members()) {
+                for (int j = 0; j < group.size(); j++) {
+                    if (group[j].character == member) {
+                        group.remove(j);
+                        break;
+                    }
+                }
+            }
+
+            CharacterInfo groupInfo;
+            groupInfo.group = characterGroup;
+            groupInfo.strength = characterInfo.strength;
+            groupInfo.distance = characterInfo.distance;
+            group.append(groupInfo);
+            i = 0;
+        }
+
+        class Info {
+            public:
+                GameObjectPtr character;
+                GameObjectPtr group;
+                QString name;
+                QString action;
+        };
+
+        QVector<Info> infos;
+        int numMen = 0, numWomen = 0, numUnknown = 0, numPeople = 0;
+        for (int i = 0; i < group.size(); i++) {
+            const CharacterInfo &characterInfo = group[i];
+
+            Info info;
+            GameObject *target = nullptr;
+            if (!characterInfo.group.isNull()) {
+                Group *characterGroup = characterInfo.group.unsafeCast<Group *>();
+
+                QString name = characterGroup->nameAtStrength(characterInfo.strength);
+                if (numPeople > 0 || i < group.size() - 1) {
+                    name = "a group " + QString(name.startsWith("a lot ") ? "with " : "of ") +
+                           (name.startsWith("some ") ? name.mid(5) : name);
+                }
+
+                Character *leader = characterGroup->leader().unsafeCast<Character *>();
+
+                info.group = characterGroup;
+                info.name = name;
+                info.action = describeActionRelativeTo(leader, relative,
+                                                       characterInfo.distance, target);
+                infos.append(info);
+                numPeople += 1 + characterGroup->members().length();
+            } else {
+                Character *character = characterInfo.character.unsafeCast<Character *>();
+                if (!character->race().isNull() && character->race()->name() == "animal") {
+                    continue;
+                }
+
+                QString name = character->nameAtStrength(characterInfo.strength);
+                QString action = describeActionRelativeTo(character, relative,
+                                                          characterInfo.distance, target);
+
+                if (name == "a man") {
+                    numMen++;
+                } else if (name == "a woman") {
+                    numWomen++;
+                } else if (name == "someone") {
+                    numUnknown++;
+                } else {
+                    info.character = character;
+                    info.name = name;
+                    info.action = action;
+                    infos.append(info);
+                }
+                numPeople++;
+            }
+
+            // the target of an action is already mentioned as part of that action
+            if (target) {
+                for (int j = i + 1; j < group.size(); j++) {
+                    if (group[j].character == target) {
+                        group.remove(j);
+                        break;
+                    }
+                }
+            }
+        }
+
+        for (int i = 0; i < infos.size(); i++) {
+            if (infos[i].character.isNull()) {
+                continue;
+            }
+
+            int count = 1;
+            for (int j = i + 1; j < infos.size(); j++) {
+                if (infos[i].name == infos[j].name && infos[i].action == infos[j].action) {
+                    infos.remove(j);
+                    count++;
+                    j--;
+                }
+            }
+            if (count > 1) {
+                infos[i].name = writtenAmount(count) + " " + infos[i].character->plural();
+            }
+        }
+
+        QStringList characterTexts;
+        bool hasMan = false, hasWoman = false;
+        for (const Info &info : infos) {
+            QString name = info.name;
+            if (!info.action.isEmpty()) {
+                name += " " + info.action;
+            }
+            characterTexts.append(name);
+
+            GameObjectPtrList people;
+            if (!info.character.isNull()) {
+                people.append(info.character);
+            } else {
+                Group *characterGroup = info.group.unsafeCast<Group *>();
+                people.append(characterGroup->leader());
+                people.append(characterGroup->members());
+            }
+            for (const GameObjectPtr &person : people) {
+                QString gender = person.unsafeCast<Character *>()->gender();
+                if (gender == "male") {
+                    hasMan = true;
+                } else if (gender == "female") {
+                    hasWoman = true;
+                }
+            }
+        }
+
+        if (numUnknown == 0) {
+            if (numMen == 0) {
+                if (numWomen == 1) {
+                    characterTexts.append(hasWoman ? "another woman" : "a woman");
+                } else if (numWomen > 1) {
+                    characterTexts.append(writtenAmount(numWomen) +
+                                          (hasWoman ? " other women" : " women"));
+                }
+            } else if (numMen == 1) {
+                if (numWomen <= 1) {
+                    characterTexts.append(hasMan ? "another man" : "a man");
+                    if (numWomen == 1) {
+                        characterTexts.append(hasWoman && !hasMan ? "another woman" : "a woman");
+                    }
+                } else {
+                    characterTexts.append(writtenAmount(numWomen) +
+                                          (hasWoman ? " other women" : " women"));
+                    characterTexts.append(hasMan && !hasWoman ? "another man" : "a man");
+                }
+            } else {
+                if (numWomen <= 1) {
+                    characterTexts.append(writtenAmount(numMen) +
+                                          (hasMan ? " other men" : " men"));
+                    if (numWomen == 1) {
+                        characterTexts.append(hasWoman && !hasMan ? "another woman" : "a woman");
+                    }
+                } else {
+                    characterTexts.append(writtenAmount(numMen + numWomen) +
+                                          (numPeople > numMen + numWomen ? " other people" :
+                                                                           " people"));
+                }
+            }
+        } else {
+            numUnknown += numMen + numWomen;
+            if (numPeople > numUnknown) {
+                characterTexts.append(numUnknown == 1 ? QString("someone else") :
+                                      writtenAmount(numUnknown) + " other people");
+            } else {
+                characterTexts.append(numUnknown == 1 ? QString("someone") :
+                                      writtenAmount(numUnknown) + " people");
+            }
+        }
+
+        if (!characterTexts.isEmpty()) {
+            sentences.append(QString("%1, you see %2.").arg(prefixes[key],
+                                                            Util::joinFancy(characterTexts)));
+        }
+    }
+
+    return sentences.join(" ");
+}
+
+QString VisualUtil::describeActionRelativeTo(Character *character, Character *relative,
+                                             double distance, GameObject *&target) {
+
+    QString action = character->currentAction();
+    if (action.isEmpty()) {
+        return QString();
+    }
+
+    GameObject *actionTarget = character->target().cast<GameObject *>();
+
+    QString text;
+    if (action == "walk" || action == "run") {
+        Room *room = character->currentRoom().unsafeCast<Room *>();
+        Room *relativeRoom = relative->currentRoom().unsafeCast<Room *>();
+
+        Vector3D vector = room->position() - relativeRoom->position();
+        double angle = character->direction().angle(vector);
+
+        QString direction;
+        if (fabs(angle) < UNDER_QUART_PI) {
+            direction = "away from you";
+        } else if (fabs(angle) > 3 * OVER_QUART_PI && distance <= 100) {
+            direction = "toward you";
+        } else {
+            direction = Util::directionForVector(character->direction());
+        }
+
+        text = QString("%1 %2").arg(action == "walk" ? "walking" : "running", direction);
+    } else if (action == "fight") {
+        if (actionTarget && actionTarget->isCharacter() &&
+            static_cast<Character *>(actionTarget)->currentRoom() == character->currentRoom()) {
+            target = actionTarget;
+            text = "fighting " + target->indefiniteName();
+        } else {
+            text = "fighting";
+        }
+    } else if (action == "guard") {
+        if (actionTarget) {
+            target = actionTarget;
+            if (target->isPortal()) {
+                text = "guarding the " +
+                       static_cast<Portal *>(target)->nameFromRoom(character->currentRoom());
+            } else {
+                text = "guarding " + target->indefiniteName();
+            }
+        } else {
+            text = "standing guard";
+        }
+    }
+
+    return text;
+}
+
+QString VisualUtil::nameWithDestinationFromRoom(Portal *portal, Room *room) {
+
+    QString name = portal->nameFromRoom(room);
+    QString destination = portal->destinationFromRoom(room);
+    if (destination.isEmpty()) {
+        if (name == "door" || name == "tent") {
+            return "a " + name;
+        } else {
+            return "the " + name;
+        }
+    } else {
+        return QString("the %1 to %2").arg(name, destination);
+    }
+}
+
+bool VisualUtil::firstItemIsPlural(const GameObjectPtrList &items) {
+
+    if (items.isEmpty()) {
+        return false;
+    }
+
+    Item *first = items[0].unsafeCast<Item *>();
+    if (first->flags() & ItemFlags::ImpliedPlural) {
+        return true;
+    }
+
+    for (int i = 1; i < items.length(); i++) {
+        if (items[i]->name() == first->name()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QString VisualUtil::writtenAmount(int amount) {
+
+    if (amount == 1) {
+        return "one";
+    } else if (amount == 2) {
+        return "two";
+    } else if (amount < 6) {
+        return "some";
+    } else {
+        return "a lot of";
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef VISUALUTIL_H
+#define VISUALUTIL_H
+
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+#include "gameobjectptr.h"
+#include "vector3d.h"
+
+
+class Character;
+class GameObject;
+class Portal;
+class Room;
+
+// native counterpart of VisualUtil in visualutil.js, describeRoom() renders the same output
+class VisualUtil {
+
+    public:
+        enum Group {
+            Left,
+            Right,
+            Ahead,
+            Behind,
+            Center,
+            Above,
+            LeftWall,
+            RightWall,
+            Wall,
+            Ceiling,
+            NumGroups
+        };
+
+        class CharacterInfo {
+            public:
+                GameObjectPtr character;
+                GameObjectPtr group;
+                double strength;
+                double distance;
+        };
+
+        typedef QVector<CharacterInfo> CharacterInfoList;
+
+        static QString describeRoom(Room *room, Character *character);
+
+        static void divideItemsIntoGroups(const GameObjectPtrList &items,
+                                          const Vector3D &direction,
+                                          GameObjectPtrList groups[NumGroups]);
+
+        static bool dividePortalsAndCharactersIntoGroups(Character *character, Room *room,
+                                                         GameObjectPtrList groups[NumGroups],
+                                                         CharacterInfoList &characters);
+
+        static CharacterInfoList charactersVisibleThroughPortal(Character *character,
+                                                                Room *sourceRoom, Portal *portal,
+                                                                double strength = 0.0);
+
+        static QString describeCharactersRelativeTo(CharacterInfoList characters,
+                                                    Character *relative);
+
+    private:
+        static void charactersVisibleThroughPortal(Character *character, Room *sourceRoom,
+                                                   Portal *portal, double strength,
+                                                   QSet<GameObject *> &visitedRooms,
+                                                   CharacterInfoList &characters);
+
+        static QString describeActionRelativeTo(Character *character, Character *relative,
+                                                double distance, GameObject *&target);
+
+        static QString nameWithDestinationFromRoom(Portal *portal, Room *room);
+
+        static bool firstItemIsPlural(const GameObjectPtrList &items);
+
+        static QString writtenAmount(int amount);
+};
+
+#endif // VISUALUTIL_H
@@ -1,18 +1,83 @@
 #include "httpserver.h"
 
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QDirIterator>
 #include <QFile>
 #include <QFileInfo>
-#include <QRegExp>
-#include <QStringList>
+#include <QFileSystemWatcher>
+#include <QList>
 #include <QTcpSocket>
 
+#include <QtIOCompressor>
+
 #include "logutil.h"
 #include "realm.h"
 #include "util.h"
 
 
+static const int MAX_REQUEST_SIZE = 16384;
+
+
+static QByteArray gzip(const QByteArray &data) {
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    QtIOCompressor compressor(&buffer, 9);
+    compressor.setStreamFormat(QtIOCompressor::GzipFormat);
+    compressor.open(QIODevice::WriteOnly);
+    compressor.write(data);
+    compressor.close();
+
+    return buffer.data();
+}
+
+// returns whether the given Accept-Encoding header value allows a gzipped response, codings with
+// a q-value of 0 are explicitly not acceptable
+static bool acceptsGzip(const QByteArray &acceptEncoding) {
+
+    bool wildcard = false;
+    for (const QByteArray &entry : acceptEncoding.split(',')) {
+        QList<QByteArray> parameters = entry.split(';');
+        QByteArray coding = parameters.takeFirst().trimmed().toLower();
+
+        double quality = 1.0;
+        for (const QByteArray &parameter : parameters) {
+            QByteArray trimmed = parameter.trimmed().toLower();
+            if (trimmed.startsWith("q=")) {
+                bool ok;
+                quality = trimmed.mid(2).toDouble(&ok);
+                if (!ok) {
+                    quality = 0.0;
+                }
+            }
+        }
+
+        if (coding == "gzip" || coding == "x-gzip") {
+            return quality > 0.0;
+        } else if (coding == "*") {
+            wildcard = (quality > 0.0);
+        }
+    }
+    return wildcard;
+}
+
+static QByteArray statusResponse(const QByteArray &status, bool keepAlive) {
+
+    QByteArray body = "<h1>" + status.mid(4) + "</h1>\n";
+    return "HTTP/1.1 " + status + "\r\n"
+           "Content-Type: text/html; charset=\"utf-8\"\r\n"
+           "Content-Length: " + QByteArray::number(body.length()) + "\r\n"
+           "Connection: " + (keepAlive ? "keep-alive" : "close") + "\r\n"
+           "\r\n" + body;
+}
+
+
 HttpServer::HttpServer(quint16 port, quint16 webSocketPort, QObject *parent) :
     QTcpServer(parent),
+    m_watcher(nullptr),
     m_webSocketPort(webSocketPort) {
 
     if (listen(QHostAddress::Any, port)) {
@@ -23,12 +88,166 @@ HttpServer::HttpServer(quint16 port, quint16 webSocketPort, QObject *parent) :
 
     m_title = Util::htmlEscape(Realm::instance()->name()).toUtf8();
 
+    m_rootDir = qgetenv("PT_WEB_DIR");
+    if (m_rootDir.isEmpty()) {
+        m_rootDir = "web";
+    }
+
+    if (qgetenv("PT_DEV_MODE") == "1") {
+        m_watcher = new QFileSystemWatcher(this);
+        connect(m_watcher, SIGNAL(fileChanged(QString)), SLOT(onFileChanged(QString)));
+        connect(m_watcher, SIGNAL(directoryChanged(QString)), SLOT(onDirectoryChanged(QString)));
+    }
+
+    loadAssets();
+
     connect(this, SIGNAL(newConnection()), SLOT(onClientConnected()));
 }
 
 HttpServer::~HttpServer() {
 }
 
+void HttpServer::loadAssets() {
+
+    m_assets.clear();
+
+    if (m_watcher) {
+        QStringList watchedPaths = m_watcher->files() + m_watcher->directories();
+        if (!watchedPaths.isEmpty()) {
+            m_watcher->removePaths(watchedPaths);
+        }
+        m_watcher->addPath(m_rootDir);
+    }
+
+    QDirIterator iterator(m_rootDir, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot,
+                          QDirIterator::Subdirectories);
+    while (iterator.hasNext()) {
+        QString filePath = iterator.next();
+        if (filePath.contains("/node_modules")) {
+            continue;
+        }
+
+        if (iterator.fileInfo().isDir()) {
+            if (m_watcher) {
+                m_watcher->addPath(filePath);
+            }
+        } else {
+            loadAsset(filePath);
+        }
+    }
+
+    int numBytes = 0;
+    int numGzippedBytes = 0;
+    for (const Asset &asset : m_assets) {
+        numBytes += asset.content.length();
+        numGzippedBytes += (asset.gzippedContent.isEmpty() ? asset.content.length() :
+                                                             asset.gzippedContent.length());
+    }
+    LogUtil::logInfo("HTTP server cached %1 assets (%2 bytes, %3 bytes gzipped)",
+                     QString::number(m_assets.size()), QString::number(numBytes),
+                     QString::number(numGzippedBytes));
+}
+
+QByteArray HttpServer::handleRequest(const QByteArray &request, bool *keepAlive) const {
+
+    QList<QByteArray> lines = request.split('\n');
+    QList<QByteArray> tokens = lines[0].simplified().split(' ');
+
+    QHash<QByteArray, QByteArray> headers;
+    for (int i = 1; i < lines.length(); i++) {
+        int colonIndex = lines[i].indexOf(':');
+        if (colonIndex > 0) {
+            headers[lines[i].left(colonIndex).trimmed().toLower()] =
+                    lines[i].mid(colonIndex + 1).trimmed();
+        }
+    }
+
+    QByteArray connection = headers.value("connection").toLower();
+    bool persistent = (tokens.length() > 2 && tokens[2] == "HTTP/1.1") ? connection != "close" :
+                                                                          connection == "keep-alive";
+    if (keepAlive) {
+        *keepAlive = persistent;
+    }
+
+    if (tokens.length() < 2) {
+        if (keepAlive) {
+            *keepAlive = false;
+        }
+        return statusResponse("400 Bad Request", false);
+    }
+
+    bool head = (tokens[0] == "HEAD");
+    if (tokens[0] != "GET" && !head) {
+        // the request body is not read, so the connection can't be used for another request
+        if (keepAlive) {
+            *keepAlive = false;
+        }
+        return statusResponse("405 Method Not Allowed", false);
+    }
+
+    QString path = QString::fromUtf8(tokens[1]);
+    if (!path.startsWith('/') || path.contains("/.")) {
+        return statusResponse("403 Forbidden", persistent);
+    }
+
+    if (path.contains('?')) {
+        path = path.section('?', 0, 0);
+    }
+    if (path == "/") {
+        path = "/index.html";
+    }
+
+    if (path.endsWith(".js") && m_assets.contains("/min" + path)) {
+        path = "/min" + path;
+    }
+
+    if (!m_assets.contains(path)) {
+        return statusResponse("404 Not Found", persistent);
+    }
+
+    const Asset &asset = m_assets[path];
+
+    QByteArray response;
+    response.reserve(asset.content.length() + 256);
+
+    bool gzipped = (!asset.gzippedContent.isEmpty() &&
+                    acceptsGzip(headers.value("accept-encoding")));
+    const QByteArray &content = (gzipped ? asset.gzippedContent : asset.content);
+    const QByteArray &eTag = (gzipped ? asset.gzippedETag : asset.eTag);
+
+    // If-None-Match uses the weak comparison, so weak validators match as well
+    QList<QByteArray> eTags = headers.value("if-none-match").split(',');
+    for (QByteArray &candidate : eTags) {
+        candidate = candidate.trimmed();
+        if (candidate.startsWith("W/")) {
+            candidate.remove(0, 2);
+        }
+    }
+    bool notModified = (eTags.contains(eTag) || eTags.contains("*"));
+
+    response += (notModified ? "HTTP/1.1 304 Not Modified\r\n" : "HTTP/1.1 200 OK\r\n");
+    response += "ETag: " + eTag + "\r\n"
+                "Cache-Control: " + asset.cacheControl + "\r\n";
+    if (!asset.gzippedContent.isEmpty()) {
+        response += "Vary: Accept-Encoding\r\n";
+    }
+    if (!notModified) {
+        response += "Content-Type: " + asset.contentType + "\r\n";
+        if (gzipped) {
+            response += "Content-Encoding: gzip\r\n";
+        }
+        response += "Content-Length: " + QByteArray::number(content.length()) + "\r\n";
+    }
+    response += QByteArray("Connection: ") + (persistent ? "keep-alive" : "close") + "\r\n"
+                "\r\n";
+
+    if (!notModified && !head) {
+        response += content;
+    }
+
+    return response;
+}
+
 void HttpServer::onClientConnected() {
 
     QTcpSocket *socket = nextPendingConnection();
@@ -39,91 +258,108 @@ void HttpServer::onClientConnected() {
 void HttpServer::onReadyRead() {
 
     QTcpSocket *socket = (QTcpSocket *) sender();
-    if (socket->canReadLine()) {
-        QStringList tokens = QString(socket->readLine()).split(QRegExp("[ \r\n]+"));
-        if (tokens[0] == "GET") {
-            if (tokens.length() < 2) {
-                socket->write("HTTP/1.0 400 Bad Request\r\n"
-                              "Content-Type: text/html; charset=\"utf-8\"\r\n"
-                              "\r\n"
-                              "<h1>Bad Request</h1>\n");
-                socket->close();
-                return;
-            }
+    QByteArray buffer = socket->property("requestBuffer").toByteArray() + socket->readAll();
 
-            QString path = tokens[1];
-            if (!path.startsWith('/') || path.contains("/.")) {
-                socket->write("HTTP/1.0 403 Forbidden\r\n"
-                              "Content-Type: text/html; charset=\"utf-8\"\r\n"
-                              "\r\n"
-                              "<h1>Forbidden</h1>\n");
-                socket->close();
-                return;
-            }
+    // handle all complete requests, clients may pipeline them over a kept-alive connection
+    int endIndex;
+    while ((endIndex = buffer.indexOf("\r\n\r\n")) > -1) {
+        QByteArray request = buffer.left(endIndex);
+        buffer.remove(0, endIndex + 4);
 
-            if (path.contains('?')) {
-                path = path.section('?', 0, 0);
-            }
-            if (path == "/") {
-                path = "/index.html";
-            }
-            path = "web" + path;
+        bool keepAlive;
+        socket->write(handleRequest(request, &keepAlive));
+        if (!keepAlive) {
+            socket->disconnectFromHost();
+            return;
+        }
+    }
 
-            if (path.endsWith(".js")) {
-                QString minifiedPath = "/min" + path;
-                if (QFile::exists(minifiedPath)) {
-                    path = minifiedPath;
-                }
-            }
+    if (buffer.length() > MAX_REQUEST_SIZE) {
+        socket->write(statusResponse("431 Request Header Fields Too Large", false));
+        socket->disconnectFromHost();
+        return;
+    }
 
-            QFile file(path);
-            if (!file.open(QIODevice::ReadOnly)) {
-                socket->write("HTTP/1.0 404 Not Found"
-                              "Content-Type: text/html; charset=\"utf-8\"\r\n"
-                              "\r\n"
-                              "<h1>Not Found</h1>\n");
-                socket->close();
-                return;
-            }
+    socket->setProperty("requestBuffer", buffer);
+}
 
-            QByteArray content = file.readAll();
-
-            QFileInfo info(path);
-            QString mimeType = "text/html";
-            QString charset;
-            if (info.suffix() == "js") {
-                mimeType = "text/javascript";
-            } else if (info.suffix() == "png") {
-                mimeType = "image/png";
-            } else if (info.suffix() == "css") {
-                mimeType = "text/css";
-            } else {
-                charset = "; charset=\"utf-8\"";
-            }
+void HttpServer::onDisconnected() {
 
-            if (info.fileName() == "index.html") {
-                content.replace("{{title}}", m_title);
-                content.replace("{{headerScript}}", QString("var PT_WEBSOCKET_PORT = %1;")
-                                                    .arg((uint) m_webSocketPort).toUtf8());
-            }
+    sender()->deleteLater();
+}
 
-            socket->write(QString("HTTP/1.0 200 Ok\r\n"
-                                  "Content-Type: %1%2\r\n"
-                                  "Content-Length: %3\r\n"
-                                  "\r\n")
-                          .arg(mimeType, charset, QString::number(content.length()))
-                          .toLatin1() +
-                          content);
-            socket->close();
-
-            if (socket->state() == QTcpSocket::UnconnectedState) {
-                delete socket;
-            }
-        }
+void HttpServer::onFileChanged(const QString &filePath) {
+
+    loadAsset(filePath);
+
+    // editors often replace files rather than modifying them, which drops the watch
+    if (QFile::exists(filePath) && !m_watcher->files().contains(filePath)) {
+        m_watcher->addPath(filePath);
     }
+
+    LogUtil::logInfo("HTTP server reloaded %1", filePath);
 }
 
-void HttpServer::onDisconnected() {
+void HttpServer::onDirectoryChanged(const QString &dirPath) {
 
-    sender()->deleteLater();
+    Q_UNUSED(dirPath)
+
+    loadAssets();
+}
+
+void HttpServer::loadAsset(const QString &filePath) {
+
+    QString path = "/" + QDir(m_rootDir).relativeFilePath(filePath);
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_assets.remove(path);
+        return;
+    }
+
+    Asset asset;
+    asset.content = file.readAll();
+
+    QFileInfo info(filePath);
+    QString suffix = info.suffix();
+    if (suffix == "js") {
+        asset.contentType = "text/javascript";
+    } else if (suffix == "png") {
+        asset.contentType = "image/png";
+    } else if (suffix == "css") {
+        asset.contentType = "text/css";
+    } else {
+        asset.contentType = "text/html; charset=\"utf-8\"";
+    }
+
+    if (info.fileName() == "index.html") {
+        asset.content.replace("{{title}}", m_title);
+        asset.content.replace("{{headerScript}}", QString("var PT_WEBSOCKET_PORT = %1;")
+                                                  .arg((uint) m_webSocketPort).toUtf8());
+    }
+
+    // the index is the entry point into the (unversioned) assets, so it is always revalidated
+    if (m_watcher || info.fileName() == "index.html") {
+        asset.cacheControl = "no-cache";
+    } else {
+        asset.cacheControl = "max-age=3600";
+    }
+
+    // every representation needs its own strong validator, so the gzipped one gets a suffix
+    QByteArray hash = QCryptographicHash::hash(asset.content, QCryptographicHash::Md5).toHex();
+    asset.eTag = "\"" + hash + "\"";
+    asset.gzippedETag = "\"" + hash + "-gz\"";
+
+    if (suffix != "png") {
+        QByteArray gzippedContent = gzip(asset.content);
+        if (gzippedContent.length() < asset.content.length()) {
+            asset.gzippedContent = gzippedContent;
+        }
+    }
+
+    m_assets[path] = asset;
+
+    if (m_watcher && !m_watcher->files().contains(filePath)) {
+        m_watcher->addPath(filePath);
+    }
 }
@@ -1,9 +1,13 @@
 #ifndef HTTPSERVER_H
 #define HTTPSERVER_H
 
+#include <QHash>
 #include <QTcpServer>
 
 
+class QFileSystemWatcher;
+
+
 class HttpServer : public QTcpServer {
 
     Q_OBJECT
@@ -12,12 +16,34 @@ class HttpServer : public QTcpServer {
         HttpServer(quint16 port, quint16 webSocketPort, QObject *parent = nullptr);
         virtual ~HttpServer();
 
+        void loadAssets();
+
+        QByteArray handleRequest(const QByteArray &request, bool *keepAlive = nullptr) const;
+
     private slots:
         void onClientConnected();
         void onReadyRead();
         void onDisconnected();
 
+        void onFileChanged(const QString &filePath);
+        void onDirectoryChanged(const QString &dirPath);
+
     private:
+        struct Asset {
+            QByteArray contentType;
+            QByteArray cacheControl;
+            QByteArray eTag;
+            QByteArray gzippedETag;
+            QByteArray content;
+            QByteArray gzippedContent;
+        };
+
+        void loadAsset(const QString &filePath);
+
+        QString m_rootDir;
+        QHash<QString, Asset> m_assets;
+        QFileSystemWatcher *m_watcher;
+
         QByteArray m_title;
         quint16 m_webSocketPort;
 };
@@ -64,7 +64,8 @@ void TelnetServer::onClientConnected() {
     connect(socket, SIGNAL(disconnected()), SLOT(onClientDisconnected()));
 
     Session *session = new Session(m_realm, "telnet", socket->peerAddress().toString(), socket);
-    connect(session, SIGNAL(write(QString)), SLOT(onSessionOutput(QString)));
+    session->setEncoding(EncodedMessage::TelnetEncoding);
+    connect(session, SIGNAL(write(QByteArray)), SLOT(onSessionOutput(QByteArray)));
     connect(session, SIGNAL(terminate()), socket, SLOT(deleteLater()));
 
     session->open();
@@ -148,9 +149,10 @@ void TelnetServer::onClientDisconnected() {
     socket->deleteLater();
 }
 
-void TelnetServer::onSessionOutput(QString data) {
+void TelnetServer::onSessionOutput(const QByteArray &data) {
 
-    if (data.trimmed().isEmpty()) {
+    // JSON messages and empty messages are encoded as empty data for telnet sessions
+    if (data.isEmpty()) {
         return;
     }
 
@@ -164,11 +166,7 @@ void TelnetServer::onSessionOutput(QString data) {
         return;
     }
 
-    if (data.startsWith("{") && data.endsWith("}")) {
-        return;
-    }
-
-    write(socket, data.replace("\n", "\r\n").toUtf8());
+    write(socket, data);
 
     if (session->authenticated()) {
         Player *player = session->player();
@@ -23,7 +23,7 @@ class TelnetServer : public QObject {
         void onReadyRead();
         void onClientDisconnected();
 
-        void onSessionOutput(QString data);
+        void onSessionOutput(const QByteArray &data);
 
     private:
         Realm *m_realm;
@@ -1,5 +1,6 @@
 #include "websocketserver.h"
 
+#include <QWsPerMessageDeflate.h>
 #include <QWsServer.h>
 #include <QWsSocket.h>
 
@@ -14,6 +15,17 @@ WebSocketServer::WebSocketServer(Realm *realm, quint16 port, QObject *parent) :
     m_realm(realm) {
 
     m_server = new QWsServer(this);
+
+    if (qgetenv("PT_WEBSOCKET_DEFLATE") != "0") {
+        int windowBits = qgetenv("PT_WEBSOCKET_DEFLATE_WINDOW_BITS").toInt();
+        if (windowBits == 0) {
+            windowBits = 15;
+        }
+        bool contextTakeover = (qgetenv("PT_WEBSOCKET_DEFLATE_CONTEXT_TAKEOVER") != "0");
+
+        m_server->setPerMessageDeflate(true, windowBits, contextTakeover);
+    }
+
     if (m_server->listen(QHostAddress::Any, port)) {
         LogUtil::logInfo("WebSocket server is listening on port %1", QString::number(port));
     } else {
@@ -36,7 +48,7 @@ void WebSocketServer::onClientConnected() {
     connect(socket, SIGNAL(disconnected()), SLOT(onClientDisconnected()));
 
     Session *session = new Session(m_realm, "WebSocket", socket->peerAddress().toString(), socket);
-    connect(session, SIGNAL(write(QString)), SLOT(onSessionOutput(QString)));
+    connect(session, SIGNAL(write(QByteArray)), SLOT(onSessionOutput(QByteArray)));
 
     connect(socket, SIGNAL(frameReceived(QString)), session, SLOT(onUserInput(QString)));
     connect(session, SIGNAL(terminate()), socket, SLOT(close()));
@@ -55,10 +67,21 @@ void WebSocketServer::onClientDisconnected() {
 
     m_clients.removeOne(socket);
 
+    QWsPerMessageDeflate *deflate = socket->perMessageDeflate();
+    if (deflate && deflate->uncompressedBytesOut() > 0) {
+        LogUtil::logSessionEvent(socket->peerAddress().toString(),
+                                 QString("WebSocket compression: %1 bytes sent as %2 bytes "
+                                         "(%3ms deflating, %4ms inflating)")
+                                 .arg(deflate->uncompressedBytesOut())
+                                 .arg(deflate->compressedBytesOut())
+                                 .arg(deflate->deflateNsecs() / 1000000)
+                                 .arg(deflate->inflateNsecs() / 1000000));
+    }
+
     socket->deleteLater();
 }
 
-void WebSocketServer::onSessionOutput(const QString &data) {
+void WebSocketServer::onSessionOutput(const QByteArray &data) {
 
     Session *session = qobject_cast<Session *>(sender());
     if (!session) {
@@ -70,8 +93,8 @@ void WebSocketServer::onSessionOutput(const QString &data) {
         return;
     }
 
-    if (!data.trimmed().isEmpty()) {
-        socket->write(data);
+    if (!data.isEmpty()) {
+        socket->writeText(data);
     }
 
     if (session->authenticated() &&
@@ -21,7 +21,7 @@ class WebSocketServer : public QObject {
         void onClientConnected();
         void onClientDisconnected();
 
-        void onSessionOutput(const QString &data);
+        void onSessionOutput(const QByteArray &data);
 
     private:
         Realm *m_realm;
@@ -0,0 +1,457 @@
+#include "bot.h"
+
+#include <QRegExp>
+#include <QTimer>
+
+
+#define IAC  0xFF
+#define SB   0xFA
+#define SE   0xF0
+#define WILL 0xFB
+#define DONT 0xFE
+
+#define WS_CONTINUATION 0x0
+#define WS_TEXT         0x1
+#define WS_CLOSE        0x8
+#define WS_PING         0x9
+#define WS_PONG         0xA
+
+
+static QString randomItem(const QStringList &list) {
+
+    return list[qrand() % list.length()];
+}
+
+
+Bot::Bot(const Options &options, QObject *parent) :
+    QObject(parent),
+    m_options(options),
+    m_state(Stopped),
+    m_awaitingReply(false),
+    m_numMarkers(0) {
+
+    m_socket = new QTcpSocket(this);
+    connect(m_socket, SIGNAL(connected()), SLOT(onConnected()));
+    connect(m_socket, SIGNAL(readyRead()), SLOT(onReadyRead()));
+    connect(m_socket, SIGNAL(disconnected()), SLOT(onDisconnected()));
+    connect(m_socket, SIGNAL(error(QAbstractSocket::SocketError)),
+            SLOT(onSocketError(QAbstractSocket::SocketError)));
+
+    m_commandTimer = new QTimer(this);
+    m_commandTimer->setSingleShot(true);
+    connect(m_commandTimer, SIGNAL(timeout()), SLOT(onCommandTimer()));
+
+    m_timeoutTimer = new QTimer(this);
+    m_timeoutTimer->setSingleShot(true);
+    connect(m_timeoutTimer, SIGNAL(timeout()), SLOT(onTimeout()));
+}
+
+Bot::~Bot() {
+}
+
+void Bot::start() {
+
+    m_state = Connecting;
+    m_signInTimer.start();
+    m_timeoutTimer->start(m_options.timeout);
+
+    m_socket->connectToHost(m_options.host, m_options.port);
+}
+
+void Bot::stop() {
+
+    m_state = Stopped;
+    m_commandTimer->stop();
+    m_timeoutTimer->stop();
+
+    m_socket->abort();
+}
+
+QString Bot::profileName(Profile profile) {
+
+    switch (profile) {
+        case Wander: return "wander";
+        case Chat: return "chat";
+        case Fight: return "fight";
+        case Shop: return "shop";
+    }
+    return QString();
+}
+
+bool Bot::profileFromName(const QString &name, Profile &profile) {
+
+    for (Profile candidate : QList<Profile>() << Wander << Chat << Fight << Shop) {
+        if (profileName(candidate) == name) {
+            profile = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Bot::onConnected() {
+
+    if (m_options.transport == WebSocket) {
+        QByteArray key;
+        for (int i = 0; i < 16; i++) {
+            key.append((char) (qrand() % 0x100));
+        }
+
+        QString host = QString("%1:%2").arg(m_options.host).arg(m_options.port);
+        m_socket->write(QString("GET / HTTP/1.1\r\n"
+                                "Host: %1\r\n"
+                                "Upgrade: websocket\r\n"
+                                "Connection: Upgrade\r\n"
+                                "Origin: http://%1\r\n"
+                                "Sec-WebSocket-Key: %2\r\n"
+                                "Sec-WebSocket-Version: 13\r\n"
+                                "\r\n").arg(host, QString(key.toBase64())).toLatin1());
+        m_state = Handshaking;
+    } else {
+        m_state = SigningIn;
+    }
+}
+
+void Bot::onReadyRead() {
+
+    m_readBuffer += m_socket->readAll();
+
+    if (m_state == Handshaking) {
+        int endIndex = m_readBuffer.indexOf("\r\n\r\n");
+        if (endIndex == -1) {
+            return;
+        }
+
+        if (!m_readBuffer.startsWith("HTTP/1.1 101")) {
+            fail("WebSocket handshake failed");
+            return;
+        }
+
+        m_readBuffer.remove(0, endIndex + 4);
+        m_state = SigningIn;
+    }
+
+    if (m_options.transport == WebSocket) {
+        processWebSocketData();
+    } else {
+        processTelnetData();
+    }
+}
+
+void Bot::onDisconnected() {
+
+    if (m_state != Stopped) {
+        fail("Disconnected by server");
+    }
+}
+
+void Bot::onSocketError(QAbstractSocket::SocketError socketError) {
+
+    if (m_state != Stopped && socketError != QAbstractSocket::RemoteHostClosedError) {
+        fail(m_socket->errorString());
+    }
+}
+
+void Bot::onCommandTimer() {
+
+    if (m_state != Playing) {
+        return;
+    }
+
+    send(nextCommand());
+    emit commandSent();
+
+    // the server has no prompt, and other players' actions may produce output at any time, so
+    // the command is followed by a non-existent one, whose error message marks the end of the reply.
+    // markers are reported separately, so they don't count towards the command throughput
+    m_numMarkers++;
+    m_marker = QString("loadgen-marker-%1").arg(m_numMarkers);
+    send(m_marker);
+    emit markerSent();
+
+    m_output.clear();
+    m_awaitingReply = true;
+    m_replyTimer.start();
+    m_timeoutTimer->start(m_options.timeout);
+}
+
+void Bot::onTimeout() {
+
+    if (m_state == Playing) {
+        m_awaitingReply = false;
+        emit error("Command timed out");
+        scheduleNextCommand();
+    } else {
+        fail("Sign-in timed out");
+    }
+}
+
+void Bot::processTelnetData() {
+
+    QByteArray text;
+    int i = 0;
+    while (i < m_readBuffer.length()) {
+        unsigned char byte = m_readBuffer[i];
+        if (byte != IAC) {
+            text.append(byte);
+            i++;
+            continue;
+        }
+
+        // keep incomplete sequences around until the rest arrives
+        if (i + 1 >= m_readBuffer.length()) {
+            break;
+        }
+
+        unsigned char command = m_readBuffer[i + 1];
+        if (command == IAC) {
+            text.append(byte);
+            i += 2;
+        } else if (command >= WILL && command <= DONT) {
+            if (i + 2 >= m_readBuffer.length()) {
+                break;
+            }
+            i += 3;
+        } else if (command == SB) {
+            int endIndex = m_readBuffer.indexOf(QByteArray("\xFF\xF0", 2), i + 2);
+            if (endIndex == -1) {
+                break;
+            }
+            i = endIndex + 2;
+        } else {
+            i += 2;
+        }
+    }
+    m_readBuffer.remove(0, i);
+
+    if (!text.isEmpty()) {
+        processOutput(QString::fromUtf8(text));
+    }
+}
+
+void Bot::processWebSocketData() {
+
+    while (m_readBuffer.length() >= 2) {
+        unsigned char byte0 = m_readBuffer[0];
+        unsigned char byte1 = m_readBuffer[1];
+
+        bool fin = byte0 & 0x80;
+        int opcode = byte0 & 0x0F;
+        int headerLength = 2 + ((byte1 & 0x80) ? 4 : 0);
+        quint64 payloadLength = byte1 & 0x7F;
+        if (payloadLength == 126) {
+            if (m_readBuffer.length() < 4) {
+                return;
+            }
+            payloadLength = ((unsigned char) m_readBuffer[2] << 8) | (unsigned char) m_readBuffer[3];
+            headerLength += 2;
+        } else if (payloadLength == 127) {
+            if (m_readBuffer.length() < 10) {
+                return;
+            }
+            payloadLength = 0;
+            for (int i = 2; i < 10; i++) {
+                payloadLength = (payloadLength << 8) | (unsigned char) m_readBuffer[i];
+            }
+            headerLength += 8;
+        }
+
+        if ((quint64) m_readBuffer.length() < headerLength + payloadLength) {
+            return;
+        }
+
+        QByteArray payload = m_readBuffer.mid(headerLength, payloadLength);
+        m_readBuffer.remove(0, headerLength + payloadLength);
+
+        if (opcode == WS_TEXT || opcode == WS_CONTINUATION) {
+            m_fragment += payload;
+            if (fin) {
+                QString output = QString::fromUtf8(m_fragment);
+                m_fragment.clear();
+                processOutput(output);
+            }
+        } else if (opcode == WS_PING) {
+            QByteArray frame;
+            frame.append((char) (0x80 | WS_PONG));
+            frame.append((char) 0x80);
+            frame.append(QByteArray(4, '\0'));
+            m_socket->write(frame);
+        } else if (opcode == WS_CLOSE) {
+            fail("Closed by server");
+            return;
+        }
+    }
+}
+
+void Bot::processOutput(const QString &output) {
+
+    if (m_state == SigningIn) {
+        m_output += output;
+        processSignIn();
+        return;
+    }
+
+    if (m_state != Playing) {
+        return;
+    }
+
+    static QRegExp colorCodes("\x1B\\[[0-9;]*m");
+    static QRegExp exits("Obvious exits: ([^.\\n]*)\\.");
+    QString text = output;
+    text.remove(colorCodes);
+    if (exits.indexIn(text) > -1) {
+        m_exits = exits.cap(1).split(", ");
+    }
+
+    if (!m_awaitingReply) {
+        return;
+    }
+
+    m_output += text;
+    if (m_output.contains("\"" + m_marker + "\"")) {
+        m_output.clear();
+        m_awaitingReply = false;
+        m_timeoutTimer->stop();
+        emit commandCompleted(m_replyTimer.nsecsElapsed() / 1000);
+        scheduleNextCommand();
+    }
+}
+
+void Bot::processSignIn() {
+
+    QString answer;
+    if (m_output.contains("already signed in")) {
+        fail("Already signed in");
+        return;
+    } else if (m_output.contains("Password incorrect")) {
+        fail("Password incorrect");
+        return;
+    } else if (m_output.contains("Welcome back") || m_output.contains("Welcome to")) {
+        m_state = Playing;
+        m_output.clear();
+        m_timeoutTimer->stop();
+        emit signedIn(m_signInTimer.elapsed());
+        scheduleNextCommand();
+        return;
+    } else if (m_output.contains("What is your name?")) {
+        answer = m_options.userName;
+    } else if (m_output.contains("did I get that right?") ||
+               m_output.contains("Are you ready to create a character")) {
+        answer = "yes";
+    } else if (m_output.contains("Please enter your password") ||
+               m_output.contains("Please choose a password") ||
+               m_output.contains("Please confirm your password")) {
+        answer = m_options.password;
+    } else if (m_output.contains("Please select the race")) {
+        answer = m_options.race;
+    } else if (m_output.contains("Please select the class")) {
+        answer = m_options.characterClass;
+    } else if (m_output.contains("To revisit your choice of class")) {
+        answer = "male";
+    } else if (m_output.contains("Please enter the distribution")) {
+        answer = "accept";
+    } else {
+        return;
+    }
+
+    m_output.clear();
+    send(answer);
+}
+
+void Bot::send(const QString &line) {
+
+    QByteArray data = line.toUtf8();
+
+    if (m_options.transport == Telnet) {
+        m_socket->write(data + "\r\n");
+        return;
+    }
+
+    // frames sent by a client must be masked
+    QByteArray frame;
+    frame.append((char) (0x80 | WS_TEXT));
+    if (data.length() < 126) {
+        frame.append((char) (0x80 | data.length()));
+    } else {
+        frame.append((char) (0x80 | 126));
+        frame.append((char) ((data.length() >> 8) & 0xFF));
+        frame.append((char) (data.length() & 0xFF));
+    }
+
+    QByteArray maskingKey;
+    for (int i = 0; i < 4; i++) {
+        maskingKey.append((char) (qrand() % 0x100));
+    }
+    frame.append(maskingKey);
+
+    for (int i = 0; i < data.length(); i++) {
+        data[i] = data[i] ^ maskingKey[i % 4];
+    }
+    m_socket->write(frame + data);
+}
+
+QString Bot::nextCommand() {
+
+    int dice = qrand() % 100;
+
+    switch (m_options.profile) {
+        case Wander:
+            if (!m_exits.isEmpty() && dice < 80) {
+                return "go " + randomItem(m_exits);
+            }
+            return "look";
+
+        case Chat:
+            if (dice < 60) {
+                return "say " + randomItem(QStringList() << "Hello everyone!"
+                                                         << "How is everybody doing?"
+                                                         << "Anyone up for an adventure?");
+            } else if (dice < 75) {
+                return "shout Is anybody out there?";
+            } else if (dice < 90) {
+                return "who";
+            }
+            return "/me waves.";
+
+        case Fight:
+            if (dice < 50) {
+                return "kill " + randomItem(QStringList() << "guard" << "beggar" << "cat"
+                                                          << "shopper" << "worker");
+            } else if (dice < 60) {
+                return "stats";
+            } else if (!m_exits.isEmpty()) {
+                return "go " + randomItem(m_exits);
+            }
+            return "look";
+
+        case Shop:
+            if (dice < 40) {
+                return "buy";
+            } else if (dice < 55) {
+                return "inventory";
+            } else if (!m_exits.isEmpty()) {
+                return "go " + randomItem(m_exits);
+            }
+            return "look";
+    }
+
+    return "look";
+}
+
+void Bot::scheduleNextCommand() {
+
+    // spread commands randomly between half and one and a half times the mean interval, so that
+    // bots that were started at the same time don't stay in lockstep
+    int interval = 1000 / m_options.commandsPerSecond;
+    m_commandTimer->start(interval / 2 + qrand() % (interval + 1));
+}
+
+void Bot::fail(const QString &reason) {
+
+    if (m_state == Stopped) {
+        return;
+    }
+
+    stop();
+    emit error(reason);
+}
@@ -0,0 +1,105 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QStringList>
+#include <QTcpSocket>
+
+
+class QTimer;
+
+class Bot : public QObject {
+
+    Q_OBJECT
+
+    public:
+        enum Transport {
+            Telnet,
+            WebSocket
+        };
+
+        enum Profile {
+            Wander,
+            Chat,
+            Fight,
+            Shop
+        };
+
+        struct Options {
+            QString host;
+            quint16 port;
+            Transport transport;
+            Profile profile;
+            QString userName;
+            QString password;
+            QString race;
+            QString characterClass;
+            double commandsPerSecond;
+            int timeout;
+        };
+
+        Bot(const Options &options, QObject *parent = nullptr);
+        virtual ~Bot();
+
+        void start();
+        void stop();
+
+        static QString profileName(Profile profile);
+        static bool profileFromName(const QString &name, Profile &profile);
+
+    signals:
+        void signedIn(int msecs);
+        void commandSent();
+        void markerSent();
+        void commandCompleted(int usecs);
+        void error(const QString &reason);
+
+    private slots:
+        void onConnected();
+        void onReadyRead();
+        void onDisconnected();
+        void onSocketError(QAbstractSocket::SocketError socketError);
+
+        void onCommandTimer();
+        void onTimeout();
+
+    private:
+        enum State {
+            Connecting,
+            Handshaking,
+            SigningIn,
+            Playing,
+            Stopped
+        };
+
+        void processTelnetData();
+        void processWebSocketData();
+        void processOutput(const QString &output);
+        void processSignIn();
+
+        void send(const QString &line);
+        QString nextCommand();
+        void scheduleNextCommand();
+        void fail(const QString &reason);
+
+        Options m_options;
+        State m_state;
+
+        QTcpSocket *m_socket;
+        QByteArray m_readBuffer;
+        QByteArray m_fragment;
+        QString m_output;
+
+        QTimer *m_commandTimer;
+        QTimer *m_timeoutTimer;
+        QElapsedTimer m_signInTimer;
+        QElapsedTimer m_replyTimer;
+        bool m_awaitingReply;
+        QString m_marker;
+        int m_numMarkers;
+
+        QStringList m_exits;
+};
+
+#endif // BOT_H
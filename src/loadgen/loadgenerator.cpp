@@ -0,0 +1,205 @@
+#include "loadgenerator.h"
+
+#include <QTextStream>
+#include <QTimer>
+
+
+static QTextStream &out() {
+
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+
+LoadGenerator::LoadGenerator(const Options &options, QObject *parent) :
+    QObject(parent),
+    m_options(options),
+    m_numSignedIn(0),
+    m_numIntervalCommands(0),
+    m_numCommandsSent(0),
+    m_numMarkersSent(0) {
+
+    m_startTimer = new QTimer(this);
+    m_startTimer->setInterval(m_options.numBots > 0 ? 1000 * m_options.rampUp / m_options.numBots :
+                                                      0);
+    connect(m_startTimer, SIGNAL(timeout()), SLOT(onStartTimer()));
+
+    m_reportTimer = new QTimer(this);
+    m_reportTimer->setInterval(5000);
+    connect(m_reportTimer, SIGNAL(timeout()), SLOT(onReportTimer()));
+
+    m_durationTimer = new QTimer(this);
+    m_durationTimer->setSingleShot(true);
+    m_durationTimer->setInterval(1000 * m_options.duration);
+    connect(m_durationTimer, SIGNAL(timeout()), SLOT(onDurationTimer()));
+}
+
+LoadGenerator::~LoadGenerator() {
+}
+
+void LoadGenerator::start() {
+
+    out() << "Starting " << m_options.numBots << " bots against " << m_options.host
+          << " over " << m_options.rampUp << "s, running for " << m_options.duration << "s...\n";
+    out().flush();
+
+    m_elapsedTimer.start();
+    m_startTimer->start();
+    m_reportTimer->start();
+    m_durationTimer->start();
+}
+
+void LoadGenerator::onStartTimer() {
+
+    int index = m_bots.length();
+    if (index >= m_options.numBots) {
+        m_startTimer->stop();
+        return;
+    }
+
+    // distribute transports and profiles evenly, so that any prefix of the bots is representative
+    int numWebSocketBots = qRound(m_options.webSocketRatio * (index + 1));
+    int numPreviousWebSocketBots = qRound(m_options.webSocketRatio * index);
+
+    Bot::Options botOptions;
+    botOptions.host = m_options.host;
+    botOptions.transport = (numWebSocketBots > numPreviousWebSocketBots ? Bot::WebSocket :
+                                                                           Bot::Telnet);
+    botOptions.port = (botOptions.transport == Bot::WebSocket ? m_options.webSocketPort :
+                                                                m_options.telnetPort);
+    botOptions.profile = m_options.profiles[index % m_options.profiles.length()];
+    botOptions.userName = botName(index);
+    botOptions.password = m_options.password;
+    botOptions.race = m_options.race;
+    botOptions.characterClass = m_options.characterClass;
+    botOptions.commandsPerSecond = m_options.commandsPerSecond;
+    botOptions.timeout = m_options.timeout;
+
+    Bot *bot = new Bot(botOptions, this);
+    connect(bot, SIGNAL(signedIn(int)), SLOT(onBotSignedIn(int)));
+    connect(bot, SIGNAL(commandSent()), SLOT(onBotCommandSent()));
+    connect(bot, SIGNAL(markerSent()), SLOT(onBotMarkerSent()));
+    connect(bot, SIGNAL(commandCompleted(int)), SLOT(onBotCommandCompleted(int)));
+    connect(bot, SIGNAL(error(QString)), SLOT(onBotError(QString)));
+    m_bots.append(bot);
+
+    bot->start();
+}
+
+void LoadGenerator::onReportTimer() {
+
+    printReport(false);
+}
+
+void LoadGenerator::onDurationTimer() {
+
+    m_startTimer->stop();
+    m_reportTimer->stop();
+
+    for (Bot *bot : m_bots) {
+        bot->stop();
+    }
+
+    printReport(true);
+
+    emit finished();
+}
+
+void LoadGenerator::onBotSignedIn(int msecs) {
+
+    m_numSignedIn++;
+    m_signInTimes.append(msecs);
+}
+
+void LoadGenerator::onBotCommandSent() {
+
+    m_numCommandsSent++;
+}
+
+void LoadGenerator::onBotMarkerSent() {
+
+    m_numMarkersSent++;
+}
+
+void LoadGenerator::onBotCommandCompleted(int usecs) {
+
+    m_latencies.append(usecs);
+    m_numIntervalCommands++;
+}
+
+void LoadGenerator::onBotError(const QString &reason) {
+
+    m_errors[reason]++;
+}
+
+QString LoadGenerator::botName(int index) const {
+
+    // user names may only consist of letters
+    QString suffix;
+    for (int i = 0; i < 4; i++) {
+        suffix.prepend(QChar('a' + index % 26));
+        index /= 26;
+    }
+    return m_options.namePrefix + suffix;
+}
+
+void LoadGenerator::printReport(bool final) {
+
+    qint64 elapsed = m_elapsedTimer.elapsed();
+
+    int numErrors = 0;
+    for (int count : m_errors) {
+        numErrors += count;
+    }
+
+    if (!final) {
+        out() << QString("[%1s] %2/%3 bots signed in, %4 commands/s, p50 %5ms, p99 %6ms, "
+                         "%7 errors\n")
+                 .arg(elapsed / 1000, 4)
+                 .arg(m_numSignedIn).arg(m_bots.length())
+                 .arg(m_numIntervalCommands / 5.0, 0, 'f', 1)
+                 .arg(percentile(m_latencies, 0.50) / 1000.0, 0, 'f', 1)
+                 .arg(percentile(m_latencies, 0.99) / 1000.0, 0, 'f', 1)
+                 .arg(numErrors);
+        out().flush();
+        m_numIntervalCommands = 0;
+        return;
+    }
+
+    out() << "\n"
+             "Bots started:          " << m_bots.length() << "\n"
+             "Bots signed in:        " << m_numSignedIn << "\n"
+             "Sign-in time (p50):    " << percentile(m_signInTimes, 0.50) << "ms\n"
+             "Sign-in time (p99):    " << percentile(m_signInTimes, 0.99) << "ms\n"
+             "Commands sent:         " << m_numCommandsSent << "\n"
+             "Commands completed:    " << m_latencies.size() << "\n"
+             "Throughput:            "
+          << QString::number(1000.0 * m_latencies.size() / qMax(elapsed, (qint64) 1), 'f', 1)
+          << " commands/s\n"
+             "Markers sent:          " << m_numMarkersSent << "\n"
+             "Server input rate:     "
+          << QString::number(1000.0 * (m_numCommandsSent + m_numMarkersSent) /
+                             qMax(elapsed, (qint64) 1), 'f', 1)
+          << " lines/s (commands and markers)\n"
+             "Round-trip time (p50): "
+          << QString::number(percentile(m_latencies, 0.50) / 1000.0, 'f', 2) << "ms\n"
+             "Round-trip time (p99): "
+          << QString::number(percentile(m_latencies, 0.99) / 1000.0, 'f', 2) << "ms\n"
+             "Round-trip time (max): "
+          << QString::number(percentile(m_latencies, 1.0) / 1000.0, 'f', 2) << "ms\n"
+             "Errors:                " << numErrors << "\n";
+    for (auto it = m_errors.constBegin(); it != m_errors.constEnd(); ++it) {
+        out() << "  " << it.key() << ": " << it.value() << "\n";
+    }
+    out().flush();
+}
+
+int LoadGenerator::percentile(QVector<int> values, double fraction) {
+
+    if (values.isEmpty()) {
+        return 0;
+    }
+
+    qSort(values);
+    return values[qRound(fraction * (values.size() - 1))];
+}
@@ -0,0 +1,80 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QVector>
+
+#include "bot.h"
+
+
+class QTimer;
+
+class LoadGenerator : public QObject {
+
+    Q_OBJECT
+
+    public:
+        struct Options {
+            QString host;
+            quint16 telnetPort;
+            quint16 webSocketPort;
+            int numBots;
+            double webSocketRatio;
+            QList<Bot::Profile> profiles;
+            double commandsPerSecond;
+            int rampUp;
+            int duration;
+            QString namePrefix;
+            QString password;
+            QString race;
+            QString characterClass;
+            int timeout;
+        };
+
+        LoadGenerator(const Options &options, QObject *parent = nullptr);
+        virtual ~LoadGenerator();
+
+        void start();
+
+    signals:
+        void finished();
+
+    private slots:
+        void onStartTimer();
+        void onReportTimer();
+        void onDurationTimer();
+
+        void onBotSignedIn(int msecs);
+        void onBotCommandSent();
+        void onBotMarkerSent();
+        void onBotCommandCompleted(int usecs);
+        void onBotError(const QString &reason);
+
+    private:
+        QString botName(int index) const;
+
+        void printReport(bool final);
+
+        static int percentile(QVector<int> values, double fraction);
+
+        Options m_options;
+
+        QList<Bot *> m_bots;
+        QTimer *m_startTimer;
+        QTimer *m_reportTimer;
+        QTimer *m_durationTimer;
+        QElapsedTimer m_elapsedTimer;
+
+        int m_numSignedIn;
+        QVector<int> m_signInTimes;
+        QVector<int> m_latencies;
+        int m_numIntervalCommands;
+        qint64 m_numCommandsSent;
+        qint64 m_numMarkersSent;
+        QMap<QString, int> m_errors;
+};
+
+#endif // LOADGENERATOR_H
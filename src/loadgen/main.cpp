@@ -0,0 +1,128 @@
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QRegExp>
+#include <QStringList>
+#include <QTextStream>
+
+#include "loadgenerator.h"
+
+
+static void printUsage() {
+
+    QTextStream(stderr) <<
+        "Usage: loadgen [options]\n"
+        "\n"
+        "Simulates players connecting to a running PlainText server.\n"
+        "\n"
+        "Options:\n"
+        "  --host <host>             Server host (default: 127.0.0.1)\n"
+        "  --telnet-port <port>      Telnet port (default: $PT_TELNET_PORT or 4801)\n"
+        "  --websocket-port <port>   WebSocket port (default: $PT_WEBSOCKET_PORT or 4802)\n"
+        "  --bots <n>                Number of simulated players (default: 100)\n"
+        "  --websocket-ratio <r>     Fraction of bots connecting over WebSocket, 0 to 1\n"
+        "                            (default: 0.5)\n"
+        "  --profiles <list>         Comma-separated behaviour profiles to cycle through:\n"
+        "                            wander, chat, fight, shop (default: all)\n"
+        "  --rate <n>                Commands per second per bot (default: 0.5)\n"
+        "  --ramp-up <seconds>       Time over which bots are started (default: 10)\n"
+        "  --duration <seconds>      Total duration of the run (default: 60)\n"
+        "  --timeout <seconds>       Time after which a sign-in or command fails (default: 10)\n"
+        "  --name-prefix <prefix>    Prefix for bot names, letters only (default: Loadbot)\n"
+        "  --password <password>     Password for bot accounts (default: loadtest)\n"
+        "  --race <race>             Race to select when signing up (default: human)\n"
+        "  --class <class>           Class to select when signing up (default: knight)\n";
+}
+
+int main(int argc, char *argv[]) {
+
+    QCoreApplication application(argc, argv);
+
+    qsrand(QDateTime::currentMSecsSinceEpoch());
+
+    LoadGenerator::Options options;
+    options.host = "127.0.0.1";
+    options.telnetPort = qgetenv("PT_TELNET_PORT").toUInt();
+    options.webSocketPort = qgetenv("PT_WEBSOCKET_PORT").toUInt();
+    options.numBots = 100;
+    options.webSocketRatio = 0.5;
+    options.profiles << Bot::Wander << Bot::Chat << Bot::Fight << Bot::Shop;
+    options.commandsPerSecond = 0.5;
+    options.rampUp = 10;
+    options.duration = 60;
+    options.timeout = 10000;
+    options.namePrefix = "Loadbot";
+    options.password = "loadtest";
+    options.race = "human";
+    options.characterClass = "knight";
+
+    if (options.telnetPort == 0) {
+        options.telnetPort = 4801;
+    }
+    if (options.webSocketPort == 0) {
+        options.webSocketPort = 4802;
+    }
+
+    QStringList arguments = application.arguments().mid(1);
+    while (!arguments.isEmpty()) {
+        QString option = arguments.takeFirst();
+        if (option == "--help" || arguments.isEmpty()) {
+            printUsage();
+            return option == "--help" ? 0 : 1;
+        }
+
+        QString value = arguments.takeFirst();
+        bool ok = true;
+        if (option == "--host") {
+            options.host = value;
+        } else if (option == "--telnet-port") {
+            options.telnetPort = value.toUShort(&ok);
+        } else if (option == "--websocket-port") {
+            options.webSocketPort = value.toUShort(&ok);
+        } else if (option == "--bots") {
+            options.numBots = value.toInt(&ok);
+        } else if (option == "--websocket-ratio") {
+            options.webSocketRatio = value.toDouble(&ok);
+            ok = ok && options.webSocketRatio >= 0.0 && options.webSocketRatio <= 1.0;
+        } else if (option == "--profiles") {
+            options.profiles.clear();
+            for (const QString &name : value.split(',')) {
+                Bot::Profile profile;
+                ok = ok && Bot::profileFromName(name.trimmed(), profile);
+                options.profiles << profile;
+            }
+        } else if (option == "--rate") {
+            options.commandsPerSecond = value.toDouble(&ok);
+            ok = ok && options.commandsPerSecond > 0.0;
+        } else if (option == "--ramp-up") {
+            options.rampUp = value.toInt(&ok);
+        } else if (option == "--duration") {
+            options.duration = value.toInt(&ok);
+        } else if (option == "--timeout") {
+            options.timeout = 1000 * value.toInt(&ok);
+        } else if (option == "--name-prefix") {
+            options.namePrefix = value;
+            ok = QRegExp("[A-Za-z]{1,8}").exactMatch(value);
+        } else if (option == "--password") {
+            options.password = value;
+            ok = value.length() >= 6;
+        } else if (option == "--race") {
+            options.race = value;
+        } else if (option == "--class") {
+            options.characterClass = value;
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            QTextStream(stderr) << "Invalid value for " << option << ": " << value << "\n\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    LoadGenerator generator(options);
+    QObject::connect(&generator, SIGNAL(finished()), &application, SLOT(quit()));
+    generator.start();
+
+    return application.exec();
+}
@@ -2,14 +2,26 @@
 
 #include "application.h"
 
+#include "test_broadcast.h"
+#include "test_commandinterpreter.h"
 #include "test_container.h"
 #include "test_crashes.h"
+#include "test_datamap.h"
+#include "test_eventpruning.h"
 #include "test_floodevent.h"
+#include "test_gameobjectptr.h"
 #include "test_help.h"
+#include "test_httpserver.h"
+#include "test_inputlimits.h"
+#include "test_internedstring.h"
 #include "test_movement.h"
+#include "test_nameindex.h"
 #include "test_openandclose.h"
+#include "test_realm.h"
+#include "test_roomdescription.h"
 #include "test_serialization.h"
 #include "test_visualevents.h"
+#include "test_websocketcompression.h"
 
 
 int main(int argc, char *argv[]) {
@@ -24,6 +36,18 @@ int main(int argc, char *argv[]) {
     HelpTest test6;
     OpenAndCloseTest test7;
     FloodEventTest test8;
+    WebSocketCompressionTest test9;
+    HttpServerTest test10;
+    BroadcastTest test11;
+    EventPruningTest test12;
+    RoomDescriptionTest test13;
+    GameObjectPtrTest test14;
+    RealmTest test15;
+    InternedStringTest test16;
+    DataMapTest test17;
+    NameIndexTest test18;
+    CommandInterpreterTest test19;
+    InputLimitsTest test20;
 
     QTest::qExec(&test1);
     QTest::qExec(&test2);
@@ -33,6 +57,18 @@ int main(int argc, char *argv[]) {
     QTest::qExec(&test6);
     QTest::qExec(&test7);
     QTest::qExec(&test8);
+    QTest::qExec(&test9);
+    QTest::qExec(&test10);
+    QTest::qExec(&test11);
+    QTest::qExec(&test12);
+    QTest::qExec(&test13);
+    QTest::qExec(&test14);
+    QTest::qExec(&test15);
+    QTest::qExec(&test16);
+    QTest::qExec(&test17);
+    QTest::qExec(&test18);
+    QTest::qExec(&test19);
+    QTest::qExec(&test20);
 
     return 0;
 }
@@ -0,0 +1,134 @@
+#ifndef TEST_BROADCAST_H
+#define TEST_BROADCAST_H
+
+#include "testcase.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QSignalSpy>
+#include <QTest>
+
+#include "encodedmessage.h"
+#include "player.h"
+#include "realm.h"
+#include "room.h"
+#include "session.h"
+#include "soundevent.h"
+
+
+class BroadcastTest : public TestCase {
+
+    Q_OBJECT
+
+    private slots:
+        virtual void init() {
+
+            Realm *realm = Realm::instance();
+            Room *room = qobject_cast<Room *>(realm->getObject(GameObjectType::Room, 1));
+
+            for (int i = 0; i < 500; i++) {
+                Player *player = new Player(realm);
+                player->setName(QString("Listener%1").arg(i));
+                player->setCurrentRoom(room);
+                room->addCharacter(player);
+
+                Session *session = new Session(realm, "Mock", "", this);
+                session->setEncoding(i % 2 ? EncodedMessage::TelnetEncoding :
+                                             EncodedMessage::WebSocketEncoding);
+                player->setSession(session);
+
+                m_players.append(player);
+                m_sessions.append(session);
+            }
+        }
+
+        virtual void cleanup() {
+
+            Realm *realm = Realm::instance();
+            Room *room = qobject_cast<Room *>(realm->getObject(GameObjectType::Room, 1));
+
+            for (const GameObjectPtr &player : m_players) {
+                room->removeCharacter(player);
+                player.cast<Player *>()->setSession(nullptr);
+                player->setDeleted();
+            }
+            m_players.clear();
+
+            qDeleteAll(m_sessions);
+            m_sessions.clear();
+        }
+
+        void testEncodedOncePerEncoding() {
+
+            QSignalSpy webSocketSpy(m_sessions[0], SIGNAL(write(QByteArray)));
+            QSignalSpy telnetSpy(m_sessions[1], SIGNAL(write(QByteArray)));
+
+            m_players.send("Someone shouts \"Hello!\"\nIt echoes.", Teal);
+
+            QCOMPARE(webSocketSpy.count(), 1);
+            QCOMPARE(telnetSpy.count(), 1);
+            QCOMPARE(webSocketSpy.takeFirst()[0].toByteArray(),
+                     QByteArray("\x1B[36mSomeone shouts \"Hello!\"\nIt echoes.\n\x1B[0m"));
+            QCOMPARE(telnetSpy.takeFirst()[0].toByteArray(),
+                     QByteArray("\x1B[36mSomeone shouts \"Hello!\"\r\nIt echoes.\r\n\x1B[0m"));
+
+            m_players.send("{ \"inputType\": \"text\" }");
+
+            QCOMPARE(webSocketSpy.takeFirst()[0].toByteArray(),
+                     QByteArray("{ \"inputType\": \"text\" }"));
+            QVERIFY(telnetSpy.takeFirst()[0].toByteArray().isEmpty());
+        }
+
+        void testShoutHeardBy500Players() {
+
+            QString message = "Someone shouts \"Is anybody out there?\"";
+
+            {
+                qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+                for (int i = 0; i < 100; i++) {
+                    for (const GameObjectPtr &player : m_players) {
+                        player->send(message, Teal);
+                    }
+                }
+
+                qint64 end = QDateTime::currentMSecsSinceEpoch();
+                qDebug() << "Sending to every player separately took " << (end - start) << "ms";
+            }
+
+            {
+                qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+                for (int i = 0; i < 100; i++) {
+                    m_players.send(message, Teal);
+                }
+
+                qint64 end = QDateTime::currentMSecsSinceEpoch();
+                qDebug() << "Broadcasting to all players took " << (end - start) << "ms";
+            }
+
+            {
+                Realm *realm = Realm::instance();
+                Room *room = qobject_cast<Room *>(realm->getObject(GameObjectType::Room, 1));
+
+                qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+                for (int i = 0; i < 100; i++) {
+                    SoundEvent *event = new SoundEvent(room, 1.0);
+                    event->setDescription(message);
+                    event->fire();
+                    QVERIFY(event->affectedCharacters().length() >= 500);
+                }
+
+                qint64 end = QDateTime::currentMSecsSinceEpoch();
+                qDebug() << "Firing sound events heard by all players took " << (end - start)
+                         << "ms";
+            }
+        }
+
+    private:
+        GameObjectPtrList m_players;
+        QList<Session *> m_sessions;
+};
+
+#endif // TEST_BROADCAST_H
@@ -0,0 +1,148 @@
+#ifndef TEST_COMMANDINTERPRETER_H
+#define TEST_COMMANDINTERPRETER_H
+
+#include "testcase.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QSignalSpy>
+#include <QTest>
+
+#include "commandregistry.h"
+#include "commandtrie.h"
+#include "player.h"
+#include "portal.h"
+#include "realm.h"
+#include "room.h"
+#include "session.h"
+
+
+class CommandInterpreterTest : public TestCase {
+
+    Q_OBJECT
+
+    private slots:
+        void testCommandTrie() {
+
+            CommandTrie trie;
+            trie.insert("look");
+            trie.insert("lose");
+            trie.insert("l");
+            trie.insert("look");
+
+            QString lo("lo");
+            QString loo("loo");
+            QString l("l");
+            QString x("x");
+            QCOMPARE(trie.count(QStringRef(&lo)), 2);
+            QCOMPARE(trie.count(QStringRef(&l)), 3);
+            QCOMPARE(trie.count(QStringRef(&x)), 0);
+            QCOMPARE(trie.uniqueMatch(QStringRef(&loo)), QString("look"));
+            QCOMPARE(trie.uniqueMatch(QStringRef(&lo)), QString());
+            QCOMPARE(trie.uniqueMatch(QStringRef(&x)), QString());
+        }
+
+        void testExitNames() {
+
+            Realm *realm = Realm::instance();
+            Room *roomA = qobject_cast<Room *>(realm->getObject(GameObjectType::Room, 1));
+            Room *roomB = qobject_cast<Room *>(realm->getObject(GameObjectType::Room, 2));
+            Portal *portal = qobject_cast<Portal *>(realm->getObject(GameObjectType::Portal, 3));
+
+            QVERIFY(roomA->hasExitNamed("a-to-b"));
+            QVERIFY(!roomA->hasExitNamed("b-to-a"));
+            QVERIFY(roomB->hasExitNamed("b-to-a"));
+
+            portal->setName2("wooden door");
+            QVERIFY(roomB->hasExitNamed("wooden door"));
+            QVERIFY(roomB->hasExitNamed("door"));
+            QVERIFY(!roomB->hasExitNamed("b-to-a"));
+            QVERIFY(!roomA->hasExitNamed("door"));
+
+            portal->setName2("b-to-a");
+            QVERIFY(roomB->hasExitNamed("b-to-a"));
+            QVERIFY(!roomB->hasExitNamed("door"));
+        }
+
+        void testAbbreviations() {
+
+            Realm *realm = Realm::instance();
+            Session *session = new Session(realm, "Mock", "", this);
+            Player *player = (Player *) realm->getPlayer("Arie");
+            player->setSession(session);
+
+            QSignalSpy spy(player->session(), SIGNAL(write(QByteArray)));
+
+            player->execute("lo");
+            QCOMPARE(spy.count(), 1);
+            QCOMPARE(spy.takeFirst()[0].toString().trimmed(), QString("Command is not unique."));
+
+            player->execute("xyzzy  now");
+            QCOMPARE(spy.count(), 1);
+            QCOMPARE(spy.takeFirst()[0].toString().trimmed(),
+                     QString("Command \"xyzzy\" does not exist."));
+
+            player->execute("invent");
+            QCOMPARE(spy.count(), 1);
+            QVERIFY(!spy.takeFirst()[0].toString().startsWith("Command"));
+
+            player->setSession(nullptr);
+            delete session;
+        }
+
+        void testRoutingPerSecond() {
+
+            Realm *realm = Realm::instance();
+            CommandRegistry *registry = realm->commandRegistry();
+
+            // a regular player in a room of its own, so that only commands without side effects
+            // are routed: exact names, abbreviations, ambiguous and unknown commands
+            Room *room = new Room(realm);
+            Player *player = new Player(realm);
+            player->setName("Router");
+            player->setCurrentRoom(room);
+            room->addCharacter(player);
+            Session *session = new Session(realm, "Mock", "", this);
+            player->setSession(session);
+
+            QStringList commands;
+            commands << "look" << "loo" << "inventory" << "inv" << "stats" << "who"
+                     << "lo" << "xyzzy";
+
+            QSignalSpy spy(session, SIGNAL(write(QByteArray)));
+
+            const int numRounds = 1000;
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numRounds; i++) {
+                for (const QString &command : commands) {
+                    player->execute(command);
+                }
+            }
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Routing" << numRounds * commands.size() << "commands among"
+                     << registry->commandNames().size() << "commands took " << (end - start)
+                     << "ms";
+
+            int numNotUnique = 0;
+            int numNotExisting = 0;
+            for (const QList<QVariant> &arguments : spy) {
+                QString message = arguments[0].toString().trimmed();
+                if (message == "Command is not unique.") {
+                    numNotUnique++;
+                } else if (message == "Command \"xyzzy\" does not exist.") {
+                    numNotExisting++;
+                }
+            }
+            QCOMPARE(numNotUnique, numRounds);
+            QCOMPARE(numNotExisting, numRounds);
+
+            player->setSession(nullptr);
+            player->setDeleted();
+            delete session;
+        }
+};
+
+#endif // TEST_COMMANDINTERPRETER_H
@@ -59,7 +59,7 @@ class ContainerTest : public TestCase {
             Player *player = (Player *) realm->getPlayer("Arie");
             player->setSession(session);
 
-            QSignalSpy spy(player->session(), SIGNAL(write(QString)));
+            QSignalSpy spy(player->session(), SIGNAL(write(QByteArray)));
 
             player->execute("put all in container");
 
@@ -0,0 +1,123 @@
+#ifndef TEST_DATAMAP_H
+#define TEST_DATAMAP_H
+
+#include "testcase.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QTest>
+
+#include "datamap.h"
+#include "item.h"
+#include "realm.h"
+
+
+class DataMapTest : public TestCase {
+
+    Q_OBJECT
+
+    private slots:
+        void testTypedValues() {
+
+            DataMap map;
+            QVERIFY(map.isEmpty());
+
+            QVERIFY(map.setInt("hitCount", 3));
+            QVERIFY(!map.setInt("hitCount", 3));
+            QVERIFY(map.setBool("angry", true));
+            QVERIFY(map.setDouble("mood", 0.5));
+            QVERIFY(map.setValue("greeting", QString("Hello")));
+            QVERIFY(!map.setValue("greeting", QString("Hello")));
+            QCOMPARE(map.size(), 4);
+
+            QCOMPARE(map.intValue("hitCount"), 3);
+            QCOMPARE(map.boolValue("angry"), true);
+            QCOMPARE(map.doubleValue("mood"), 0.5);
+            QCOMPARE(map.value("greeting"), QVariant(QString("Hello")));
+            QVERIFY(!map.contains("missing"));
+            QCOMPARE(map.intValue("missing"), 0);
+
+            // values may change type
+            QVERIFY(map.setValue("hitCount", QString("many")));
+            QCOMPARE(map.value("hitCount"), QVariant(QString("many")));
+            QVERIFY(map.setInt("greeting", 1));
+            QCOMPARE(map.intValue("greeting"), 1);
+            QCOMPARE(map.size(), 4);
+
+            DataMap copy(map);
+            QVERIFY(copy == map);
+            QVERIFY(copy.setValue("hitCount", QString("few")));
+            QVERIFY(copy != map);
+            QCOMPARE(map.value("hitCount"), QVariant(QString("many")));
+
+            QVariantMap variantMap = map.toVariantMap();
+            QCOMPARE(variantMap.keys(), QStringList() << "angry" << "greeting" << "hitCount"
+                                                      << "mood");
+            QVERIFY(DataMap::fromVariantMap(variantMap) == map);
+        }
+
+        void testJsonRoundTrip() {
+
+            Realm *realm = Realm::instance();
+            Item *item = new Item(realm);
+            item->setName("statue");
+            item->setIntData("visits", 12);
+            item->setBoolData("cursed", false);
+            item->setStringData("inscription", "Beware");
+            item->setDoubleData("weight", 2.5);
+
+            QVariantMap data = item->data();
+            QCOMPARE(data.keys(), QStringList() << "cursed" << "inscription" << "visits"
+                                                << "weight");
+
+            QString jsonString = item->toJsonString(SkipId);
+
+            Item *loaded = new Item(realm);
+            loaded->loadJson(jsonString);
+            QCOMPARE(loaded->intData("visits"), 12);
+            QCOMPARE(loaded->boolData("cursed"), false);
+            QCOMPARE(loaded->stringData("inscription"), QString("Beware"));
+            QCOMPARE(loaded->doubleData("weight"), 2.5);
+            QCOMPARE(loaded->toJsonString(SkipId), jsonString);
+        }
+
+        void testNpcTicksPerSecond() {
+
+            Realm *realm = Realm::instance();
+            Item *npc = new Item(realm);
+            for (int i = 0; i < 8; i++) {
+                npc->setIntData(QString("counter%1").arg(i), i);
+            }
+            npc->setStringData("state", "idle");
+
+            const int numTicks = 100000;
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            evaluate(QString("var npc = $('item:%1');"
+                             "for (var i = 0; i < %2; i++) {"
+                             "    npc.setIntData('counter3', npc.intData('counter3') + 1);"
+                             "    npc.setBoolData('busy', i % 2 === 0);"
+                             "}").arg(npc->id()).arg(numTicks));
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Running" << numTicks << "scripted data updates took " << (end - start)
+                     << "ms";
+
+            QCOMPARE(npc->intData("counter3"), 3 + numTicks);
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numTicks; i++) {
+                npc->setIntData("counter5", npc->intData("counter5") + 1);
+            }
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Running" << numTicks << "native data updates took " << (end - start)
+                     << "ms";
+
+            QCOMPARE(npc->intData("counter5"), 5 + numTicks);
+        }
+};
+
+#endif // TEST_DATAMAP_H
@@ -0,0 +1,249 @@
+#ifndef TEST_EVENTPRUNING_H
+#define TEST_EVENTPRUNING_H
+
+#include "testcase.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QTest>
+
+#include "character.h"
+#include "portal.h"
+#include "realm.h"
+#include "room.h"
+#include "roomgraph.h"
+#include "soundevent.h"
+#include "util.h"
+#include "vector3d.h"
+#include "visualevent.h"
+
+
+class EventPruningTest : public TestCase {
+
+    Q_OBJECT
+
+    private:
+        void connectRooms(Room *roomA, Room *roomB) {
+
+            Portal *portal = new Portal(Realm::instance());
+            portal->setRoom(roomA);
+            portal->setRoom2(roomB);
+            portal->setName(Util::directionForVector(roomB->position() - roomA->position()));
+            portal->setName2(Util::directionForVector(roomA->position() - roomB->position()));
+            portal->setFlags(PortalFlags::CanSeeThrough | PortalFlags::CanHearThrough);
+
+            roomA->addPortal(portal);
+            roomB->addPortal(portal);
+        }
+
+        Room *roomAt(int row, int column) {
+
+            return m_rooms[row * 100 + column].cast<Room *>();
+        }
+
+    private slots:
+        virtual void init() {
+
+            Realm *realm = Realm::instance();
+
+            // every test gets a grid of its own, far away from the grids of previous tests
+            static int numGrids = 0;
+            int offset = 10000 + 100000 * numGrids;
+            numGrids++;
+
+            const int numRows = 100;
+            const int numColumns = 100;
+            for (int i = 0; i < numRows; i++) {
+                for (int j = 0; j < numColumns; j++) {
+                    Room *room = new Room(realm);
+                    // keep clear of the test world, so its player doesn't count as a listener
+                    room->setPosition(Point3D(offset + 20 * j, offset + 20 * i, 0));
+
+                    if (i > 0) {
+                        connectRooms(m_rooms[(i - 1) * numColumns + j].cast<Room *>(), room);
+                    }
+                    if (j > 0) {
+                        connectRooms(m_rooms[i * numColumns + j - 1].cast<Room *>(), room);
+                    }
+                    m_rooms.append(room);
+                }
+            }
+
+            m_listener = new Character(realm);
+            m_listener->setName("Listener");
+            m_listener->enter(roomAt(5, 5));
+        }
+
+        virtual void cleanup() {
+
+            m_rooms.clear();
+            m_listener = nullptr;
+        }
+
+        void testPruning() {
+
+            {
+                SoundEvent *event = new SoundEvent(roomAt(5, 8), 1.0);
+                event->setDescription("You hear a bang.");
+                event->fire();
+
+                QVERIFY(event->affectedCharacters().contains(m_listener));
+                QVERIFY(event->numVisitedRooms() > 1);
+            }
+
+            {
+                SoundEvent *event = new SoundEvent(roomAt(99, 99), 1.0);
+                event->setDescription("You hear a bang.");
+                event->fire();
+
+                QVERIFY(event->affectedCharacters().isEmpty());
+                QCOMPARE(event->numVisitedRooms(), 1);
+            }
+
+            {
+                VisualEvent *event = new VisualEvent(roomAt(99, 99), 1.0);
+                event->setDescription("You see a flash.");
+                event->fire();
+
+                QVERIFY(event->affectedCharacters().isEmpty());
+                QCOMPARE(event->numVisitedRooms(), 1);
+            }
+
+            // strong events are still heard from afar
+            {
+                SoundEvent *event = new SoundEvent(roomAt(99, 99), 1000.0);
+                event->setDescription("You hear a loud explosion.");
+                event->fire();
+
+                QVERIFY(event->affectedCharacters().contains(m_listener));
+            }
+
+            // the occupancy follows the characters around
+            m_listener->leave(roomAt(5, 5));
+            QCOMPARE(Realm::instance()->roomGraph()->occupancy(roomAt(5, 5)->graphIndex()), 0);
+
+            {
+                SoundEvent *event = new SoundEvent(roomAt(5, 8), 1.0);
+                event->setDescription("You hear a bang.");
+                event->fire();
+
+                QVERIFY(event->affectedCharacters().isEmpty());
+                QCOMPARE(event->numVisitedRooms(), 1);
+            }
+
+            m_listener->enter(roomAt(99, 98));
+
+            {
+                SoundEvent *event = new SoundEvent(roomAt(99, 99), 1.0);
+                event->setDescription("You hear a bang.");
+                event->fire();
+
+                QVERIFY(event->affectedCharacters().contains(m_listener));
+            }
+        }
+
+        void testAmplifyingPortal() {
+
+            Realm *realm = Realm::instance();
+
+            // a portal without any length can still amplify an event, so it can be heard from
+            // as far away as a strong event
+            Room *amplifier = new Room(realm);
+            amplifier->setPosition(roomAt(99, 99)->position());
+
+            Portal *portal = new Portal(realm);
+            portal->setRoom(amplifier);
+            portal->setRoom2(roomAt(99, 99));
+            portal->setName("speaker");
+            portal->setName2("horn");
+            portal->setFlags(PortalFlags::CanHearThrough);
+            GameEventMultiplierMap multipliers;
+            multipliers[GameEventType::Sound] = 1000.0;
+            portal->setEventMultipliers(multipliers);
+            amplifier->addPortal(portal);
+            roomAt(99, 99)->addPortal(portal);
+
+            {
+                SoundEvent *event = new SoundEvent(amplifier, 1.0);
+                event->setDescription("You hear a loud explosion.");
+                event->fire();
+
+                QVERIFY(event->affectedCharacters().contains(m_listener));
+            }
+
+            // don't let the amplifier affect the pruning in other tests
+            amplifier->removePortal(portal);
+            roomAt(99, 99)->removePortal(portal);
+            portal->setDeleted();
+        }
+
+        void testProximityQueries() {
+
+            Realm *realm = Realm::instance();
+            Point3D center = roomAt(5, 5)->position();
+
+            QCOMPARE(realm->roomsWithin(center, 0).length(), 1);
+            QCOMPARE(realm->roomsWithin(center, 20).length(), 5);
+            QCOMPARE(realm->roomsWithin(center, 30).length(), 9);
+            QVERIFY(realm->roomsWithin(center, 30).contains(roomAt(6, 6)));
+            QCOMPARE(realm->roomsWithin(center, 3000).length(), 10000);
+
+            Point3D position = roomAt(5, 8)->position();
+            QCOMPARE(realm->charactersWithin(position, 59).length(), 0);
+            QCOMPARE(realm->charactersWithin(position, 60).length(), 1);
+            QVERIFY(realm->charactersWithin(position, 60).contains(m_listener));
+
+            m_listener->leave(roomAt(5, 5));
+            m_listener->enter(roomAt(5, 7));
+            QCOMPARE(realm->charactersWithin(position, 20).length(), 1);
+
+            // moving a room moves it in the index
+            roomAt(0, 0)->setPosition(position + Vector3D(0, 0, 10));
+            QVERIFY(realm->roomsWithin(position, 10).contains(roomAt(0, 0)));
+            QVERIFY(!realm->roomsWithin(center + Vector3D(-100, -100, 0), 10)
+                         .contains(roomAt(0, 0)));
+
+            QCOMPARE(evaluate(QString("Realm.roomsWithin($('room:%1').position, 20).length")
+                              .arg(roomAt(5, 5)->id())).toInt32(), 5);
+            QCOMPARE(evaluate(QString("Realm.charactersWithin($('room:%1').position, 0)[0].name")
+                              .arg(roomAt(5, 7)->id())).toString(), QString("Listener"));
+        }
+
+        void testEventsPerSecond() {
+
+            const int numEvents = 1000;
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numEvents; i++) {
+                Room *room = m_rooms[Util::randomInt(0, m_rooms.length())].cast<Room *>();
+                SoundEvent *event = new SoundEvent(room, 1.0);
+                event->setDescription("You hear a bang.");
+                event->fire();
+            }
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Firing" << numEvents << "sound events took " << (end - start) << "ms ("
+                     << (1000 * numEvents / qMax(end - start, (qint64) 1)) << "events/s)";
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numEvents; i++) {
+                Room *room = m_rooms[Util::randomInt(0, m_rooms.length())].cast<Room *>();
+                VisualEvent *event = new VisualEvent(room, 1.0);
+                event->setDescription("You see a flash.");
+                event->fire();
+            }
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Firing" << numEvents << "visual events took " << (end - start) << "ms ("
+                     << (1000 * numEvents / qMax(end - start, (qint64) 1)) << "events/s)";
+        }
+
+    private:
+        GameObjectPtrList m_rooms;
+
+        Character *m_listener;
+};
+
+#endif // TEST_EVENTPRUNING_H
@@ -3,17 +3,21 @@
 
 #include "testcase.h"
 
+#include <climits>
 #include <cmath>
 
 #include <QDateTime>
 #include <QDebug>
 #include <QTest>
 
+#include "area.h"
+#include "areaevent.h"
 #include "character.h"
 #include "floodevent.h"
 #include "portal.h"
 #include "realm.h"
 #include "room.h"
+#include "roomgraph.h"
 #include "util.h"
 
 
@@ -112,6 +116,87 @@ class FloodEventTest : public TestCase {
             QCOMPARE(event->numVisitedRooms(), 10000);
         }
 
+        void testParallelPropagation() {
+
+            Realm *realm = Realm::instance();
+            RoomGraph *graph = realm->roomGraph();
+
+            Area *area = new Area(realm);
+            area->setName("Plains");
+
+            const int numRows = 224;
+            const int numColumns = 224;
+            QVector<Room *> rooms;
+            GameObjectPtrList areaRooms;
+            for (int i = 0; i < numRows; i++) {
+                for (int j = 0; j < numColumns; j++) {
+                    Room *room = new Room(realm);
+                    room->setPosition(Point3D(10000 + 20 * j, 10000 + 20 * i, 0));
+                    room->setArea(area);
+
+                    if (i > 0) {
+                        connectRooms(rooms[(i - 1) * numColumns + j], room);
+                    }
+                    if (j > 0) {
+                        connectRooms(rooms[i * numColumns + j - 1], room);
+                    }
+                    rooms.append(room);
+                    areaRooms.append(room);
+                }
+            }
+            area->setRooms(areaRooms);
+
+            int numRooms = rooms.size();
+            Room *origin = rooms[numRooms / 2];
+
+            const int numWitnesses = 100;
+            for (int i = 0; i < numWitnesses; i++) {
+                Character *character = new Character(realm);
+                character->setName(QString("Witness %1").arg(i));
+                character->enter(rooms[i * numRooms / numWitnesses + 1]);
+                m_characters.append(character);
+            }
+
+            int parallelThreshold = graph->parallelThreshold();
+
+            for (int pass = 0; pass < 2; pass++) {
+                bool parallel = (pass == 1);
+                graph->setParallelThreshold(parallel ? 0 : INT_MAX);
+
+                FloodEvent *event = new FloodEvent(origin, 0.1);
+                event->setDescription("There's a little water on the ground");
+
+                qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+                event->fire();
+
+                qint64 end = QDateTime::currentMSecsSinceEpoch();
+                qDebug() << (parallel ? "Parallel" : "Serial") << "flood event over" << numRooms
+                         << "rooms took " << (end - start) << "ms";
+
+                QCOMPARE(event->numVisitedRooms(), numRooms);
+                QCOMPARE(event->affectedCharacters().length(), numWitnesses);
+            }
+
+            graph->setParallelThreshold(parallelThreshold);
+
+            {
+                AreaEvent *event = new AreaEvent(origin, 1.0);
+                event->setDescription("The ground trembles.");
+
+                qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+                event->fire();
+
+                qint64 end = QDateTime::currentMSecsSinceEpoch();
+                qDebug() << "Area event over" << numRooms << "rooms took " << (end - start)
+                         << "ms";
+
+                QCOMPARE(event->numVisitedRooms(), numWitnesses + 1);
+                QCOMPARE(event->affectedCharacters().length(), numWitnesses);
+            }
+        }
+
     private:
         GameObjectPtrList m_rooms;
         GameObjectPtrList m_characters;
@@ -0,0 +1,198 @@
+#ifndef TEST_GAMEOBJECTPTR_H
+#define TEST_GAMEOBJECTPTR_H
+
+#include "testcase.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QTest>
+#include <QVector>
+
+#include "item.h"
+#include "realm.h"
+#include "room.h"
+#include "util.h"
+
+
+class GameObjectPtrTest : public TestCase {
+
+    Q_OBJECT
+
+    private slots:
+        void testEndOfLife() {
+
+            Realm *realm = Realm::instance();
+            Item *item = new Item(realm);
+            item->setName("pebble");
+
+            GameObjectPtr pointer(item);
+            GameObjectPtr copy(pointer);
+            GameObjectPtr assigned;
+            assigned = copy;
+
+            GameObjectPtr other(new Item(realm));
+            swap(other, assigned);
+            QVERIFY(other == item);
+            QVERIFY(assigned != item);
+
+            GameObjectPtrList list;
+            list << pointer << other << assigned << copy;
+            QCOMPARE(list.length(), 4);
+
+            delete item;
+
+            QVERIFY(pointer.unsafeCast<Item *>() == nullptr);
+            QVERIFY(copy.unsafeCast<Item *>() == nullptr);
+            QVERIFY(other.unsafeCast<Item *>() == nullptr);
+            QVERIFY(assigned.unsafeCast<Item *>() != nullptr);
+
+            // pointers that are part of a list are removed from it
+            QCOMPARE(list.length(), 1);
+            QVERIFY(list[0] == assigned);
+        }
+
+        void testPointerChurn() {
+
+            Realm *realm = Realm::instance();
+            Room *room = new Room(realm);
+
+            const int numPointers = 100000;
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            QVector<GameObjectPtr> pointers(numPointers);
+            for (int i = 0; i < numPointers; i++) {
+                pointers[i] = room;
+            }
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Registering" << numPointers << "pointers took " << (end - start) << "ms";
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numPointers; i++) {
+                GameObjectPtr temporary(pointers[Util::randomInt(0, numPointers)]);
+                pointers[Util::randomInt(0, numPointers)] = temporary;
+            }
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Copying" << numPointers << "pointers took " << (end - start) << "ms";
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            // release the pointers in an order unrelated to the one they were registered in
+            for (int i = 0; i < numPointers; i++) {
+                pointers[(i * 7919) % numPointers] = GameObjectPtr();
+            }
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Releasing" << numPointers << "pointers took " << (end - start) << "ms";
+        }
+
+        void testIndexedList() {
+
+            Realm *realm = Realm::instance();
+
+            GameObjectPtrList list;
+            list.setIndexed(true);
+
+            QVector<Item *> items;
+            for (int i = 0; i < 100; i++) {
+                Item *item = new Item(realm);
+                items.append(item);
+                list.append(item);
+                list.append(item);
+            }
+            QCOMPARE(list.length(), 200);
+
+            QVERIFY(list.contains(items[50]));
+            QVERIFY(list.removeOne(items[50]));
+            QVERIFY(list.contains(items[50]));
+            QVERIFY(list.removeOne(items[50]));
+            QVERIFY(!list.contains(items[50]));
+            QVERIFY(!list.removeOne(items[50]));
+            QCOMPARE(list.indexOf(items[51]), 100);
+
+            QCOMPARE(list.removeAll(items[0]), 2);
+            QCOMPARE(list.indexOf(items[1]), 0);
+
+            GameObjectPtrList copy = list;
+            QVERIFY(copy.isIndexed());
+            QVERIFY(copy == list);
+
+            delete items[99];
+            QCOMPARE(list.length(), 194);
+            QCOMPARE(copy.length(), 194);
+            QVERIFY(list.contains(items[98]));
+
+            list.clear();
+            QVERIFY(!list.contains(items[1]));
+            list.append(items[1]);
+            QVERIFY(list.contains(items[1]));
+        }
+
+        void testListOperationsPerSecond() {
+
+            Realm *realm = Realm::instance();
+
+            const int numItems = 1000;
+            QVector<Item *> items;
+            GameObjectPtrList list;
+            GameObjectPtrList indexedList;
+            indexedList.setIndexed(true);
+            for (int i = 0; i < numItems; i++) {
+                Item *item = new Item(realm);
+                items.append(item);
+                list.append(item);
+                indexedList.append(item);
+            }
+
+            const int numIterations = 1000;
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            int numVisited = 0;
+            for (int i = 0; i < numIterations; i++) {
+                for (const GameObjectPtr &pointer : list) {
+                    if (!pointer.isNull()) {
+                        numVisited++;
+                    }
+                }
+            }
+            QCOMPARE(numVisited, numItems * numIterations);
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Iterating" << numIterations << "times over" << numItems << "pointers took "
+                     << (end - start) << "ms";
+
+            QVector<GameObjectPtrList *> candidates;
+            candidates << &list << &indexedList;
+            for (GameObjectPtrList *candidate : candidates) {
+                const char *kind = (candidate->isIndexed() ? "indexed" : "plain");
+
+                start = QDateTime::currentMSecsSinceEpoch();
+
+                for (int i = 0; i < numIterations; i++) {
+                    QVERIFY(candidate->contains(items[Util::randomInt(0, numItems)]));
+                }
+
+                end = QDateTime::currentMSecsSinceEpoch();
+                qDebug() << numIterations << "lookups in a" << kind << "list took "
+                         << (end - start) << "ms";
+
+                start = QDateTime::currentMSecsSinceEpoch();
+
+                for (int i = numItems - 1; i >= 0; i--) {
+                    QVERIFY(candidate->removeOne(items[i]));
+                }
+
+                end = QDateTime::currentMSecsSinceEpoch();
+                qDebug() << "Removing" << numItems << "pointers from a" << kind << "list took "
+                         << (end - start) << "ms";
+
+                QVERIFY(candidate->isEmpty());
+            }
+        }
+};
+
+#endif // TEST_GAMEOBJECTPTR_H
@@ -26,7 +26,7 @@ class HelpTest : public TestCase {
             Player *player = (Player *) realm->getPlayer("Arie");
             player->setSession(session);
 
-            QSignalSpy spy(player->session(), SIGNAL(write(QString)));
+            QSignalSpy spy(player->session(), SIGNAL(write(QByteArray)));
 
             player->execute("help open");
 
@@ -0,0 +1,146 @@
+#ifndef TEST_HTTPSERVER_H
+#define TEST_HTTPSERVER_H
+
+#include "testcase.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QStringList>
+#include <QTest>
+
+#include "httpserver.h"
+
+
+class HttpServerTest : public TestCase {
+
+    Q_OBJECT
+
+    private slots:
+        virtual void init() {
+
+            if (qgetenv("PT_WEB_DIR").isEmpty()) {
+                for (const QString &dir : QStringList() << "web" << "../web" << "../../web") {
+                    if (QFile::exists(dir + "/index.html")) {
+                        qputenv("PT_WEB_DIR", dir.toLatin1());
+                        break;
+                    }
+                }
+            }
+
+            QVERIFY2(QFile::exists(qgetenv("PT_WEB_DIR") + "/index.html"),
+                     "PT_WEB_DIR should point to the web/ directory");
+
+            m_server = new HttpServer(0, 4802);
+        }
+
+        virtual void cleanup() {
+
+            delete m_server;
+        }
+
+        void testIndex() {
+
+            bool keepAlive;
+            QByteArray response = m_server->handleRequest("GET / HTTP/1.1\r\n"
+                                                          "Host: localhost", &keepAlive);
+            QVERIFY(response.startsWith("HTTP/1.1 200 OK\r\n"));
+            QVERIFY(response.contains("Cache-Control: no-cache\r\n"));
+            QVERIFY(response.contains("var PT_WEBSOCKET_PORT = 4802;"));
+            QVERIFY(!response.contains("{{title}}"));
+            QVERIFY(keepAlive);
+
+            response = m_server->handleRequest("GET /index.html HTTP/1.0", &keepAlive);
+            QVERIFY(response.startsWith("HTTP/1.1 200 OK\r\n"));
+            QVERIFY(response.contains("Connection: close\r\n"));
+            QVERIFY(!keepAlive);
+
+            response = m_server->handleRequest("GET /does-not-exist.js HTTP/1.1", &keepAlive);
+            QVERIFY(response.startsWith("HTTP/1.1 404 Not Found\r\n"));
+            QVERIFY(keepAlive);
+
+            response = m_server->handleRequest("GET /../realm.json HTTP/1.1", &keepAlive);
+            QVERIFY(response.startsWith("HTTP/1.1 403 Forbidden\r\n"));
+
+            // the body of a rejected request is not read, so the connection is closed
+            response = m_server->handleRequest("POST / HTTP/1.1\r\n"
+                                               "Content-Length: 5", &keepAlive);
+            QVERIFY(response.startsWith("HTTP/1.1 405 Method Not Allowed\r\n"));
+            QVERIFY(response.contains("Connection: close\r\n"));
+            QVERIFY(!keepAlive);
+        }
+
+        void testConditionalAndCompressedRequests() {
+
+            QByteArray response = m_server->handleRequest("GET /lib/zepto.js HTTP/1.1\r\n"
+                                                          "Accept-Encoding: gzip, deflate");
+            QVERIFY(response.startsWith("HTTP/1.1 200 OK\r\n"));
+            QVERIFY(response.contains("Content-Encoding: gzip\r\n"));
+
+            int eTagIndex = response.indexOf("ETag: ") + 6;
+            QByteArray eTag = response.mid(eTagIndex, response.indexOf('\r', eTagIndex) - eTagIndex);
+            QVERIFY(eTag.startsWith('"') && eTag.endsWith('"'));
+
+            response = m_server->handleRequest(QByteArray("GET /lib/zepto.js HTTP/1.1\r\n"
+                                                          "Accept-Encoding: gzip\r\n"
+                                                          "If-None-Match: ") + eTag);
+            QVERIFY(response.startsWith("HTTP/1.1 304 Not Modified\r\n"));
+            QVERIFY(response.contains("ETag: " + eTag + "\r\n"));
+            QVERIFY(response.endsWith("\r\n\r\n"));
+
+            // the uncompressed representation has a validator of its own
+            response = m_server->handleRequest(QByteArray("GET /lib/zepto.js HTTP/1.1\r\n"
+                                                          "If-None-Match: ") + eTag);
+            QVERIFY(response.startsWith("HTTP/1.1 200 OK\r\n"));
+            QVERIFY(!response.contains("Content-Encoding: gzip\r\n"));
+            QVERIFY(!response.contains("ETag: " + eTag + "\r\n"));
+
+            eTagIndex = response.indexOf("ETag: ") + 6;
+            QByteArray identityETag = response.mid(eTagIndex,
+                                                   response.indexOf('\r', eTagIndex) - eTagIndex);
+            response = m_server->handleRequest(QByteArray("GET /lib/zepto.js HTTP/1.1\r\n"
+                                                          "If-None-Match: W/") + identityETag);
+            QVERIFY(response.startsWith("HTTP/1.1 304 Not Modified\r\n"));
+
+            response = m_server->handleRequest("GET /lib/zepto.js HTTP/1.1\r\n"
+                                               "Accept-Encoding: deflate, gzip;q=0");
+            QVERIFY(!response.contains("Content-Encoding: gzip\r\n"));
+
+            response = m_server->handleRequest("GET /lib/zepto.js HTTP/1.1\r\n"
+                                               "Accept-Encoding: gzip; q=0.5, deflate");
+            QVERIFY(response.contains("Content-Encoding: gzip\r\n"));
+
+            response = m_server->handleRequest("GET /lib/zepto.js HTTP/1.1\r\n"
+                                               "Accept-Encoding: *;q=0.1");
+            QVERIFY(response.contains("Content-Encoding: gzip\r\n"));
+        }
+
+        void testRequestThroughput() {
+
+            QList<QByteArray> requests;
+            requests << "GET / HTTP/1.1\r\nAccept-Encoding: gzip"
+                     << "GET /main.js HTTP/1.1\r\nAccept-Encoding: gzip"
+                     << "GET /main.css HTTP/1.1\r\nAccept-Encoding: gzip"
+                     << "GET /lib/zepto.js HTTP/1.1\r\nAccept-Encoding: gzip"
+                     << "GET /lib/fabric.js HTTP/1.1"
+                     << "GET /img/add.png HTTP/1.1";
+
+            const int numRequests = 100000;
+            qint64 numBytes = 0;
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numRequests; i++) {
+                numBytes += m_server->handleRequest(requests[i % requests.length()]).length();
+            }
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Handling" << numRequests << "requests (" << numBytes << "bytes) took "
+                     << (end - start) << "ms";
+        }
+
+    private:
+        HttpServer *m_server;
+};
+
+#endif // TEST_HTTPSERVER_H
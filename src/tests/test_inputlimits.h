@@ -0,0 +1,116 @@
+#ifndef TEST_INPUTLIMITS_H
+#define TEST_INPUTLIMITS_H
+
+#include "testcase.h"
+
+#include <QSignalSpy>
+#include <QTest>
+
+#include "gamethread.h"
+#include "realm.h"
+#include "session.h"
+
+
+class InputLimitsTest : public TestCase {
+
+    Q_OBJECT
+
+    private slots:
+        void testQueueLatency() {
+
+            Realm *realm = Realm::instance();
+            waitForEmptyQueue(realm);
+
+            QCOMPARE(realm->gameThread()->queueLatency(), 0);
+        }
+
+        void testTokenBucket() {
+
+            Realm *realm = Realm::instance();
+            const Session::InputLimits &limits = Session::inputLimits();
+            Session *session = createSession(realm);
+
+            QSignalSpy spy(session, SIGNAL(write(QByteArray)));
+            int numDeferred = Session::numDeferredSignIns();
+
+            // a full burst is admitted right away
+            for (int i = 0; i < limits.commandBurst; i++) {
+                session->onUserInput("input");
+            }
+            QCOMPARE(Session::numDeferredSignIns(), numDeferred);
+            QCOMPARE(spy.count(), 0);
+
+            // the bucket is empty now
+            session->onUserInput("input");
+            QCOMPARE(Session::numDeferredSignIns(), numDeferred + 1);
+            QCOMPARE(spy.count(), 1);
+
+            closeSession(session);
+
+            // and refills over time
+            session = createSession(realm);
+            numDeferred = Session::numDeferredSignIns();
+
+            for (int i = 0; i < limits.commandBurst; i++) {
+                session->onUserInput("input");
+            }
+            QTest::qWait(int(2000 / limits.commandsPerSecond));
+            waitForEmptyQueue(realm);
+
+            session->onUserInput("input");
+            QCOMPARE(Session::numDeferredSignIns(), numDeferred);
+
+            closeSession(session);
+        }
+
+        void testOverflowRejection() {
+
+            Realm *realm = Realm::instance();
+            const Session::InputLimits &limits = Session::inputLimits();
+            Session *session = createSession(realm);
+
+            int numDropped = Session::numDroppedCommands();
+
+            for (int i = 0; i < limits.commandBurst; i++) {
+                session->onUserInput("input");
+            }
+
+            // the input timer doesn't get a chance to run, so all deferred input stays pending
+            for (int i = 0; i < limits.maxPendingCommands; i++) {
+                session->onUserInput("input");
+            }
+            QCOMPARE(Session::numDroppedCommands(), numDropped);
+
+            session->onUserInput("input");
+            QCOMPARE(Session::numDroppedCommands(), numDropped + 1);
+            QCOMPARE(session->sessionState(), limits.disconnectOnOverflow ? Session::SessionClosed :
+                                                                            Session::SigningIn);
+
+            closeSession(session);
+        }
+
+    private:
+        Session *createSession(Realm *realm) {
+
+            // sessions that haven't been opened yet have no session handler, so the sign-in
+            // events their input generates are processed without side effects
+            Session *session = new Session(realm, "Mock", "", this);
+            session->setSessionState(Session::SigningIn);
+            return session;
+        }
+
+        void closeSession(Session *session) {
+
+            // the session is kept alive, as the game thread may still process its sign-in events
+            session->setSessionState(Session::SessionClosed);
+        }
+
+        void waitForEmptyQueue(Realm *realm) {
+
+            while (realm->gameThread()->queueLength() > 0) {
+                QTest::qWait(10);
+            }
+        }
+};
+
+#endif // TEST_INPUTLIMITS_H
@@ -0,0 +1,146 @@
+#ifndef TEST_INTERNEDSTRING_H
+#define TEST_INTERNEDSTRING_H
+
+#include "testcase.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QSet>
+#include <QTest>
+
+#include "internedstring.h"
+#include "item.h"
+#include "realm.h"
+#include "room.h"
+
+
+class InternedStringTest : public TestCase {
+
+    Q_OBJECT
+
+    private slots:
+        void testInterning() {
+
+            InternedString sword("sword");
+            InternedString otherSword(QString("swo") + QString("rd"));
+            InternedString shield("shield");
+
+            QVERIFY(sword == otherSword);
+            QVERIFY(sword != shield);
+            QCOMPARE(sword.hash(), qHash(QString("sword")));
+            QVERIFY(sword.toString().constData() == otherSword.toString().constData());
+
+            QVERIFY(InternedString().isEmpty());
+            QVERIFY(InternedString(QString()) == InternedString(""));
+
+            int numInternedStrings = InternedString::numInternedStrings();
+            InternedString anotherSword("sword");
+            QCOMPARE(InternedString::numInternedStrings(), numInternedStrings);
+            QVERIFY(anotherSword == sword);
+
+            // objects with the same name share a single copy of it
+            Realm *realm = Realm::instance();
+            Item *item = new Item(realm);
+            item->setName(QString("ax") + QString("e"));
+            Item *otherItem = new Item(realm);
+            otherItem->setName("axe");
+            QVERIFY(item->name().constData() == otherItem->name().constData());
+            QVERIFY(item->plural().constData() == otherItem->plural().constData());
+        }
+
+        void testRelease() {
+
+            int numInternedStrings = InternedString::numInternedStrings();
+
+            {
+                InternedString gold(QString("$%1 worth of gold").arg(12345));
+                InternedString copy(gold);
+                InternedString assigned;
+                assigned = copy;
+                QCOMPARE(InternedString::numInternedStrings(), numInternedStrings + 1);
+            }
+            QCOMPARE(InternedString::numInternedStrings(), numInternedStrings);
+
+            // names that are no longer used by any object are released, the item is not saved so
+            // no copies of it are made in the background
+            Realm *realm = Realm::instance();
+            Item *item = new Item(realm, 0, DontSave);
+            item->setName("pile of 54321 gold");
+            QCOMPARE(InternedString::numInternedStrings(), numInternedStrings + 1);
+            item->setName("pile of 54322 gold");
+            QCOMPARE(InternedString::numInternedStrings(), numInternedStrings + 1);
+            delete item;
+            QCOMPARE(InternedString::numInternedStrings(), numInternedStrings);
+        }
+
+        void testDefiniteNamesPerSecond() {
+
+            Realm *realm = Realm::instance();
+            Room *room = new Room(realm);
+
+            const int numItems = 200;
+            for (int i = 0; i < numItems; i++) {
+                Item *item = new Item(realm);
+                item->setName(i % 4 ? QString("rock %1").arg(i % 10) : QString("pebble"));
+                room->addItem(item);
+            }
+
+            QSet<const QChar *> distinctNames;
+            int numNameBytes = 0;
+            for (const GameObjectPtr &item : room->items()) {
+                distinctNames.insert(item->name().constData());
+                numNameBytes += item->name().length() * sizeof(QChar);
+            }
+            qDebug() << numItems << "names take" << numNameBytes << "bytes, of which"
+                     << distinctNames.size() << "distinct strings are stored";
+
+            const int numNames = 100000;
+            const GameObjectPtrList &items = room->items();
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numNames; i++) {
+                QVERIFY(!items[i % numItems]->definiteName(items).isEmpty());
+            }
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Rendering" << numNames << "definite names in a pool of" << numItems
+                     << "items took " << (end - start) << "ms";
+        }
+
+        void testTriggerDispatchPerSecond() {
+
+            Realm *realm = Realm::instance();
+            Item *item = new Item(realm);
+            evaluate(QString("$('item:%1').setTrigger('onuse', function() { return false; })")
+                     .arg(item->id()));
+
+            const int numLookups = 1000000;
+            const InternedString onUse("onuse");
+            const InternedString onDrop("ondrop");
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numLookups; i++) {
+                QVERIFY(item->invokeTrigger(onDrop));
+            }
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Dispatching" << numLookups << "unset triggers took " << (end - start)
+                     << "ms";
+
+            const int numInvocations = 10000;
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numInvocations; i++) {
+                QVERIFY(!item->invokeTrigger(onUse));
+            }
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Dispatching" << numInvocations << "set triggers took " << (end - start)
+                     << "ms";
+        }
+};
+
+#endif // TEST_INTERNEDSTRING_H
@@ -3,18 +3,39 @@
 
 #include "testcase.h"
 
+#include <QDateTime>
+#include <QDebug>
+#include <QSignalSpy>
 #include <QTest>
 
+#include "gameeventaggregator.h"
 #include "player.h"
 #include "portal.h"
 #include "realm.h"
 #include "room.h"
+#include "session.h"
+#include "util.h"
 
 
 class MovementTest : public TestCase {
 
     Q_OBJECT
 
+    private:
+        void connectRooms(Room *roomA, Room *roomB) {
+
+            Portal *portal = new Portal(Realm::instance());
+            portal->setRoom(roomA);
+            portal->setRoom2(roomB);
+            portal->setName(Util::directionForVector(roomB->position() - roomA->position()));
+            portal->setName2(Util::directionForVector(roomA->position() - roomB->position()));
+            portal->setFlags(PortalFlags::CanSeeThrough | PortalFlags::CanHearThrough |
+                             PortalFlags::CanPassThrough);
+
+            roomA->addPortal(portal);
+            roomB->addPortal(portal);
+        }
+
     private slots:
         void testMovement() {
 
@@ -25,22 +46,26 @@ class MovementTest : public TestCase {
             QCOMPARE(player->currentRoom()->name(), QString("Room A"));
 
             {
-                player->invokeScriptMethod("go", portal);
+                player->go(portal);
                 QCOMPARE(player->currentRoom()->name(), QString("Room B"));
 
                 QCOMPARE(player->direction(), Vector3D(0, 100, 0));
+                QCOMPARE(player->currentAction(), QString("walk"));
             }
 
             {
-                player->invokeScriptMethod("go", portal);
+                player->go(portal);
                 QCOMPARE(player->currentRoom()->name(), QString("Room A"));
 
                 QCOMPARE(player->direction(), Vector3D(0, -100, 0));
+                QCOMPARE(player->currentAction(), QString("run"));
+                QCOMPARE(evaluate(QString("$('player:%1').currentAction").arg(player->id()))
+                         .toString(), QString("run"));
             }
 
             {
                 Room *currentRoom = player->currentRoom().cast<Room *>();
-                player->invokeScriptMethod("go", currentRoom->portals()[0]);
+                player->go(currentRoom->portals()[0]);
                 QCOMPARE(player->currentRoom()->name(), QString("Room B"));
             }
 
@@ -55,7 +80,7 @@ class MovementTest : public TestCase {
             }
 
             {
-                player->invokeScriptMethod("go", realm->getObject(GameObjectType::Room, 1));
+                player->go(realm->getObject(GameObjectType::Room, 1));
                 QCOMPARE(player->currentRoom()->name(), QString("Room A"));
             }
 
@@ -63,6 +88,57 @@ class MovementTest : public TestCase {
                 player->execute("enter a-to-b");
                 QCOMPARE(player->currentRoom()->name(), QString("Room B"));
             }
+
+            {
+                evaluate(QString("$('player:%1').go($('portal:%2'))")
+                         .arg(player->id()).arg(portal->id()));
+                QCOMPARE(player->currentRoom()->name(), QString("Room A"));
+            }
+        }
+
+        void testCustomizedMovement() {
+
+            Realm *realm = Realm::instance();
+            Player *player = (Player *) realm->getPlayer("Arie");
+            Portal *portal = (Portal *) realm->getObject(GameObjectType::Portal, 3);
+
+            Room *roomA = (Room *) realm->getObject(GameObjectType::Room, 1);
+            Room *roomB = (Room *) realm->getObject(GameObjectType::Room, 2);
+            player->enter(roomA);
+            player->setCurrentAction("");
+
+            // customized movement replaces the native implementation, but can still call it
+            evaluate("var goCalls = 0;\n"
+                     "Character.prototype.go = function(pointer) {\n"
+                     "    goCalls++;\n"
+                     "    if (!this.currentAction) {\n"
+                     "        this.go(pointer);\n"
+                     "    }\n"
+                     "};");
+
+            player->go(portal);
+            QCOMPARE(evaluate("goCalls").toInt32(), 1);
+            QCOMPARE(player->currentRoom().cast<Room *>(), roomB);
+
+            // scripts can mark characters as busy, or no longer busy
+            QCOMPARE(player->currentAction(), QString("walk"));
+            evaluate(QString("$('player:%1').go($('portal:%2'))")
+                     .arg(player->id()).arg(portal->id()));
+            QCOMPARE(evaluate("goCalls").toInt32(), 2);
+            QCOMPARE(player->currentRoom().cast<Room *>(), roomB);
+
+            evaluate(QString("$('player:%1').currentAction = ''").arg(player->id()));
+            QCOMPARE(player->currentAction(), QString());
+            evaluate(QString("$('player:%1').go($('portal:%2'))")
+                     .arg(player->id()).arg(portal->id()));
+            QCOMPARE(evaluate("goCalls").toInt32(), 3);
+            QCOMPARE(player->currentRoom().cast<Room *>(), roomA);
+
+            evaluate("delete Character.prototype.go;");
+
+            player->go(portal);
+            QCOMPARE(evaluate("goCalls").toInt32(), 3);
+            QCOMPARE(player->currentRoom().cast<Room *>(), roomB);
         }
 
         void testMovementEvents() {
@@ -87,7 +163,7 @@ class MovementTest : public TestCase {
             character->setDirection(roomA->position() - roomC->position());
 
             {
-                player->invokeScriptMethod("go", roomB);
+                player->go(roomB);
 
                 QCOMPARE(evaluate("sounds.length").toInt32(), 0);
                 QCOMPARE(evaluate("visuals.length").toInt32(), 1);
@@ -96,7 +172,7 @@ class MovementTest : public TestCase {
             }
 
             {
-                player->invokeScriptMethod("go", roomC);
+                player->go(roomC);
 
                 QCOMPARE(evaluate("sounds.length").toInt32(), 0);
                 QCOMPARE(evaluate("visuals.length").toInt32(), 2);
@@ -105,7 +181,7 @@ class MovementTest : public TestCase {
             }
 
             {
-                player->invokeScriptMethod("go", roomB);
+                player->go(roomB);
 
                 QCOMPARE(evaluate("sounds.length").toInt32(), 0);
                 QCOMPARE(evaluate("visuals.length").toInt32(), 3);
@@ -114,7 +190,7 @@ class MovementTest : public TestCase {
             }
 
             {
-                player->invokeScriptMethod("go", roomA);
+                player->go(roomA);
 
                 QCOMPARE(evaluate("sounds.length").toInt32(), 0);
                 QCOMPARE(evaluate("visuals.length").toInt32(), 4);
@@ -126,7 +202,7 @@ class MovementTest : public TestCase {
             character->setDirection(roomC->position() - roomA->position());
 
             {
-                player->invokeScriptMethod("go", roomB);
+                player->go(roomB);
 
                 QCOMPARE(evaluate("sounds.length").toInt32(), 1);
                 QCOMPARE(evaluate("visuals.length").toInt32(), 4);
@@ -135,7 +211,7 @@ class MovementTest : public TestCase {
             }
 
             {
-                player->invokeScriptMethod("go", roomC);
+                player->go(roomC);
 
                 QCOMPARE(evaluate("sounds.length").toInt32(), 2);
                 QCOMPARE(evaluate("visuals.length").toInt32(), 4);
@@ -144,7 +220,7 @@ class MovementTest : public TestCase {
             }
 
             {
-                player->invokeScriptMethod("go", roomB);
+                player->go(roomB);
 
                 QCOMPARE(evaluate("sounds.length").toInt32(), 2);
                 QCOMPARE(evaluate("visuals.length").toInt32(), 5);
@@ -153,7 +229,7 @@ class MovementTest : public TestCase {
             }
 
             {
-                player->invokeScriptMethod("go", roomA);
+                player->go(roomA);
 
                 QCOMPARE(evaluate("sounds.length").toInt32(), 3);
                 QCOMPARE(evaluate("visuals.length").toInt32(), 5);
@@ -164,7 +240,7 @@ class MovementTest : public TestCase {
             character->setDirection(Vector3D(direction.y, direction.x, direction.z));
 
             {
-                player->invokeScriptMethod("go", roomB);
+                player->go(roomB);
 
                 QCOMPARE(evaluate("sounds.length").toInt32(), 4);
                 QCOMPARE(evaluate("visuals.length").toInt32(), 5);
@@ -173,7 +249,7 @@ class MovementTest : public TestCase {
             }
 
             {
-                player->invokeScriptMethod("go", roomC);
+                player->go(roomC);
 
                 QCOMPARE(evaluate("sounds.length").toInt32(), 5);
                 QCOMPARE(evaluate("visuals.length").toInt32(), 5);
@@ -181,6 +257,151 @@ class MovementTest : public TestCase {
                          QString("You hear someone running up to you from the right."));
             }
         }
+
+        void testAggregatedMovementEvents() {
+
+            Realm *realm = Realm::instance();
+            Room *roomA = (Room *) realm->getObject(GameObjectType::Room, 1);
+            Room *roomB = (Room *) realm->getObject(GameObjectType::Room, 2);
+            Room *roomC = (Room *) realm->getObject(GameObjectType::Room, 5);
+
+            Character *observer = new Character(realm);
+            observer->setName("Clara");
+            observer->enter(roomC);
+            observer->setDirection(roomA->position() - roomC->position());
+
+            evaluate("var aggregatedVisuals = [];");
+            observer->setTrigger("onvisual",
+                                 "function(message) { aggregatedVisuals.append(message); }");
+
+            QVector<Character *> goblins;
+            for (int i = 0; i < 3; i++) {
+                Character *goblin = new Character(realm);
+                goblin->setName("goblin");
+                goblin->setIndefiniteArticle("a");
+                goblin->setPlural("goblins");
+                goblin->enter(roomA);
+                goblins.append(goblin);
+            }
+
+            GameEventAggregator *aggregator = realm->eventAggregator();
+
+            {
+                aggregator->beginBatch();
+
+                for (Character *goblin : goblins) {
+                    goblin->go(roomB);
+                }
+                QCOMPARE(evaluate("aggregatedVisuals.length").toInt32(), 0);
+
+                aggregator->endBatch();
+
+                QCOMPARE(evaluate("aggregatedVisuals.length").toInt32(), 1);
+                QCOMPARE(evaluate("aggregatedVisuals[0]").toString(),
+                         QString("You see three goblins walking toward you."));
+            }
+
+            // outside of a batch, every event is delivered by itself
+            {
+                for (Character *goblin : goblins) {
+                    goblin->go(roomA);
+                }
+
+                QCOMPARE(evaluate("aggregatedVisuals.length").toInt32(), 4);
+                QCOMPARE(evaluate("aggregatedVisuals[3]").toString(),
+                         QString("You see a goblin running away from you."));
+            }
+        }
+
+        void testAggregatedPerceptionOrder() {
+
+            Realm *realm = Realm::instance();
+            Session *session = new Session(realm, "Mock", "", this);
+            Player *player = new Player(realm);
+            player->setName("Listener");
+            player->setSession(session);
+
+            QSignalSpy spy(session, SIGNAL(write(QByteArray)));
+
+            GameEventAggregator *aggregator = realm->eventAggregator();
+            InternedString onSound("onsound");
+
+            aggregator->beginBatch();
+
+            // the same message from different sources is delivered once per source
+            aggregator->addPerception(player, 1, onSound, "You hear a scream.");
+            aggregator->addPerception(player, 2, onSound, "You hear a scream.");
+            aggregator->addPerception(player, 2, onSound, "You hear a scream.");
+            QCOMPARE(aggregator->numPerceptions(), 2);
+
+            // messages sent directly don't overtake perceptions collected before them
+            player->send("You scream back.");
+            QCOMPARE(spy.count(), 3);
+            QCOMPARE(aggregator->numPerceptions(), 0);
+
+            aggregator->addPerception(player, 3, onSound, "You hear a bang.");
+            aggregator->endBatch();
+
+            QCOMPARE(spy.count(), 4);
+            QCOMPARE(spy[0][0].toString().trimmed(), QString("You hear a scream."));
+            QCOMPARE(spy[1][0].toString().trimmed(), QString("You hear a scream."));
+            QCOMPARE(spy[2][0].toString().trimmed(), QString("You scream back."));
+            QCOMPARE(spy[3][0].toString().trimmed(), QString("You hear a bang."));
+
+            player->setSession(nullptr);
+            player->setDeleted();
+            delete session;
+        }
+
+        void testCrowdMovement() {
+
+            Realm *realm = Realm::instance();
+
+            const int numRows = 40;
+            const int numColumns = 40;
+            QVector<Room *> rooms;
+            for (int i = 0; i < numRows; i++) {
+                for (int j = 0; j < numColumns; j++) {
+                    Room *room = new Room(realm);
+                    room->setPosition(Point3D(20 * j, 20 * i, 0));
+                    room->setFlags(RoomFlags::HasFloor);
+                    if (i > 0) {
+                        connectRooms(rooms[(i - 1) * numColumns + j], room);
+                    }
+                    if (j > 0) {
+                        connectRooms(rooms[i * numColumns + j - 1], room);
+                    }
+                    rooms.append(room);
+                }
+            }
+
+            const int numCharacters = 1000;
+            QVector<Character *> characters;
+            for (int i = 0; i < numCharacters; i++) {
+                Character *character = new Character(realm);
+                character->setName(QString("Walker %1").arg(i));
+                character->enter(rooms[Util::randomInt(0, rooms.size())]);
+                characters.append(character);
+            }
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            const int numSteps = 10;
+            for (int step = 0; step < numSteps; step++) {
+                for (Character *character : characters) {
+                    Room *room = character->currentRoom().cast<Room *>();
+                    const GameObjectPtrList &portals = room->portals();
+                    character->go(portals[Util::randomInt(0, portals.length())]);
+                    QVERIFY(character->currentRoom() != room);
+                }
+            }
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Moving" << numCharacters << "characters" << numSteps << "steps took "
+                     << (end - start) << "ms ("
+                     << (1000 * numCharacters * numSteps / qMax(end - start, (qint64) 1))
+                     << "steps/s)";
+        }
 };
 
 #endif // TEST_MOVEMENT_H
@@ -0,0 +1,156 @@
+#ifndef TEST_NAMEINDEX_H
+#define TEST_NAMEINDEX_H
+
+#include "testcase.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QTest>
+
+#include "item.h"
+#include "player.h"
+#include "realm.h"
+#include "room.h"
+#include "session.h"
+
+
+class NameIndexTest : public TestCase {
+
+    Q_OBJECT
+
+    private slots:
+        void testObjectsByName() {
+
+            Realm *realm = Realm::instance();
+            Room *room = new Room(realm);
+
+            GameObjectPtrList pears;
+            GameObjectPtrList apples;
+            for (int i = 0; i < 40; i++) {
+                Item *item = new Item(realm);
+                item->setName(i % 2 ? "red apple" : "green pear");
+                room->addItem(item);
+                (i % 2 ? apples : pears).append(item);
+            }
+
+            QVERIFY(room->itemsByName("ap") == apples);
+            QVERIFY(room->itemsByName("red") == apples);
+            QVERIFY(room->itemsByName("gr") == pears);
+            QVERIFY(room->itemsByName("") == room->items());
+            QVERIFY(room->itemsByName("banana").isEmpty());
+
+            // removals keep the remaining objects in order
+            room->removeItem(apples[3]);
+            apples.removeAt(3);
+            QVERIFY(room->itemsByName("apple") == apples);
+
+            // renames are picked up
+            Item *pear = pears.first().cast<Item *>();
+            pear->setName("rotten apple");
+            QVERIFY(room->itemsByName("apple") == GameObjectPtrList() << pear << apples);
+            QCOMPARE(room->itemsByName("pear").length(), pears.length() - 1);
+
+            // objects added again move to the end
+            room->removeItem(pear);
+            room->addItem(pear);
+            QVERIFY(room->itemsByName("apple") == GameObjectPtrList(apples) << pear);
+        }
+
+        void testOrdinals() {
+
+            Realm *realm = Realm::instance();
+            Room *market = createMarket(realm, 100, 20);
+            Player *player = createShopper(realm, market);
+
+            GameObjectPtr thirdApple = market->itemsByName("apple")[2];
+
+            player->execute("get 3.apple");
+            QCOMPARE(player->inventory().length(), 1);
+            QVERIFY(player->inventory()[0] == thirdApple);
+            QVERIFY(!market->items().contains(thirdApple));
+
+            player->execute("drop apple");
+            QCOMPARE(player->inventory().length(), 0);
+            QVERIFY(market->items().last() == thirdApple);
+            QVERIFY(market->itemsByName("apple").last() == thirdApple);
+
+            removeShopper(player);
+        }
+
+        void testCommandsPerSecond() {
+
+            Realm *realm = Realm::instance();
+            Room *market = createMarket(realm, 500, 100);
+            Player *player = createShopper(realm, market);
+
+            const int numCommands = 1000;
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numCommands; i++) {
+                player->execute(QString("look at %1.lantern").arg(i % 50 + 1));
+            }
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Looking at" << numCommands << "items in a room with"
+                     << market->items().length() << "items took " << (end - start) << "ms";
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numCommands; i++) {
+                player->execute(QString("get %1.apple").arg(i % 50 + 1));
+                player->execute("drop apple");
+            }
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Getting and dropping" << numCommands << "items in a room with"
+                     << market->items().length() << "items took " << (end - start) << "ms";
+
+            QCOMPARE(player->inventory().length(), 0);
+
+            removeShopper(player);
+        }
+
+    private:
+        Room *createMarket(Realm *realm, int numItems, int numMerchants) {
+
+            static const char *itemNames[] = {
+                "red apple", "green apple", "brass lantern", "wooden bowl", "iron pot"
+            };
+
+            Room *market = new Room(realm);
+            for (int i = 0; i < numItems; i++) {
+                Item *item = new Item(realm);
+                item->setName(itemNames[i % 5]);
+                item->setIndefiniteArticle("a");
+                market->addItem(item);
+            }
+            for (int i = 0; i < numMerchants; i++) {
+                Character *merchant = new Character(realm);
+                merchant->setName(QString("Merchant %1").arg(i));
+                merchant->setCurrentRoom(market);
+                market->addCharacter(merchant);
+            }
+            return market;
+        }
+
+        Player *createShopper(Realm *realm, Room *market) {
+
+            Player *player = new Player(realm);
+            player->setName("Shopper");
+            player->setCurrentRoom(market);
+            market->addCharacter(player);
+            player->setSession(new Session(realm, "Mock", "", this));
+            return player;
+        }
+
+        void removeShopper(Player *player) {
+
+            Session *session = player->session();
+            player->setSession(nullptr);
+            player->setDeleted();
+            delete session;
+        }
+};
+
+#endif // TEST_NAMEINDEX_H
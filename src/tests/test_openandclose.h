@@ -34,7 +34,7 @@ class OpenAndCloseTest : public TestCase {
                              PortalFlags::CanShootThroughIfOpen |
                              PortalFlags::CanPassThroughIfOpen);
 
-            QSignalSpy spy(player->session(), SIGNAL(write(QString)));
+            QSignalSpy spy(player->session(), SIGNAL(write(QByteArray)));
 
             QCOMPARE(player->currentRoom()->name(), QString("Room A"));
 
@@ -0,0 +1,317 @@
+#ifndef TEST_REALM_H
+#define TEST_REALM_H
+
+#include "testcase.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QTest>
+#include <QVector>
+
+#include "character.h"
+#include "gameobjectallocator.h"
+#include "item.h"
+#include "portal.h"
+#include "realm.h"
+#include "room.h"
+#include "soundevent.h"
+#include "util.h"
+#include "visualevent.h"
+
+
+class RealmTest : public TestCase {
+
+    Q_OBJECT
+
+    private:
+        int numAllocatedObjects() {
+
+            int numAllocated = 0;
+            for (const GameObjectAllocator::PoolStatistics &pool :
+                 GameObjectAllocator::statistics()) {
+                numAllocated += pool.numAllocated;
+            }
+            return numAllocated;
+        }
+
+        int numSlabs() {
+
+            int numSlabs = 0;
+            for (const GameObjectAllocator::PoolStatistics &pool :
+                 GameObjectAllocator::statistics()) {
+                numSlabs += pool.numSlabs;
+            }
+            return numSlabs;
+        }
+
+    private slots:
+        void testObjectTable() {
+
+            Realm *realm = Realm::instance();
+
+            int numItems = realm->allObjects(GameObjectType::Item).size();
+            int numObjects = realm->allObjects(GameObjectType::Unknown).size();
+
+            Item *item = new Item(realm);
+            Item *otherItem = new Item(realm);
+            QVERIFY(otherItem->id() > item->id());
+
+            QVERIFY(realm->getObject(GameObjectType::Item, item->id()) == item);
+            QVERIFY(realm->getObject(GameObjectType::Unknown, item->id()) == item);
+            QVERIFY(!realm->getObject(GameObjectType::Room, item->id()));
+            QVERIFY(!realm->getObject(GameObjectType::Item, otherItem->id() + 1000));
+
+            QVector<GameObject *> items = realm->allObjects(GameObjectType::Item);
+            QCOMPARE(items.size(), numItems + 2);
+            QVERIFY(items.contains(item));
+            QVERIFY(items.contains(otherItem));
+            QCOMPARE(realm->allObjects(GameObjectType::Unknown).size(), numObjects + 2);
+
+            uint id = item->id();
+            delete item;
+
+            QVERIFY(!realm->getObject(GameObjectType::Item, id));
+            QCOMPARE(realm->allObjects(GameObjectType::Item).size(), numItems + 1);
+            QVERIFY(realm->allObjects(GameObjectType::Item).contains(otherItem));
+
+            // ids of deleted objects are not handed out again
+            QVERIFY(realm->uniqueObjectId() > otherItem->id());
+        }
+
+        void testDeletedRoom() {
+
+            Realm *realm = Realm::instance();
+
+            // far away from the test world, so only these rooms are nearby
+            Room *room = new Room(realm);
+            room->setPosition(Point3D(2000000, 0, 0));
+            Room *neighbour = new Room(realm);
+            neighbour->setPosition(Point3D(2000000, 50, 0));
+
+            Portal *portal = new Portal(realm);
+            portal->setRoom(room);
+            portal->setRoom2(neighbour);
+            portal->setFlags(PortalFlags::CanHearThrough);
+            room->addPortal(portal);
+            neighbour->addPortal(portal);
+
+            QCOMPARE(realm->roomsWithin(Point3D(2000000, 0, 0), 100).length(), 2);
+            int roomIndex = room->graphIndex();
+            int neighbourIndex = neighbour->graphIndex();
+
+            room->removePortal(portal);
+            neighbour->removePortal(portal);
+            delete portal;
+
+            int numRooms = realm->rooms().length();
+            delete room;
+            QCOMPARE(realm->rooms().length(), numRooms - 1);
+
+            GameObjectPtrList rooms = realm->roomsWithin(Point3D(2000000, 0, 0), 100);
+            QCOMPARE(rooms.length(), 1);
+            QVERIFY(rooms[0] == neighbour);
+
+            // indices of the remaining rooms are stable, so events in flight can keep using them
+            QCOMPARE(neighbour->graphIndex(), neighbourIndex);
+            QVERIFY(!realm->roomGraph()->room(roomIndex));
+
+            SoundEvent *event = new SoundEvent(neighbour, 1.0);
+            event->setDescription("You hear a thud.");
+            event->fire();
+            QCOMPARE(event->numVisitedRooms(), 1);
+        }
+
+        void testObjectsPerSecond() {
+
+            Realm *realm = Realm::instance();
+
+            const int numObjects = 250000;
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            QVector<uint> ids;
+            ids.reserve(numObjects);
+            for (int i = 0; i < numObjects; i++) {
+                ids.append((new Item(realm))->id());
+            }
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Registering" << numObjects << "objects took " << (end - start) << "ms";
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            const int numLookups = 1000000;
+            for (int i = 0; i < numLookups; i++) {
+                uint id = ids[Util::randomInt(0, numObjects)];
+                QVERIFY(realm->getObject(GameObjectType::Item, id));
+            }
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << numLookups << "lookups took " << (end - start) << "ms";
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            const int numListings = 100;
+            for (int i = 0; i < numListings; i++) {
+                QVERIFY(realm->allObjects(GameObjectType::Portal).size() > 0);
+            }
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Listing the portals among" << numObjects << "objects" << numListings
+                     << "times took " << (end - start) << "ms";
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            QVERIFY(realm->allObjects(GameObjectType::Item).size() >= numObjects);
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Listing" << numObjects << "items took " << (end - start) << "ms";
+        }
+
+        void testPooledAllocation() {
+
+            Realm *realm = Realm::instance();
+
+            // the items aren't saved, so the sync thread doesn't allocate copies meanwhile
+            int numAllocated = numAllocatedObjects();
+
+            QVector<Item *> items;
+            for (int i = 0; i < 1000; i++) {
+                items.append(new Item(realm, 0, DontSave));
+            }
+            QCOMPARE(numAllocatedObjects(), numAllocated + 1000);
+
+            int numSlabsBefore = numSlabs();
+            for (Item *item : items) {
+                delete item;
+            }
+            QCOMPARE(numAllocatedObjects(), numAllocated);
+
+            // slabs that no longer hold any objects are returned
+            QVERIFY(numSlabs() < numSlabsBefore);
+
+            // freed slots are reused before any new slabs are allocated
+            for (int i = 0; i < 1000; i++) {
+                items[i] = new Item(realm, 0, DontSave);
+            }
+            QVERIFY(numSlabs() <= numSlabsBefore);
+
+            for (Item *item : items) {
+                delete item;
+            }
+        }
+
+        void testDespawn() {
+
+            Realm *realm = Realm::instance();
+
+            int numSlabsBefore = numSlabs();
+            qint64 residentSetSizeBefore = residentSetSize();
+
+            const int numItems = 100000;
+
+            QVector<Item *> items;
+            items.reserve(numItems);
+            for (int i = 0; i < numItems; i++) {
+                items.append(new Item(realm, 0, DontSave));
+            }
+
+            int numSlabsSpawned = numSlabs();
+            qint64 residentSetSizeSpawned = residentSetSize();
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            for (Item *item : items) {
+                delete item;
+            }
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+
+            // the resident set only shrinks as far as the system allocator gives memory back,
+            // and the heap data of the items' members was never pooled to begin with
+            qDebug() << "Despawning" << numItems << "items took " << (end - start) << "ms,"
+                     << "slabs went from" << numSlabsSpawned << "to" << numSlabs() << ","
+                     << "the resident set from"
+                     << (residentSetSizeSpawned - residentSetSizeBefore) / (1024 * 1024)
+                     << "to" << (residentSetSize() - residentSetSizeBefore) / (1024 * 1024)
+                     << "MiB above where it started";
+
+            QVERIFY(numSlabsSpawned > numSlabsBefore);
+            QVERIFY(numSlabs() <= numSlabsBefore + 1);
+        }
+
+        void testSyntheticRealm() {
+
+            Realm *realm = Realm::instance();
+
+            qint64 residentSetSizeBefore = residentSetSize();
+
+            const int numRooms = 400;
+            const int numItemsPerRoom = 250;
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            QVector<Room *> rooms;
+            for (int i = 0; i < numRooms; i++) {
+                Room *room = new Room(realm);
+                // far away from the test world and each other, so events stay within the room
+                room->setPosition(Point3D(1000000 + 1000 * i, 1000000, 0));
+                for (int j = 0; j < numItemsPerRoom; j++) {
+                    Item *item = new Item(realm);
+                    item->setName(j % 2 ? "stone" : "stick");
+                    item->setPlural(j % 2 ? "stones" : "sticks");
+                    item->setPosition(Point3D(j % 20 - 10, j / 20 - 6, 0));
+                    room->addItem(item);
+                }
+                rooms.append(room);
+            }
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Creating" << (numRooms * numItemsPerRoom) << "items took "
+                     << (end - start) << "ms, growing the resident set by "
+                     << (residentSetSize() - residentSetSizeBefore) / (1024 * 1024) << "MiB";
+
+            for (const GameObjectAllocator::PoolStatistics &pool :
+                 GameObjectAllocator::statistics()) {
+                qDebug() << "Pool of" << pool.objectSize << "byte objects:" << pool.numSlabs
+                         << "slabs," << pool.numAllocated << "allocated," << pool.numFree << "free";
+            }
+
+            Character *observer = new Character(realm);
+            observer->setName("Observer");
+            observer->setDirection(Vector3D(0, 1, 0));
+
+            const int numLooks = 1000;
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numLooks; i++) {
+                Room *room = rooms[Util::randomInt(0, numRooms)];
+                observer->enter(room);
+                QVERIFY(!room->lookAtBy(observer).isEmpty());
+                observer->leave(room);
+            }
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Looking around" << numLooks << "times took " << (end - start) << "ms ("
+                     << (1000 * numLooks / qMax(end - start, (qint64) 1)) << "looks/s)";
+
+            observer->enter(rooms[0]);
+
+            const int numEvents = 10000;
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numEvents; i++) {
+                VisualEvent *event = new VisualEvent(rooms[Util::randomInt(0, numRooms)], 1.0);
+                event->setDescription("You see a flash.");
+                event->fire();
+            }
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Firing" << numEvents << "visual events took " << (end - start) << "ms ("
+                     << (1000 * numEvents / qMax(end - start, (qint64) 1)) << "events/s)";
+        }
+};
+
+#endif // TEST_REALM_H
@@ -0,0 +1,219 @@
+#ifndef TEST_ROOMDESCRIPTION_H
+#define TEST_ROOMDESCRIPTION_H
+
+#include "testcase.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QTest>
+
+#include "character.h"
+#include "item.h"
+#include "portal.h"
+#include "realm.h"
+#include "room.h"
+#include "vector3d.h"
+
+
+class RoomDescriptionTest : public TestCase {
+
+    Q_OBJECT
+
+    private:
+        Room *createRoom(const QString &name, const Point3D &position) {
+
+            Room *room = new Room(Realm::instance());
+            room->setName(name);
+            room->setPosition(position);
+            return room;
+        }
+
+        Portal *connectRooms(Room *roomA, Room *roomB, const QString &name,
+                             const QString &name2, PortalFlags flags) {
+
+            Portal *portal = new Portal(Realm::instance());
+            portal->setRoom(roomA);
+            portal->setRoom2(roomB);
+            portal->setName(name);
+            portal->setName2(name2);
+            portal->setFlags(flags);
+
+            roomA->addPortal(portal);
+            roomB->addPortal(portal);
+            return portal;
+        }
+
+        Item *createItem(const QString &name, const QString &plural, const Point3D &position,
+                         ItemFlags flags = ItemFlags::NoFlags) {
+
+            Item *item = new Item(Realm::instance());
+            item->setName(name);
+            item->setPlural(plural);
+            item->setPosition(position);
+            item->setFlags(flags);
+            m_square->addItem(item);
+            return item;
+        }
+
+        Character *createCharacter(const QString &name, const QString &plural,
+                                   const QString &gender, Room *room) {
+
+            Character *character = new Character(Realm::instance());
+            character->setName(name);
+            character->setPlural(plural);
+            character->setGender(gender);
+            character->setDirection(Vector3D(0, 1, 0));
+            character->enter(room);
+            return character;
+        }
+
+        QString scriptedDescription() {
+
+            return evaluate(QString("VisualUtil.describeRoom($('room:%1'), $('character:%2'))")
+                            .arg(m_square->id()).arg(m_observer->id())).toString();
+        }
+
+    private slots:
+        virtual void init() {
+
+            // every test gets a scene of its own, far away from the scenes of previous tests
+            static int numScenes = 0;
+            int offset = 10000 + 10000 * numScenes;
+            numScenes++;
+
+            PortalFlags flags = PortalFlags::CanSeeThrough | PortalFlags::CanPassThrough;
+
+            m_square = createRoom("Market Square", Point3D(offset, offset, 0));
+            m_square->setDescription("The square is crowded with people.");
+
+            Room *street = createRoom("Street", Point3D(offset, offset + 50, 0));
+            Room *gate = createRoom("Gate", Point3D(offset, offset + 150, 0));
+            Room *bakery = createRoom("Bakery", Point3D(offset + 30, offset, 0));
+            Room *tent = createRoom("Tent", Point3D(offset - 30, offset, 0));
+            Room *cellar = createRoom("Cellar", Point3D(offset, offset, -20));
+
+            connectRooms(m_square, street, "north", "south", flags);
+            connectRooms(street, gate, "north", "south", flags);
+            connectRooms(m_square, bakery, "door", "out", flags)->setDestination("the bakery");
+            connectRooms(m_square, tent, "tent", "out", flags);
+            connectRooms(m_square, cellar, "trapdoor", "up",
+                         flags | PortalFlags::IsHiddenFromSide1);
+
+            createItem("fountain", "fountains", Point3D(0, 0, 0));
+            createItem("cart", "carts", Point3D(0, 10, 0));
+            createItem("barrel", "barrels", Point3D(-10, -10, 0));
+            createItem("barrel", "barrels", Point3D(-12, -10, 0));
+            createItem("crate", "crates", Point3D(10, 0, 0));
+            createItem("sign", "signs", Point3D(0, -10, 0));
+            createItem("scissors", "scissors", Point3D(10, 10, 0), ItemFlags::ImpliedPlural);
+            createItem("lantern", "lanterns", Point3D(-10, 0, 5), ItemFlags::AttachedToWall);
+            createItem("lantern", "lanterns", Point3D(10, 0, 5), ItemFlags::AttachedToWall);
+            createItem("banner", "banners", Point3D(0, 0, 10), ItemFlags::AttachedToWall);
+            createItem("key", "keys", Point3D(0, 5, 0), ItemFlags::Hidden);
+
+            m_observer = createCharacter("Observer", "observers", "female", m_square);
+            for (int i = 0; i < 20; i++) {
+                createCharacter("villager", "villagers", i % 2 ? "male" : "female", m_square);
+            }
+            createCharacter("Zara", "", "female", m_square);
+
+            Character *walker = createCharacter("goblin", "goblins", "male", street);
+            createCharacter("goblin", "goblins", "male", street);
+            createCharacter("goblin", "goblins", "male", street);
+            Character *leader = createCharacter("Bob", "", "male", street);
+            Character *follower = createCharacter("Carl", "", "male", street);
+            follower->follow(leader);
+
+            Character *guard = createCharacter("guard", "guards", "female", gate);
+            createCharacter("merchant", "merchants", "male", gate);
+
+            walker->setAction("walk", GameObjectPtr());
+            evaluate(QString("$('character:%1').setAction('guard', {"
+                             "    'target': $('room:%2').portals[0]"
+                             "})").arg(guard->id()).arg(gate->id()));
+        }
+
+        virtual void cleanup() {
+
+            m_square = nullptr;
+            m_observer = nullptr;
+        }
+
+        void testGoldenOutput() {
+
+            QList<Vector3D> directions;
+            directions << Vector3D(0, 1, 0) << Vector3D(1, 0, 0) << Vector3D(0, -1, 0)
+                       << Vector3D(-1, 0, 0) << Vector3D(1, 1, 0) << Vector3D(0, 0, 0);
+
+            for (const Vector3D &direction : directions) {
+                m_observer->setDirection(direction);
+                QCOMPARE(m_square->lookAtBy(m_observer), scriptedDescription());
+            }
+
+            m_observer->setDirection(Vector3D(0, 1, 0));
+            QString description = m_square->lookAtBy(m_observer);
+            QVERIFY(description.contains("Ahead of you, there, you see"));
+            QVERIFY(description.contains("In the distance, you see"));
+            QVERIFY(description.contains("goblin walking away from you"));
+            QVERIFY(description.contains("guard guarding the south"));
+            QVERIFY(description.contains("and the door to the bakery."));
+            QVERIFY(!description.contains("key"));
+            QVERIFY(!description.contains("trapdoor"));
+
+            m_square->setFlags(RoomFlags::OmitDynamicPortalsFromDescription |
+                               RoomFlags::OmitDistantCharactersFromDescription);
+            QCOMPARE(m_square->lookAtBy(m_observer), scriptedDescription());
+            QVERIFY(!m_square->lookAtBy(m_observer).contains("you see"));
+            m_square->setFlags(RoomFlags::NoFlags);
+
+            // rooms may override their description through the onlook trigger
+            evaluate(QString("$('room:%1').setTrigger('onlook', function(activator) {"
+                             "    return activator.name === 'Observer' ? 'Just a square.' : false;"
+                             "})").arg(m_square->id()));
+            QCOMPARE(m_square->lookAtBy(m_observer), QString("Just a square."));
+            QCOMPARE(evaluate(QString("$('room:%1').lookAtBy($('character:%2'))")
+                              .arg(m_square->id()).arg(m_observer->id())).toString(),
+                     QString("Just a square."));
+
+            m_observer->setName("Watcher");
+            QCOMPARE(m_square->lookAtBy(m_observer), scriptedDescription());
+            m_observer->setName("Observer");
+
+            m_square->unsetTrigger("onlook");
+            QCOMPARE(m_square->lookAtBy(m_observer), scriptedDescription());
+        }
+
+        void testLooksPerSecond() {
+
+            const int numLooks = 1000;
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numLooks; i++) {
+                m_square->lookAtBy(m_observer);
+            }
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Rendering" << numLooks << "native room descriptions took "
+                     << (end - start) << "ms ("
+                     << (1000 * numLooks / qMax(end - start, (qint64) 1)) << "looks/s)";
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numLooks; i++) {
+                scriptedDescription();
+            }
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Rendering" << numLooks << "scripted room descriptions took "
+                     << (end - start) << "ms ("
+                     << (1000 * numLooks / qMax(end - start, (qint64) 1)) << "looks/s)";
+        }
+
+    private:
+        Room *m_square;
+
+        Character *m_observer;
+};
+
+#endif // TEST_ROOMDESCRIPTION_H
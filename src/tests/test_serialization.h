@@ -3,12 +3,18 @@
 
 #include "testcase.h"
 
+#include <QDateTime>
+#include <QDebug>
 #include <QFile>
 #include <QTest>
+#include <QVector>
 
 #include "characterstats.h"
 #include "diskutil.h"
+#include "item.h"
+#include "player.h"
 #include "realm.h"
+#include "room.h"
 
 
 class SerializationTest : public TestCase {
@@ -107,6 +113,176 @@ class SerializationTest : public TestCase {
                 "}"));
             }
         }
+
+        void testPropertyOperationsPerSecond() {
+
+            Realm *realm = Realm::instance();
+            GameObject *player = realm->getObject(GameObjectType::Player, 4);
+            QVERIFY(player);
+
+            const int numOperations = 10000;
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numOperations; i++) {
+                delete GameObject::createCopy(player);
+            }
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Creating" << numOperations << "copies took " << (end - start) << "ms";
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            QString jsonString;
+            for (int i = 0; i < numOperations; i++) {
+                jsonString = player->toJsonString();
+            }
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Serializing" << numOperations << "objects took " << (end - start) << "ms";
+
+            GameObject *copy = GameObject::createByObjectType(realm, GameObjectType::Player);
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numOperations; i++) {
+                copy->loadJson(jsonString);
+            }
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Loading" << numOperations << "objects took " << (end - start) << "ms";
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            for (int i = 0; i < numOperations; i++) {
+                copy->resolvePointers();
+            }
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Resolving the pointers of" << numOperations << "objects took "
+                     << (end - start) << "ms";
+
+            QCOMPARE(copy->toJsonString(SkipId), player->toJsonString(SkipId));
+            delete copy;
+        }
+
+        void testPrototypeInstances() {
+
+            Realm *realm = Realm::instance();
+
+            Item *sword = new Item(realm);
+            sword->setName("sword");
+            sword->setPlural("swords");
+            sword->setDescription("A sharp sword.");
+            sword->setCost(10.0);
+            evaluate(QString("$('item:%1').setTrigger('onuse', function() { return false; })")
+                     .arg(sword->id()));
+
+            Item *instance = qobject_cast<Item *>(sword->copy());
+            QVERIFY(instance->prototype() == sword);
+            QVERIFY(instance->triggers().contains("onuse"));
+            QVERIFY(instance->hasTrigger("onuse"));
+            QVERIFY(!instance->invokeTrigger("onuse"));
+            QCOMPARE(instance->name(), QString("sword"));
+
+            // copies of instances share the prototype of the original
+            Item *otherInstance = qobject_cast<Item *>(instance->copy());
+            QVERIFY(otherInstance->prototype() == sword);
+
+            instance->setDescription("A blunt sword.");
+            instance->setPlural("");
+
+            // instances are saved in full, so they don't pick up later changes of the prototype
+            // when they are loaded again
+            QString jsonString = instance->toJsonString(SkipId);
+            QVERIFY(jsonString.contains(QString("\"prototype\": \"item:%1\"").arg(sword->id())));
+            QVERIFY(jsonString.contains("\"name\": \"sword\""));
+            QVERIFY(jsonString.contains("\"plural\": null"));
+            QVERIFY(!jsonString.contains("onuse"));
+
+            sword->setName("saber");
+
+            Item *loaded = new Item(realm);
+            loaded->loadJson(jsonString);
+            QVERIFY(loaded->prototype() == sword);
+            QCOMPARE(loaded->name(), QString("sword"));
+            QCOMPARE(loaded->plural(), QString());
+            QCOMPARE(loaded->description(), QString("A blunt sword."));
+            QCOMPARE(loaded->cost(), 10.0);
+            QVERIFY(loaded->hasTrigger("onuse"));
+
+            // properties missing from a file are still inherited from the prototype
+            loaded = new Item(realm);
+            loaded->loadJson(QString("{\n"
+                "  \"prototype\": \"item:%1\",\n"
+                "  \"description\": \"A blunt sword.\"\n"
+            "}").arg(sword->id()));
+            QCOMPARE(loaded->name(), QString("saber"));
+            QCOMPARE(loaded->plural(), QString("swords"));
+            QCOMPARE(loaded->description(), QString("A blunt sword."));
+
+            // when the prototype is deleted, its instances take over its triggers
+            sword->setDeleted();
+            QVERIFY(!instance->prototype());
+            QVERIFY(instance->triggers().contains("onuse"));
+            QVERIFY(!instance->invokeTrigger("onuse"));
+            QVERIFY(!otherInstance->prototype());
+            QVERIFY(otherInstance->hasTrigger("onuse"));
+        }
+
+        void testInstanceTriggers() {
+
+            Realm *realm = Realm::instance();
+            Player *player = (Player *) realm->getPlayer("Arie");
+            Room *room = player->currentRoom().cast<Room *>();
+
+            Item *lamp = new Item(realm);
+            lamp->setName("lamp");
+            lamp->setTrigger("onuse", "function() { return false; }");
+            lamp->setTrigger("onlook", "function() { return false; }");
+
+            Item *torch = qobject_cast<Item *>(lamp->copy());
+            torch->setName("torch");
+            room->addItem(torch);
+
+            Item *candle = new Item(realm);
+            candle->setName("candle");
+            room->addItem(candle);
+
+            // inherited triggers are visible to scripts and can be copied
+            QVERIFY(evaluate(QString("'onlook' in $('item:%1').triggers").arg(torch->id()))
+                    .toBool());
+
+            player->execute("copy-triggers torch candle");
+            QVERIFY(candle->hasTrigger("onuse"));
+            QVERIFY(candle->hasTrigger("onlook"));
+
+            // unsetting an inherited trigger masks it for the instance only
+            player->execute("unset-trigger torch onlook");
+            QVERIFY(!torch->hasTrigger("onlook"));
+            QVERIFY(!torch->triggers().contains("onlook"));
+            QVERIFY(torch->invokeTrigger("onlook"));
+            QVERIFY(torch->hasTrigger("onuse"));
+            QVERIFY(lamp->hasTrigger("onlook"));
+
+            QString jsonString = torch->toJsonString(SkipId);
+            QVERIFY(jsonString.contains("\"onlook\": \"\""));
+            QVERIFY(!jsonString.contains("onuse"));
+
+            Item *loaded = new Item(realm);
+            loaded->loadJson(jsonString);
+            QVERIFY(!loaded->hasTrigger("onlook"));
+            QVERIFY(loaded->hasTrigger("onuse"));
+
+            // copying the prototype's triggers back onto the instance lifts the mask, without
+            // turning them into overrides
+            player->execute("copy-triggers candle torch");
+            QVERIFY(torch->hasTrigger("onlook"));
+            QVERIFY(!torch->toJsonString(SkipId).contains("onlook"));
+
+            room->removeItem(torch);
+            room->removeItem(candle);
+        }
 };
 
 #endif // TEST_SERIALIZATION_H
@@ -7,12 +7,14 @@
 
 #include <QDateTime>
 #include <QDebug>
+#include <QPair>
 #include <QTest>
 
 #include "character.h"
 #include "portal.h"
 #include "realm.h"
 #include "room.h"
+#include "roomgraph.h"
 #include "util.h"
 #include "visualevent.h"
 
@@ -144,7 +146,236 @@ class VisualEventsTest : public TestCase {
             QVERIFY(event->affectedCharacters().contains(m_characters[3]));
         }
 
+        void testRoomGraph() {
+
+            Realm *realm = Realm::instance();
+            RoomGraph *graph = realm->roomGraph();
+            QVERIFY(!graph->isValid());
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            graph->validate();
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Building room graph took " << (end - start) << "ms";
+
+            QVERIFY(graph->isValid());
+            for (const GameObjectPtr &roomPtr : m_rooms) {
+                Room *room = roomPtr.cast<Room *>();
+                QCOMPARE(graph->room(room->graphIndex()), room);
+                QVERIFY(graph->position(room->graphIndex()) == room->position());
+            }
+
+            Room *room = m_rooms[101].cast<Room *>();
+            int index = room->graphIndex();
+            int numEdges = 0;
+            for (const RoomGraph::Edge &edge : graph->edges(index)) {
+                QVERIFY(edge.canSeeThrough());
+                QCOMPARE(edge.multipliers[GameEventType::Visual],
+                         edge.portal->eventMultiplier(GameEventType::Visual));
+                numEdges++;
+            }
+            QCOMPARE(numEdges, 8);
+
+            // flag changes are applied in place
+            Portal *portal = room->portals()[0].cast<Portal *>();
+            portal->setFlags(PortalFlags::NoFlags);
+            QVERIFY(graph->isValid());
+            for (const RoomGraph::Edge &edge : graph->edges(index)) {
+                QCOMPARE(edge.canSeeThrough(), edge.portal != portal);
+            }
+
+            // topology changes invalidate the graph
+            room->removePortal(portal);
+            QVERIFY(!graph->isValid());
+            graph->validate();
+            numEdges = 0;
+            for (const RoomGraph::Edge &edge : graph->edges(room->graphIndex())) {
+                QVERIFY(edge.portal != portal);
+                numEdges++;
+            }
+            QCOMPARE(numEdges, 7);
+
+            portal->setFlags(PortalFlags::CanSeeThrough);
+            room->addPortal(portal);
+
+            room = m_rooms[m_rooms.length() / 2].cast<Room *>();
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            const int numEvents = 10;
+            for (int i = 0; i < numEvents; i++) {
+                VisualEvent *event = new VisualEvent(room, 100.0);
+                event->setDescription("You see a bright white flash.");
+                event->fire();
+                QCOMPARE(event->numVisitedRooms(), 10000);
+            }
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Firing" << numEvents << "events took " << (end - start) << "ms";
+        }
+
+        void testVisibilityTable() {
+
+            Realm *realm = Realm::instance();
+            RoomGraph *graph = realm->roomGraph();
+
+            Room *room = m_rooms[m_rooms.length() / 2].cast<Room *>();
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            VisualEvent *event = new VisualEvent(room, 100.0);
+            event->setDescription("You see a bright white flash.");
+            event->fire();
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "First event fire took " << (end - start) << "ms";
+
+            QCOMPARE(event->numVisitedRooms(), 10000);
+            QCOMPARE(event->affectedCharacters().length(), 4);
+
+            const RoomGraph::VisibilityTable *table =
+                    graph->visibilityTable(GameEventType::Visual, room->graphIndex());
+            QVERIFY(table);
+            QVERIFY(table->isComplete);
+            QVERIFY(table->isExactFor(100.0));
+            QCOMPARE(table->entries.size(), 10000);
+            QCOMPARE(table->entries[0].room, room->graphIndex());
+
+            start = QDateTime::currentMSecsSinceEpoch();
+
+            event = new VisualEvent(room, 100.0);
+            event->setDescription("You see a bright white flash.");
+            event->fire();
+
+            end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Cached event fire took " << (end - start) << "ms";
+
+            QCOMPARE(event->numVisitedRooms(), 10000);
+            QCOMPARE(event->affectedCharacters().length(), 4);
+
+            // weaker events lose rooms to the cutoff, so they propagate without the table
+            QVERIFY(!table->isExactFor(0.2));
+            event = new VisualEvent(room, 0.2);
+            event->fire();
+            QVERIFY(event->numVisitedRooms() < 10000);
+            QVERIFY(graph->visibilityTable(GameEventType::Visual, room->graphIndex()));
+
+            // opening a door changes what can be seen
+            Portal *portal = room->portals()[0].cast<Portal *>();
+            portal->setOpen(true);
+            QVERIFY(!graph->visibilityTable(GameEventType::Visual, room->graphIndex()));
+            portal->setOpen(false);
+        }
+
+        void testVisibilityTableEquivalence() {
+
+            Realm *realm = Realm::instance();
+            RoomGraph *graph = realm->roomGraph();
+
+            // a direct but dim line of sight to the target, and a brighter one through a room
+            // in between, which is only found after the target has already been reached
+            Room *origin = new Room(realm);
+            origin->setPosition(Point3D(100000, 0, 0));
+            Room *between = new Room(realm);
+            between->setPosition(Point3D(100020, 0, 0));
+            Room *target = new Room(realm);
+            target->setPosition(Point3D(100040, 0, 0));
+
+            connectRooms(origin, target);
+            Portal *dimPortal = origin->portals().last().cast<Portal *>();
+            GameEventMultiplierMap multipliers;
+            multipliers[GameEventType::Visual] = 0.5;
+            dimPortal->setEventMultipliers(multipliers);
+
+            connectRooms(origin, between);
+            connectRooms(between, target);
+            Portal *brightPortal = target->portals().last().cast<Portal *>();
+
+            Character *character = new Character(realm);
+            character->setName("Character E");
+            target->addCharacter(character);
+            character->setCurrentRoom(target);
+
+            graph->setVisibilityTablesEnabled(false);
+            Visits strongVisits = recordVisits(origin, 100.0);
+            Visits weakVisits = recordVisits(origin, 0.15);
+            graph->setVisibilityTablesEnabled(true);
+
+            // rooms are reached at the strength of the first path to get there
+            QCOMPARE(strongVisits.length(), 3);
+            QCOMPARE(strongVisits[1].first, target->graphIndex());
+            QCOMPARE(strongVisits[1].second,
+                     100.0 * dimPortal->eventMultiplier(GameEventType::Visual));
+
+            // the dim path is cut off for weak events, which reach the target the long way
+            QCOMPARE(weakVisits.length(), 3);
+            QCOMPARE(weakVisits[2].first, target->graphIndex());
+
+            QVERIFY(!graph->visibilityTable(GameEventType::Visual, origin->graphIndex()));
+            QVERIFY(isSameVisits(recordVisits(origin, 100.0), strongVisits));
+            const RoomGraph::VisibilityTable *table =
+                    graph->visibilityTable(GameEventType::Visual, origin->graphIndex());
+            QVERIFY(table);
+            QVERIFY(table->isExactFor(100.0));
+            QVERIFY(isSameVisits(recordVisits(origin, 100.0), strongVisits));
+            QVERIFY(isSameVisits(recordVisits(origin, 0.15), weakVisits));
+
+            // a table built for a weak event doesn't know the paths that were cut off
+            brightPortal->setOpen(true);
+            brightPortal->setOpen(false);
+            QVERIFY(!graph->visibilityTable(GameEventType::Visual, origin->graphIndex()));
+            QVERIFY(isSameVisits(recordVisits(origin, 0.15), weakVisits));
+            table = graph->visibilityTable(GameEventType::Visual, origin->graphIndex());
+            QVERIFY(table);
+            QVERIFY(table->isExactFor(0.15));
+            QVERIFY(!table->isExactFor(100.0));
+            QVERIFY(isSameVisits(recordVisits(origin, 100.0), strongVisits));
+        }
+
     private:
+        typedef QList<QPair<int, double> > Visits;
+
+        class RecordingVisualEvent : public VisualEvent {
+
+            public:
+                RecordingVisualEvent(Room *origin, double strength) :
+                    VisualEvent(origin, strength) {
+                }
+
+                Visits visits;
+
+            protected:
+                virtual void visitRoom(Room *room, double strength) {
+
+                    visits.append(qMakePair(room->graphIndex(), strength));
+                    VisualEvent::visitRoom(room, strength);
+                }
+        };
+
+        // strengths may differ in the last bits, as the table multiplies them in another order
+        bool isSameVisits(const Visits &visits, const Visits &expectedVisits) {
+
+            if (visits.length() != expectedVisits.length()) {
+                return false;
+            }
+            for (int i = 0; i < visits.length(); i++) {
+                if (visits[i].first != expectedVisits[i].first ||
+                    !qFuzzyCompare(visits[i].second, expectedVisits[i].second)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        Visits recordVisits(Room *origin, double strength) {
+
+            RecordingVisualEvent *event = new RecordingVisualEvent(origin, strength);
+            event->setDescription("You see a bright white flash.");
+            event->fire();
+            return event->visits;
+        }
+
         GameObjectPtrList m_rooms;
         GameObjectPtrList m_characters;
 };
@@ -0,0 +1,133 @@
+#ifndef TEST_WEBSOCKETCOMPRESSION_H
+#define TEST_WEBSOCKETCOMPRESSION_H
+
+#include "testcase.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QStringList>
+#include <QTest>
+
+#include <QWsPerMessageDeflate.h>
+
+#include "conversionutil.h"
+#include "portal.h"
+#include "realm.h"
+#include "room.h"
+#include "util.h"
+
+
+class WebSocketCompressionTest : public TestCase {
+
+    Q_OBJECT
+
+    private slots:
+        virtual void init() {
+
+            Realm *realm = Realm::instance();
+
+            const int numRooms = 1000;
+            for (int i = 0; i < numRooms; i++) {
+                Room *room = new Room(realm);
+                room->setName(QString("Corridor %1").arg(i));
+                room->setDescription("A long and winding corridor, lit by torches on both sides.");
+                room->setPosition(Point3D(20 * i, 0, 0));
+
+                if (i > 0) {
+                    Room *previousRoom = m_rooms.last().cast<Room *>();
+
+                    Portal *portal = new Portal(realm);
+                    portal->setRoom(previousRoom);
+                    portal->setRoom2(room);
+                    portal->setName("east");
+                    portal->setName2("west");
+                    portal->setFlags(PortalFlags::CanPassThrough);
+
+                    previousRoom->addPortal(portal);
+                    room->addPortal(portal);
+                }
+                m_rooms.append(room);
+            }
+        }
+
+        virtual void cleanup() {
+
+            m_rooms.clear();
+        }
+
+        void testObjectsListRoundTrip() {
+
+            QStringList objects;
+            for (const GameObjectPtr &room : m_rooms) {
+                objects.append(room->toJsonString());
+            }
+            QString reply = QString("{ "
+                                    "\"requestId\": \"objects-list\", "
+                                    "\"errorCode\": 0, "
+                                    "\"errorMessage\": \"\", "
+                                    "\"data\": %1 "
+                                    "}").arg(ConversionUtil::toJsonString(objects));
+            QByteArray message = reply.toUtf8();
+
+            QWsPerMessageDeflate server;
+            QWsPerMessageDeflate client;
+            QVERIFY(server.isValid());
+            QVERIFY(client.isValid());
+
+            QByteArray payload;
+            QByteArray result;
+
+            qint64 start = QDateTime::currentMSecsSinceEpoch();
+
+            QVERIFY(server.compress(message, payload));
+            QVERIFY(client.decompress(payload, result));
+
+            qint64 end = QDateTime::currentMSecsSinceEpoch();
+            qDebug() << "Compressing" << message.size() << "bytes to" << payload.size()
+                     << "bytes took " << (end - start) << "ms";
+
+            QCOMPARE(result, message);
+            QVERIFY(payload.size() < message.size() / 4);
+
+            // with context takeover, a repeated message should compress even better
+            QByteArray secondPayload;
+            QVERIFY(server.compress(message, secondPayload));
+            QVERIFY(client.decompress(secondPayload, result));
+            QCOMPARE(result, message);
+            QVERIFY(secondPayload.size() <= payload.size());
+        }
+
+        void testNegotiation() {
+
+            QString response;
+            QWsPerMessageDeflate *perMessageDeflate = QWsPerMessageDeflate::negotiate(
+                "x-webkit-deflate-frame, permessage-deflate; client_max_window_bits", 15, true,
+                response);
+            QVERIFY(perMessageDeflate);
+            QCOMPARE(response, QString("permessage-deflate"));
+            delete perMessageDeflate;
+
+            perMessageDeflate = QWsPerMessageDeflate::negotiate(
+                "permessage-deflate; server_max_window_bits=10", 15, false, response);
+            QVERIFY(perMessageDeflate);
+            QCOMPARE(response, QString("permessage-deflate; server_no_context_takeover; "
+                                       "server_max_window_bits=10"));
+            delete perMessageDeflate;
+
+            perMessageDeflate = QWsPerMessageDeflate::negotiate(
+                "permessage-deflate; server_max_window_bits=8", 15, true, response);
+            QVERIFY(!perMessageDeflate);
+        }
+
+        void testSmallMessagesAreSentUncompressed() {
+
+            QWsPerMessageDeflate perMessageDeflate;
+            QByteArray payload;
+            QVERIFY(!perMessageDeflate.compress("{ \"requestId\": \"1\" }", payload));
+        }
+
+    private:
+        GameObjectPtrList m_rooms;
+};
+
+#endif // TEST_WEBSOCKETCOMPRESSION_H
@@ -1,6 +1,7 @@
 #include "testcase.h"
 
 #include <QDir>
+#include <QFile>
 #include <QTest>
 
 #include "diskutil.h"
@@ -17,6 +18,21 @@ QScriptValue TestCase::evaluate(const QString &statement) {
     return ScriptEngine::instance()->evaluate(statement);
 }
 
+qint64 TestCase::residentSetSize() {
+
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+
+    for (const QByteArray &line : file.readAll().split('\n')) {
+        if (line.startsWith("VmRSS:")) {
+            return line.mid(6).trimmed().split(' ')[0].toLongLong() * 1024;
+        }
+    }
+    return 0;
+}
+
 void TestCase::initTestCase() {
 
     if (qgetenv("PT_DATA_DIR").isEmpty()) {
@@ -14,6 +14,9 @@ class TestCase : public QObject {
     protected:
         QScriptValue evaluate(const QString &statement);
 
+        // returns the resident set size of the test process in bytes, or 0 if it is unknown
+        qint64 residentSetSize();
+
     private slots:
         virtual void initTestCase();
 
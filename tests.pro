@@ -13,14 +13,26 @@ SOURCES += \
 
 HEADERS += \
     src/tests/testcase.h \
+    src/tests/test_broadcast.h \
+    src/tests/test_commandinterpreter.h \
     src/tests/test_container.h \
     src/tests/test_crashes.h \
+    src/tests/test_datamap.h \
+    src/tests/test_eventpruning.h \
     src/tests/test_floodevent.h \
+    src/tests/test_gameobjectptr.h \
     src/tests/test_help.h \
+    src/tests/test_httpserver.h \
+    src/tests/test_inputlimits.h \
+    src/tests/test_internedstring.h \
     src/tests/test_movement.h \
+    src/tests/test_nameindex.h \
     src/tests/test_openandclose.h \
+    src/tests/test_realm.h \
+    src/tests/test_roomdescription.h \
     src/tests/test_serialization.h \
     src/tests/test_visualevents.h \
+    src/tests/test_websocketcompression.h \
 
 INCLUDEPATH += \
     src/tests \